@@ -71,6 +71,9 @@ void initializeSqlite() {
 }
 
 static JavaVM *jvm;
+// NOTE: Classes must be looked up ahead of time, because FindClass can't find app classes on native threads
+static jclass jsiInstallerClass;
+static jmethodID scheduleJsThreadCallbacksMethod;
 
 void configureJNI(JNIEnv *env) {
     assert(env);
@@ -80,6 +83,18 @@ void configureJNI(JNIEnv *env) {
     }
     assert(jvm);
 
+    jclass clazz = env->FindClass("com/nozbe/watermelondb/jsi/JSIInstaller");
+    if (clazz == NULL) {
+        consoleError("Could not initialize WatermelonDB JSI - missing JSIInstaller class");
+        std::abort();
+    }
+    jsiInstallerClass = static_cast<jclass>(env->NewGlobalRef(clazz));
+    scheduleJsThreadCallbacksMethod = env->GetStaticMethodID(jsiInstallerClass, "_scheduleJSThreadCallbacks", "()V");
+    if (scheduleJsThreadCallbacksMethod == NULL) {
+        consoleError("Could not initialize WatermelonDB JSI - missing Java _scheduleJSThreadCallbacks method");
+        std::abort();
+    }
+
     // // find magic constant needed for verbose logs
     // jclass logClass = env->FindClass("android/util/Log");
     // if (logClass == NULL) {
@@ -200,6 +215,58 @@ void deleteSyncJson(int id) {
     }
 }
 
+std::vector<std::function<void()>> jsThreadCallbacks;
+std::mutex jsThreadCallbacksMutex;
+
+bool canRunOnJsThread() {
+    return jvm != nullptr && jsiInstallerClass != nullptr;
+}
+
+bool runOnJsThread(std::function<void()> function) {
+    {
+        const std::lock_guard<std::mutex> lock(jsThreadCallbacksMutex);
+        jsThreadCallbacks.push_back(std::move(function));
+    }
+
+    // NOTE: This is usually called from a native (non-Java) thread, so we must attach it to JVM, and
+    // detach afterwards (or ART will abort when the thread exits)
+    JNIEnv *env;
+    assert(jvm);
+    bool needsDetach = false;
+    if (jvm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_EDETACHED) {
+        if (jvm->AttachCurrentThread(&env, NULL) != JNI_OK) {
+            consoleError("Unable to run on JS thread - JVM thread attach failed");
+            return false;
+        }
+        needsDetach = true;
+    }
+    assert(env);
+
+    env->CallStaticVoidMethod(jsiInstallerClass, scheduleJsThreadCallbacksMethod);
+    bool isScheduled = true;
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        consoleError("Unable to run on JS thread - exception occured while scheduling");
+        isScheduled = false;
+    }
+
+    if (needsDetach) {
+        jvm->DetachCurrentThread();
+    }
+    return isScheduled;
+}
+
+void runJsThreadCallbacks() {
+    std::vector<std::function<void()>> callbacks;
+    {
+        const std::lock_guard<std::mutex> lock(jsThreadCallbacksMutex);
+        callbacks.swap(jsThreadCallbacks);
+    }
+    for (auto &callback : callbacks) {
+        callback();
+    }
+}
+
 std::vector<std::function<void()>> destroyListeners;
 
 void destroy() {
@@ -207,6 +274,10 @@ void destroy() {
         listener();
     }
     destroyListeners.clear();
+
+    // NOTE: Callbacks that haven't run yet would otherwise run against the next runtime after reload
+    const std::lock_guard<std::mutex> lock(jsThreadCallbacksMutex);
+    jsThreadCallbacks.clear();
 }
 
 void onDestroy(std::function<void()> callback) {
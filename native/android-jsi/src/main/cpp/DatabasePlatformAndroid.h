@@ -7,6 +7,7 @@ namespace platform {
 
 void configureJNI(JNIEnv *env);
 void provideJson(int id, jbyteArray array);
+void runJsThreadCallbacks();
 void destroy();
 
 } // namespace platform
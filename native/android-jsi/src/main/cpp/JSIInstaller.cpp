@@ -18,6 +18,14 @@ extern "C" JNIEXPORT void JNICALL Java_com_nozbe_watermelondb_jsi_JSIInstaller_p
     watermelondb::platform::provideJson(id, array);
 }
 
+extern "C" JNIEXPORT void JNICALL Java_com_nozbe_watermelondb_jsi_JSIInstaller_cancelSyncLoads(JNIEnv *env, jclass clazz) {
+    watermelondb::SyncLoadProgress::cancelAll();
+}
+
 extern "C" JNIEXPORT void JNICALL Java_com_nozbe_watermelondb_jsi_JSIInstaller_destroy(JNIEnv *env, jclass clazz) {
     watermelondb::platform::destroy();
 }
+
+extern "C" JNIEXPORT void JNICALL Java_com_nozbe_watermelondb_jsi_JSIInstaller_runJSThreadCallbacks(JNIEnv *env, jclass clazz) {
+    watermelondb::platform::runJsThreadCallbacks();
+}
@@ -1,6 +1,9 @@
 package com.nozbe.watermelondb.jsi;
 
 import android.content.Context;
+
+import com.facebook.react.bridge.ReactContext;
+
 class JSIInstaller {
     static void install(Context context, long javaScriptContextHolder) {
         JSIInstaller.context = context;
@@ -10,6 +13,7 @@ class JSIInstaller {
         // release binaries. We could use @Keep or configure Proguard to keep it but that would be
         // error prone for lib users
         _resolveDatabasePath("");
+        _scheduleJSThreadCallbacks();
     }
 
     // Helper method called from C++
@@ -18,12 +22,21 @@ class JSIInstaller {
         return context.getDatabasePath(dbName + ".db").getPath().replace("/databases", "");
     }
 
+    // Helper method called from C++ (from any thread)
+    static void _scheduleJSThreadCallbacks() {
+        ((ReactContext) context).runOnJSQueueThread(JSIInstaller::runJSThreadCallbacks);
+    }
+
     private native void installBinding(long javaScriptContextHolder);
 
     static native void provideSyncJson(int id, byte[] json);
 
+    static native void cancelSyncLoads();
+
     static native void destroy();
 
+    static native void runJSThreadCallbacks();
+
     private static Context context;
 
     static {
@@ -12,6 +12,11 @@ public class WatermelonJSI {
         JSIInstaller.provideSyncJson(id, json);
     }
 
+    // Cancels turbo sync loads in progress (e.g. when user logs out). Can be called from any thread
+    public static void cancelSyncLoads() {
+        JSIInstaller.cancelSyncLoads();
+    }
+
     public static void onCatalystInstanceDestroy() {
         JSIInstaller.destroy();
     }
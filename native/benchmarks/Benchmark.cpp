@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+#include "DatabasePlatform.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace watermelondb {
+namespace benchmark {
+
+static std::atomic<uint64_t> allocations(0);
+
+uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void report(const std::string &name, const Measurement &measurement, size_t count, const char *unit) {
+    printf("%-48s %10.0f %s/s %9.1f ns/%s %7.2f allocs/%s\n",
+           name.c_str(),
+           count / measurement.seconds,
+           unit,
+           measurement.seconds * 1e9 / count,
+           unit,
+           (double) measurement.allocations / count,
+           unit);
+}
+
+void execute(sqlite3 *db, const std::string &sql) {
+    char *errmsg = nullptr;
+    sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errmsg);
+    if (errmsg) {
+        fprintf(stderr, "Failed to execute %s - %s\n", sql.c_str(), errmsg);
+        abort();
+    }
+}
+
+std::string randomId() {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    static std::mt19937 random(42);
+    std::string id(16, ' ');
+    for (auto &c : id) {
+        c = alphabet[random() % (sizeof(alphabet) - 1)];
+    }
+    return id;
+}
+
+} // namespace benchmark
+
+// Platform functions used by the code benchmarked
+// NOTE: Benchmarks run outside of React Native, so there's no JS thread to run on
+namespace platform {
+
+// NOTE: Not printed, so that benchmark results aren't interleaved with "Opened database" etc.
+void consoleLog(std::string message) {
+}
+
+void consoleError(std::string message) {
+    fprintf(stderr, "%s\n", message.c_str());
+}
+
+void initializeSqlite() {
+}
+
+std::string resolveDatabasePath(std::string path) {
+    return path;
+}
+
+bool canRunOnJsThread() {
+    return false;
+}
+
+bool runOnJsThread(std::function<void()> function) {
+    return false;
+}
+
+} // namespace platform
+} // namespace watermelondb
+
+void *operator new(size_t size) {
+    watermelondb::benchmark::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    free(pointer);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <sqlite3.h>
+
+namespace watermelondb {
+namespace benchmark {
+
+// Number of C++ heap allocations (operator new calls) made by the process so far
+// NOTE: sqlite's own allocations are not counted
+uint64_t allocationCount();
+
+struct Measurement {
+    double seconds;
+    uint64_t allocations;
+};
+
+// Runs `block` `runs` times, and returns the fastest run
+template <typename Block>
+Measurement measure(int runs, Block block) {
+    Measurement best = { 0, 0 };
+    for (int i = 0; i < runs; i++) {
+        uint64_t allocationsBefore = allocationCount();
+        auto start = std::chrono::steady_clock::now();
+        block();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < best.seconds) {
+            best = { elapsed.count(), allocationCount() - allocationsBefore };
+        }
+    }
+    return best;
+}
+
+// Prints `measurement` of work done on `count` items (rows, queries...)
+void report(const std::string &name, const Measurement &measurement, size_t count, const char *unit = "row");
+
+// Executes `sql`, and aborts on error
+void execute(sqlite3 *db, const std::string &sql);
+
+// Returns a random record ID, in the same format as ones made by WatermelonDB
+std::string randomId();
+
+} // namespace benchmark
+} // namespace watermelondb
@@ -0,0 +1,108 @@
+#include "Benchmark.h"
+#include "BatchExecutor.h"
+#include "Sqlite.h"
+
+#include <cstdlib>
+#include <unistd.h>
+
+// Creating records with batchJSON (BatchExecutor::executeJSON) - with created rows packed into
+// multi-row INSERTs vs inserted one by one. The one-by-one path is the same code, with sqlite's limit
+// of arguments per statement lowered to the number of arguments of a single row
+// Usage: MultiRowInsertBenchmark [rowCount...]
+
+using namespace watermelondb;
+using namespace watermelondb::benchmark;
+
+static const char *databasePath = "MultiRowInsert.db";
+static const int columnCount = 12;
+
+static std::string insertSql() {
+    std::string sql = "insert into \"tasks\" (\"id\", \"_status\", \"_changed\"";
+    for (int i = 3; i < columnCount; i++) {
+        sql += ", \"column" + std::to_string(i) + "\"";
+    }
+    sql += ") values (?";
+    for (int i = 1; i < columnCount; i++) {
+        sql += ", ?";
+    }
+    return sql + ")";
+}
+
+static std::string createBatchJson(size_t rowCount) {
+    std::string sql = insertSql();
+    std::string escapedSql;
+    for (char c : sql) {
+        escapedSql += c == '"' ? "\\\"" : std::string(1, c);
+    }
+
+    std::string json = "[[1,\"tasks\",\"" + escapedSql + "\",[";
+    for (size_t row = 0; row < rowCount; row++) {
+        json += (row ? ",[\"" : "[\"") + randomId() + "\",\"created\",\"\"";
+        for (int i = 3; i < columnCount; i++) {
+            json += i % 3 == 0 ? ",\"text value\"" : i % 3 == 1 ? ",12345.5" : ",true";
+        }
+        json += "]";
+    }
+    return json + "]]]";
+}
+
+int main(int argc, char **argv) {
+    std::vector<size_t> rowCounts;
+    for (int i = 1; i < argc; i++) {
+        rowCounts.push_back(atoi(argv[i]));
+    }
+    if (rowCounts.empty()) {
+        rowCounts = { 50, 1000, 100000 };
+    }
+
+    unlink(databasePath);
+    unlink((std::string(databasePath) + "-wal").c_str());
+    unlink((std::string(databasePath) + "-shm").c_str());
+
+    SqliteDb db(databasePath);
+    execute(db.sqlite, "pragma journal_mode = wal");
+    std::string createTable = "create table tasks (id text primary key, _status text, _changed text";
+    for (int i = 3; i < columnCount; i++) {
+        createTable += ", column" + std::to_string(i);
+    }
+    execute(db.sqlite, createTable + ")");
+
+    StatementCache statementCache;
+    PartialUpdateSql partialUpdateSql;
+    MultiRowInsertSql multiRowInsertSql;
+    ChangeFeed changeFeed;
+    changeFeed.attach(db.sqlite);
+    int maxArgsCount = sqlite3_limit(db.sqlite, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+
+    const int runs = 5;
+    for (size_t rowCount : rowCounts) {
+        printf("%zu rows, %d columns\n", rowCount, columnCount);
+        for (bool isPacked : { false, true }) {
+            sqlite3_limit(db.sqlite, SQLITE_LIMIT_VARIABLE_NUMBER, isPacked ? maxArgsCount : columnCount);
+
+            std::string batch = createBatchJson(rowCount);
+            auto insert = [&]() {
+                execute(db.sqlite, "begin");
+                changeFeed.begin();
+                BatchExecutor(db.sqlite, statementCache, partialUpdateSql, multiRowInsertSql, changeFeed)
+                    .executeJSON(batch);
+                execute(db.sqlite, "commit");
+                changeFeed.finish();
+            };
+
+            // NOTE: Table is emptied before each run, so that every run inserts into the same table.
+            // The first run only warms up statements
+            Measurement best = { 0, 0 };
+            for (int run = 0; run <= runs; run++) {
+                execute(db.sqlite, "delete from tasks");
+                auto measurement = measure(1, insert);
+                if (run == 1 || (run > 1 && measurement.seconds < best.seconds)) {
+                    best = measurement;
+                }
+            }
+            report(isPacked ? "multi-row insert" : "row by row", best, rowCount);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+#include "Benchmark.h"
+#include "AsyncReader.h"
+#include "AsyncWriter.h"
+#include "BatchExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+// Mixed read/write workload: queries run while another thread keeps writing large batches, on a single
+// connection guarded by a mutex (like Database without the reader pool) vs the AsyncReader pool of
+// read-only connections, with writes on AsyncWriter's connection. Reports latency of queries made
+// one after another (like awaited queries), throughput of queries made all at once, and how many rows
+// were written meanwhile
+// Usage: ReaderPoolBenchmark [recordCount] [queryCount] [writeBatchSize]
+
+using namespace watermelondb;
+using namespace watermelondb::benchmark;
+
+static const char *databasePath = "ReaderPool.db";
+static const std::string querySql = "select * from tasks where num % 1000 = ?";
+
+static std::string updateBatchJson(const std::vector<std::string> &ids, size_t from, size_t count, int value) {
+    std::string json = "[[0,\"tasks\",\"update \\\"tasks\\\" set \\\"num\\\" = ? where \\\"id\\\" = ?\",[";
+    for (size_t i = 0; i < count; i++) {
+        json += (i ? ",[" : "[") + std::to_string(value + i) + ",\"" + ids[(from + i) % ids.size()] + "\"]";
+    }
+    return json + "]]]";
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void reportLatencies(const std::string &name, std::vector<double> &latencies, double seconds, size_t rowsWritten) {
+    std::sort(latencies.begin(), latencies.end());
+    printf("%-36s p50 %7.2f ms  p99 %7.2f ms  max %7.2f ms  %6.0f queries/s  %8.0f rows written/s\n",
+           name.c_str(),
+           latencies[latencies.size() / 2],
+           latencies[latencies.size() * 99 / 100],
+           latencies.back(),
+           latencies.size() / seconds,
+           rowsWritten / seconds);
+}
+
+// Keeps calling `writeBatch` on a separate thread until destroyed, and counts rows written
+class BackgroundWriter {
+public:
+    BackgroundWriter(size_t batchSize, std::function<void(int batchNumber)> writeBatch)
+        : rowsWritten(0), isStopping_(false) {
+        thread_ = std::thread([this, batchSize, writeBatch]() {
+            for (int i = 0; !isStopping_; i++) {
+                writeBatch(i);
+                rowsWritten += batchSize;
+            }
+        });
+    }
+    ~BackgroundWriter() {
+        isStopping_ = true;
+        thread_.join();
+    }
+
+    std::atomic<size_t> rowsWritten;
+
+private:
+    std::atomic<bool> isStopping_;
+    std::thread thread_;
+};
+
+// Copies query results, like AsyncReader::Connection::query does
+static SqliteRows readRows(sqlite3_stmt *statement) {
+    SqliteRows result;
+    while (sqlite3_step(statement) == SQLITE_ROW) {
+        SqliteRow row;
+        for (int i = 0, count = sqlite3_column_count(statement); i < count; i++) {
+            auto type = sqlite3_column_type(statement, i);
+            if (type == SQLITE_TEXT) {
+                row.push_back({ SqliteValue::Type::text, 0, (const char *) sqlite3_column_text(statement, i) });
+            } else if (type == SQLITE_NULL) {
+                row.push_back({ SqliteValue::Type::null, 0, "" });
+            } else {
+                row.push_back({ SqliteValue::Type::number, sqlite3_column_double(statement, i), "" });
+            }
+        }
+        result.rows.push_back(std::move(row));
+    }
+    sqlite3_reset(statement);
+    return result;
+}
+
+static void benchmarkSingleConnection(const std::vector<std::string> &ids, size_t queryCount, size_t batchSize) {
+    SqliteDb db(databasePath);
+    std::mutex mutex;
+    StatementCache statementCache;
+    PartialUpdateSql partialUpdateSql;
+    MultiRowInsertSql multiRowInsertSql;
+    ChangeFeed changeFeed;
+    changeFeed.attach(db.sqlite);
+
+    sqlite3_stmt *query;
+    sqlite3_prepare_v2(db.sqlite, querySql.c_str(), -1, &query, nullptr);
+
+    std::vector<double> latencies;
+    auto start = std::chrono::steady_clock::now();
+    size_t rowsWritten;
+    {
+        BackgroundWriter writer(batchSize, [&](int batchNumber) {
+            auto json = updateBatchJson(ids, batchNumber * batchSize, batchSize, batchNumber);
+            const std::lock_guard<std::mutex> lock(mutex);
+            execute(db.sqlite, "begin");
+            changeFeed.begin();
+            BatchExecutor(db.sqlite, statementCache, partialUpdateSql, multiRowInsertSql, changeFeed).executeJSON(json);
+            execute(db.sqlite, "commit");
+            changeFeed.finish();
+        });
+        for (size_t i = 0; i < queryCount; i++) {
+            auto queryStart = std::chrono::steady_clock::now();
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                sqlite3_bind_int(query, 1, (int) (i % 1000));
+                readRows(query);
+            }
+            latencies.push_back(millisecondsSince(queryStart));
+        }
+        rowsWritten = writer.rowsWritten;
+    }
+    reportLatencies("single connection", latencies, millisecondsSince(start) / 1000, rowsWritten);
+    sqlite3_finalize(query);
+}
+
+static void benchmarkReaderPool(const std::vector<std::string> &ids, size_t queryCount, size_t batchSize, int connectionCount) {
+    AsyncWriter asyncWriter(databasePath);
+    AsyncReader reader(databasePath, connectionCount);
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<double> latencies;
+    size_t rowsWritten;
+
+    auto runQuery = [&](size_t i, std::chrono::steady_clock::time_point queryStart) {
+        reader.run([&, i, queryStart](AsyncReader::Connection &connection) {
+            connection.query(querySql, { { SqliteValue::Type::number, (double) (i % 1000), "" } });
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                latencies.push_back(millisecondsSince(queryStart));
+            }
+            condition.notify_all();
+        });
+    };
+    auto waitForQueries = [&](size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() {
+            return latencies.size() >= count;
+        });
+    };
+    auto writeBatch = [&](int batchNumber) {
+        asyncWriter.enqueue(updateBatchJson(ids, batchNumber * batchSize, batchSize, batchNumber), [](AsyncWriter::BatchResult) {});
+        asyncWriter.flush();
+    };
+
+    // one after another
+    auto start = std::chrono::steady_clock::now();
+    {
+        BackgroundWriter writer(batchSize, writeBatch);
+        for (size_t i = 0; i < queryCount; i++) {
+            runQuery(i, std::chrono::steady_clock::now());
+            waitForQueries(i + 1);
+        }
+        rowsWritten = writer.rowsWritten;
+    }
+    reportLatencies("reader pool x" + std::to_string(connectionCount) + " - sequential", latencies, millisecondsSince(start) / 1000, rowsWritten);
+
+    // all at once
+    latencies.clear();
+    start = std::chrono::steady_clock::now();
+    {
+        BackgroundWriter writer(batchSize, writeBatch);
+        for (size_t i = 0; i < queryCount; i++) {
+            runQuery(i, start);
+        }
+        waitForQueries(queryCount);
+        rowsWritten = writer.rowsWritten;
+    }
+    reportLatencies("reader pool x" + std::to_string(connectionCount) + " - all at once", latencies, millisecondsSince(start) / 1000, rowsWritten);
+
+    reader.destroy();
+    asyncWriter.destroy();
+}
+
+int main(int argc, char **argv) {
+    size_t recordCount = argc > 1 ? atoi(argv[1]) : 100000;
+    size_t queryCount = argc > 2 ? atoi(argv[2]) : 200;
+    size_t batchSize = argc > 3 ? atoi(argv[3]) : 5000;
+
+    unlink(databasePath);
+    unlink((std::string(databasePath) + "-wal").c_str());
+    unlink((std::string(databasePath) + "-shm").c_str());
+
+    std::vector<std::string> ids;
+    {
+        SqliteDb db(databasePath);
+        execute(db.sqlite, "pragma journal_mode = wal");
+        execute(db.sqlite, "create table tasks (id text primary key, name text, num integer, is_done integer)");
+        execute(db.sqlite, "begin");
+        sqlite3_stmt *insert;
+        sqlite3_prepare_v2(db.sqlite, "insert into tasks values (?, ?, ?, 0)", -1, &insert, nullptr);
+        for (size_t i = 0; i < recordCount; i++) {
+            ids.push_back(randomId());
+            std::string name = "Task number " + std::to_string(i);
+            sqlite3_bind_text(insert, 1, ids.back().c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(insert, 2, name.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int(insert, 3, (int) i);
+            sqlite3_step(insert);
+            sqlite3_reset(insert);
+        }
+        sqlite3_finalize(insert);
+        execute(db.sqlite, "commit");
+    }
+
+    printf("%zu records, %zu queries, batches of %zu updates\n", recordCount, queryCount, batchSize);
+    benchmarkSingleConnection(ids, queryCount, batchSize);
+    for (int connectionCount : { 1, 2, 4 }) {
+        benchmarkReaderPool(ids, queryCount, batchSize, connectionCount);
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "Benchmark.h"
+#include "RecordCache.h"
+
+#include <cstdlib>
+#include <unordered_set>
+
+// Cost of checking fetched rows against the record cache, as done by Database::query - with the
+// RecordCache vs a single set of `table$id` keys, like cachedRecords_ used before it.
+// First fetch of a query misses (and inserts) every id, and later fetches only hit the cache
+// Usage: RecordCacheBenchmark [rowCount]
+
+using namespace watermelondb;
+using namespace watermelondb::benchmark;
+
+// Record cache as it was before RecordCache
+class KeyedRecordCache {
+public:
+    bool isCached(std::string cacheKey) {
+        return cachedRecords_.find(cacheKey) != cachedRecords_.end();
+    }
+    void markAsCached(std::string cacheKey) {
+        cachedRecords_.insert(cacheKey);
+    }
+    void clear() {
+        cachedRecords_ = {};
+    }
+
+private:
+    std::unordered_set<std::string> cachedRecords_;
+};
+
+static std::string cacheKey(std::string tableName, std::string recordId) {
+    return tableName + "$" + recordId;
+}
+
+int main(int argc, char **argv) {
+    size_t rowCount = argc > 1 ? atoi(argv[1]) : 50000;
+    const std::string tableName = "tasks";
+
+    sqlite3 *db;
+    sqlite3_open(":memory:", &db);
+    execute(db, "create table tasks (id text primary key, name text)");
+    execute(db, "begin");
+    sqlite3_stmt *insert;
+    sqlite3_prepare_v2(db, "insert into tasks (id, name) values (?, 'name')", -1, &insert, nullptr);
+    for (size_t i = 0; i < rowCount; i++) {
+        auto id = randomId();
+        sqlite3_bind_text(insert, 1, id.c_str(), (int) id.size(), SQLITE_TRANSIENT);
+        sqlite3_step(insert);
+        sqlite3_reset(insert);
+    }
+    sqlite3_finalize(insert);
+    execute(db, "commit");
+
+    sqlite3_stmt *query;
+    sqlite3_prepare_v2(db, "select id from tasks", -1, &query, nullptr);
+
+    // NOTE: As in Database::query before RecordCache - the table name was converted from JSI, and the
+    // key built, for every row (twice on a miss)
+    KeyedRecordCache keyedCache;
+    auto fetchKeyed = [&]() {
+        while (sqlite3_step(query) == SQLITE_ROW) {
+            std::string id = (const char *) sqlite3_column_text(query, 0);
+            if (!keyedCache.isCached(cacheKey(std::string(tableName), id))) {
+                keyedCache.markAsCached(cacheKey(std::string(tableName), id));
+            }
+        }
+        sqlite3_reset(query);
+    };
+
+    RecordCache recordCache;
+    auto fetch = [&]() {
+        auto &cachedIds = recordCache.table(tableName);
+        while (sqlite3_step(query) == SQLITE_ROW) {
+            std::string_view id((const char *) sqlite3_column_text(query, 0), sqlite3_column_bytes(query, 0));
+            if (!cachedIds.contains(id)) {
+                cachedIds.insert(id);
+            }
+        }
+        sqlite3_reset(query);
+    };
+
+    auto fetchWithoutCache = [&]() {
+        while (sqlite3_step(query) == SQLITE_ROW) {
+        }
+        sqlite3_reset(query);
+    };
+
+    const int runs = 5;
+    printf("%zu rows\n", rowCount);
+    report("no cache (sqlite3_step only)", measure(runs, fetchWithoutCache), rowCount);
+    report("table$id set - first fetch", measure(runs, [&]() {
+        keyedCache.clear();
+        fetchKeyed();
+    }), rowCount);
+    report("table$id set - cached fetch", measure(runs, fetchKeyed), rowCount);
+    report("RecordCache - first fetch", measure(runs, [&]() {
+        recordCache.clear();
+        fetch();
+    }), rowCount);
+    report("RecordCache - cached fetch", measure(runs, fetch), rowCount);
+
+    sqlite3_finalize(query);
+    sqlite3_close(db);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#!/bin/bash
+set -e
+
+# Builds and runs benchmarks of the native code that doesn't depend on JSI, on the host machine
+# (Linux or macOS). Needs node_modules (for simdjson and JSI headers), a C++17 compiler and sqlite.
+#
+# Usage: native/benchmarks/run.sh [Name [args...]]
+#   e.g. native/benchmarks/run.sh                            - runs all benchmarks
+#        native/benchmarks/run.sh RecordCache 200000         - runs RecordCacheBenchmark.cpp
+#
+# Environment variables:
+#   CXX, CXXFLAGS, LDFLAGS - compiler and extra flags (e.g. paths of a custom sqlite build)
+#   SIMDJSON_SRC - directory containing simdjson.h and simdjson.cpp
+#   JSI_INCLUDE - directory containing jsi/jsi.h
+
+cd "$(dirname "$0")/../.."
+
+CXX=${CXX:-c++}
+SIMDJSON_SRC=${SIMDJSON_SRC:-node_modules/@nozbe/simdjson/src}
+JSI_INCLUDE=${JSI_INCLUDE:-node_modules/react-native/ReactCommon/jsi}
+BUILD=native/benchmarks/build
+
+# NOTE: Only sources that don't depend on JSI can be benchmarked here
+SHARED_SOURCES="AsyncReader AsyncWriter BatchExecutor ChangeFeed MultiRowInsertSql PartialUpdateSql RecordCache Sqlite StatementCache"
+
+mkdir -p "$BUILD/include"
+# (shared code includes simdjson as <simdjson/simdjson.h>)
+ln -sfn "$(cd "$SIMDJSON_SRC" && pwd)" "$BUILD/include/simdjson"
+
+FLAGS="-std=c++17 -O2 -DNDEBUG -Inative/shared -Inative/benchmarks -I$SIMDJSON_SRC -I$BUILD/include -I$JSI_INCLUDE $CXXFLAGS"
+LIBS="$LDFLAGS -lsqlite3 -lpthread"
+
+compile() {
+    local source=$1
+    local object=$BUILD/$(basename "$source" .cpp).o
+    $CXX $FLAGS -c "$source" -o "$object"
+    OBJECTS="$OBJECTS $object"
+}
+
+# NOTE: simdjson takes a while to compile, and doesn't change, so it's only compiled once
+if [ ! -f "$BUILD/simdjson.o" ]; then
+    $CXX $FLAGS -c "$SIMDJSON_SRC/simdjson.cpp" -o "$BUILD/simdjson.o"
+fi
+OBJECTS="$BUILD/simdjson.o"
+compile native/benchmarks/Benchmark.cpp
+for name in $SHARED_SOURCES; do
+    compile "native/shared/$name.cpp"
+done
+
+run() {
+    local name=$1
+    shift
+    $CXX $FLAGS "native/benchmarks/${name}Benchmark.cpp" $OBJECTS $LIBS -o "$BUILD/${name}Benchmark"
+    echo "--- $name"
+    # (benchmarks that need a database file make it in the working directory)
+    (cd "$BUILD" && "./${name}Benchmark" "$@")
+}
+
+if [ $# -gt 0 ]; then
+    run "$@"
+else
+    for source in native/benchmarks/?*Benchmark.cpp; do
+        run "$(basename "$source" Benchmark.cpp)"
+    done
+fi
@@ -1,6 +1,7 @@
 #include "DatabasePlatform.h"
 #import <Foundation/Foundation.h>
 #import <React/RCTBridge.h>
+#import <ReactCommon/CallInvoker.h>
 #include <mutex>
 
 namespace watermelondb {
@@ -81,6 +82,10 @@ extern "C" void watermelondbProvideSyncJson(int id, NSData *json, NSError **erro
     providedSyncJsons[@(id)] = json;
 }
 
+extern "C" void watermelondbCancelSyncLoads() {
+    SyncLoadProgress::cancelAll();
+}
+
 std::string_view getSyncJson(int id) {
     const std::lock_guard<std::mutex> lock(providedSyncJsonsMutex);
 
@@ -97,6 +102,25 @@ void deleteSyncJson(int id) {
     [providedSyncJsons removeObjectForKey: @(id)];
 }
 
+std::shared_ptr<facebook::react::CallInvoker> jsCallInvoker;
+
+void setJsCallInvoker(std::shared_ptr<facebook::react::CallInvoker> callInvoker) {
+    jsCallInvoker = callInvoker;
+}
+
+bool canRunOnJsThread() {
+    return jsCallInvoker != nullptr;
+}
+
+bool runOnJsThread(std::function<void()> function) {
+    if (!jsCallInvoker) {
+        consoleError("Unable to run on JS thread - JS CallInvoker is not available");
+        return false;
+    }
+    jsCallInvoker->invokeAsync(std::move(function));
+    return true;
+}
+
 void onDestroy(std::function<void()> callback) {
     [NSNotificationCenter.defaultCenter addObserverForName:RCTBridgeWillReloadNotification
                                                     object:nil
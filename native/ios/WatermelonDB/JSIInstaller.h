@@ -9,6 +9,8 @@ extern "C"
 
 void installWatermelonJSI(RCTCxxBridge *bridge);
 void watermelondbProvideSyncJson(int id, NSData *json, NSError **errorPtr);
+// Cancels turbo sync loads in progress (e.g. when user logs out). Can be called from any thread
+void watermelondbCancelSyncLoads();
 
 #ifdef __cplusplus
 } // extern "C"
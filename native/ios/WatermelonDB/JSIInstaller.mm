@@ -1,5 +1,12 @@
 #import "JSIInstaller.h"
 #import "Database.h"
+#import <ReactCommon/CallInvoker.h>
+
+namespace watermelondb {
+namespace platform {
+void setJsCallInvoker(std::shared_ptr<facebook::react::CallInvoker> callInvoker);
+}
+}
 
 extern "C" void installWatermelonJSI(RCTCxxBridge *bridge) {
     if (bridge.runtime == nullptr) {
@@ -8,5 +15,6 @@ extern "C" void installWatermelonJSI(RCTCxxBridge *bridge) {
 
     jsi::Runtime *runtime = (jsi::Runtime*) bridge.runtime;
     assert(runtime != nullptr);
+    watermelondb::platform::setJsCallInvoker(bridge.jsCallInvoker);
     watermelondb::Database::install(runtime);
 }
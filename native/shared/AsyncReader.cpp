@@ -0,0 +1,184 @@
+#include "AsyncReader.h"
+#include "DatabasePlatform.h"
+#include <cassert>
+
+namespace watermelondb {
+
+using platform::consoleError;
+using platform::consoleLog;
+
+AsyncReader::Connection::Connection(std::string path) {
+    db_ = std::make_unique<SqliteDb>(path, true);
+
+    char *errmsg = nullptr;
+    // set timeout before SQLITE_BUSY error is returned
+    sqlite3_exec(db_->sqlite, "pragma busy_timeout = 5000;", nullptr, nullptr, &errmsg);
+    if (errmsg) {
+        consoleError("Failed to configure async reader connection - " + std::string(errmsg));
+        sqlite3_free(errmsg);
+    }
+}
+
+AsyncReader::Connection::~Connection() {
+    destroy();
+}
+
+void AsyncReader::Connection::destroy() {
+    statementCache_.clear();
+    db_->destroy();
+}
+
+AsyncReader::AsyncReader(std::string path, int connectionCount) : isStopping_(false), isDestroyed_(false) {
+    if (connectionCount < 1) {
+        connectionCount = 1;
+    }
+
+    for (int i = 0; i < connectionCount; i++) {
+        connections_.push_back(std::make_unique<Connection>(path));
+    }
+
+    for (auto &connection : connections_) {
+        Connection *connectionPtr = connection.get();
+        threads_.push_back(std::thread([this, connectionPtr]() {
+            loop(*connectionPtr);
+        }));
+    }
+}
+
+AsyncReader::~AsyncReader() {
+    destroy();
+}
+
+void AsyncReader::destroy() {
+    {
+        const std::lock_guard<std::mutex> lock(tasksMutex_);
+        if (isDestroyed_) {
+            return;
+        }
+        isDestroyed_ = true;
+        isStopping_ = true;
+    }
+    tasksCondition_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+
+    tasks_.clear();
+
+    for (auto &connection : connections_) {
+        connection->destroy();
+    }
+}
+
+void AsyncReader::run(std::function<void(Connection &connection)> task) {
+    {
+        const std::lock_guard<std::mutex> lock(tasksMutex_);
+        if (isStopping_) {
+            throw std::runtime_error("Async reader is closed");
+        }
+        tasks_.push_back(std::move(task));
+    }
+    tasksCondition_.notify_one();
+}
+
+void AsyncReader::loop(Connection &connection) {
+    while (true) {
+        std::function<void(Connection &connection)> task;
+        {
+            std::unique_lock<std::mutex> lock(tasksMutex_);
+            tasksCondition_.wait(lock, [this]() {
+                return isStopping_ || !tasks_.empty();
+            });
+            if (isStopping_) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task(connection);
+        } catch (const std::exception &ex) {
+            // NOTE: tasks are expected to catch their own errors and pass them back to JS
+            consoleError("Uncaught error in async reader task - " + std::string(ex.what()));
+        }
+    }
+}
+
+std::runtime_error AsyncReader::Connection::dbError(std::string description) {
+    auto sqliteMessage = std::string(sqlite3_errmsg(db_->sqlite));
+    auto code = sqlite3_extended_errcode(db_->sqlite);
+    auto message = description + " - sqlite error " + std::to_string(code) + " (" + sqliteMessage + ")";
+    return std::runtime_error(message);
+}
+
+sqlite3_stmt *AsyncReader::Connection::prepareQuery(const std::string &sql) {
+    bool isCached = false;
+    sqlite3_stmt *statement = statementCache_.prepare(db_->sqlite, sql, isCached);
+
+    if (statement == nullptr) {
+        throw dbError("Failed to prepare query statement");
+    }
+    return statement;
+}
+
+SqliteRows AsyncReader::Connection::query(const std::string &sql, const std::vector<SqliteValue> &arguments) {
+    auto stmt = prepareQuery(sql);
+    SqliteStatement statement(stmt, &statementCache_);
+
+    if (sqlite3_bind_parameter_count(stmt) != (int) arguments.size()) {
+        throw std::runtime_error("Number of args passed to query doesn't match number of arg placeholders");
+    }
+
+    for (size_t i = 0; i < arguments.size(); i++) {
+        auto &argument = arguments[i];
+        int bindResult;
+        if (argument.type == SqliteValue::Type::number) {
+            bindResult = sqlite3_bind_double(stmt, (int) i + 1, argument.number);
+        } else if (argument.type == SqliteValue::Type::text) {
+            bindResult = sqlite3_bind_text(stmt, (int) i + 1, argument.text.c_str(), (int) argument.text.length(), SQLITE_STATIC);
+        } else {
+            bindResult = sqlite3_bind_null(stmt, (int) i + 1);
+        }
+
+        if (bindResult != SQLITE_OK) {
+            throw dbError("Failed to bind an argument for query");
+        }
+    }
+
+    SqliteRows result;
+    int columnCount = sqlite3_column_count(stmt);
+    for (int i = 0; i < columnCount; i++) {
+        result.columnNames.push_back(sqlite3_column_name(stmt, i));
+    }
+
+    while (true) {
+        int stepResult = sqlite3_step(stmt);
+        if (stepResult == SQLITE_DONE) {
+            break;
+        } else if (stepResult != SQLITE_ROW) {
+            throw dbError("Failed to get a row for query");
+        }
+
+        SqliteRow row;
+        row.reserve(columnCount);
+        for (int i = 0; i < columnCount; i++) {
+            auto type = sqlite3_column_type(stmt, i);
+            if (type == SQLITE_INTEGER || type == SQLITE_FLOAT) {
+                row.push_back({ SqliteValue::Type::number, sqlite3_column_double(stmt, i), "" });
+            } else if (type == SQLITE_TEXT) {
+                const char *text = (const char *)sqlite3_column_text(stmt, i);
+                row.push_back({ SqliteValue::Type::text, 0, std::string(text, sqlite3_column_bytes(stmt, i)) });
+            } else if (type == SQLITE_NULL) {
+                row.push_back({ SqliteValue::Type::null, 0, "" });
+            } else {
+                throw std::runtime_error("Unable to fetch record from database - unknown column type (WatermelonDB does not support blobs or custom sqlite types");
+            }
+        }
+        result.rows.push_back(std::move(row));
+    }
+
+    return result;
+}
+
+} // namespace watermelondb
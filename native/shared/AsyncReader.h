@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <stdexcept>
+#include <sqlite3.h>
+
+#include "Sqlite.h"
+#include "StatementCache.h"
+
+namespace watermelondb {
+
+// Pool of read-only connections to the database, each with its own thread, used to run queries without
+// blocking the JS thread (or waiting for writes on the main connection).
+// Since the database is in WAL mode, each query sees a consistent snapshot of the database as of the
+// last commit, even while a long write transaction is in progress on the main connection.
+// NOTE: This class knows nothing about JSI - tasks must not touch the JS runtime, and results need to
+// be passed back to the JS thread (see platform::runOnJsThread)
+class AsyncReader {
+public:
+    // Single read-only connection with its own statement cache. Only ever used by one pool thread.
+    class Connection {
+    public:
+        Connection(std::string path);
+        ~Connection();
+        void destroy();
+
+        SqliteRows query(const std::string &sql, const std::vector<SqliteValue> &arguments);
+
+    private:
+        std::unique_ptr<SqliteDb> db_;
+        StatementCache statementCache_;
+
+        sqlite3_stmt *prepareQuery(const std::string &sql);
+        std::runtime_error dbError(std::string description);
+    };
+
+    AsyncReader(std::string path, int connectionCount);
+    ~AsyncReader();
+
+    // Stops the reader threads (waiting for the current tasks to finish), drops pending tasks, and closes
+    // the connections. Pending tasks are destroyed on the calling thread.
+    void destroy();
+
+    // Enqueues a task to be run on the first available reader thread
+    void run(std::function<void(Connection &connection)> task);
+
+private:
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::vector<std::thread> threads_;
+    std::mutex tasksMutex_;
+    std::condition_variable tasksCondition_;
+    std::deque<std::function<void(Connection &connection)>> tasks_;
+    bool isStopping_;
+    bool isDestroyed_;
+
+    void loop(Connection &connection);
+};
+
+} // namespace watermelondb
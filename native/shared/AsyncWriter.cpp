@@ -0,0 +1,221 @@
+#include "AsyncWriter.h"
+#include "DatabasePlatform.h"
+
+namespace watermelondb {
+
+using platform::consoleError;
+using platform::consoleLog;
+
+// How long to wait for more batches before committing a group
+static constexpr auto groupCommitWindow = std::chrono::milliseconds(2);
+static constexpr size_t maxGroupSize = 64;
+
+AsyncWriter::AsyncWriter(std::string path) : isWriting_(false), isStopping_(false), isDestroyed_(false) {
+    db_ = std::make_unique<SqliteDb>(path);
+
+    std::string initSql = "";
+    // NOTE: Must match per-connection settings of the main connection (see Database::Database)
+    #ifdef ANDROID
+    initSql += "pragma temp_store = memory;";
+    #endif
+    // set timeout before SQLITE_BUSY error is returned
+    initSql += "pragma busy_timeout = 5000;";
+    #ifdef ANDROID
+    initSql += "pragma synchronous = FULL;";
+    #endif
+
+    char *errmsg = nullptr;
+    sqlite3_exec(db_->sqlite, initSql.c_str(), nullptr, nullptr, &errmsg);
+    if (errmsg) {
+        consoleError("Failed to configure async writer connection - " + std::string(errmsg));
+        sqlite3_free(errmsg);
+    }
+    changeFeed_.attach(db_->sqlite);
+
+    thread_ = std::thread([this]() {
+        loop();
+    });
+}
+
+AsyncWriter::~AsyncWriter() {
+    destroy();
+}
+
+void AsyncWriter::destroy() {
+    {
+        std::unique_lock<std::mutex> lock(batchesMutex_);
+        if (isDestroyed_) {
+            return;
+        }
+        isDestroyed_ = true;
+        // NOTE: Unlike reads, writes can't be dropped
+        idleCondition_.wait(lock, [this]() {
+            return batches_.empty() && !isWriting_;
+        });
+        isStopping_ = true;
+    }
+    batchesCondition_.notify_all();
+    thread_.join();
+
+    statementCache_.clear();
+    db_->destroy();
+}
+
+void AsyncWriter::enqueue(std::string operationsJson, std::function<void(BatchResult)> onDone) {
+    {
+        const std::lock_guard<std::mutex> lock(batchesMutex_);
+        if (isDestroyed_) {
+            throw std::runtime_error("Async writer is closed");
+        }
+        batches_.push_back({ std::move(operationsJson), std::move(onDone) });
+    }
+    batchesCondition_.notify_one();
+}
+
+void AsyncWriter::flush() {
+    std::unique_lock<std::mutex> lock(batchesMutex_);
+    idleCondition_.wait(lock, [this]() {
+        return batches_.empty() && !isWriting_;
+    });
+}
+
+std::unique_lock<std::mutex> AsyncWriter::holdCommits() {
+    return std::unique_lock<std::mutex>(commitMutex_);
+}
+
+void AsyncWriter::clearCaches() {
+    std::unique_lock<std::mutex> lock(batchesMutex_);
+    idleCondition_.wait(lock, [this]() {
+        return batches_.empty() && !isWriting_;
+    });
+    // NOTE: The writer thread can't start writing while we hold the lock
+    statementCache_.clear();
+    partialUpdateSql_.clear();
+    multiRowInsertSql_.clear();
+}
+
+void AsyncWriter::loop() {
+    while (true) {
+        std::vector<Batch> group;
+        {
+            std::unique_lock<std::mutex> lock(batchesMutex_);
+            batchesCondition_.wait(lock, [this]() {
+                return isStopping_ || !batches_.empty();
+            });
+            if (isStopping_) {
+                return;
+            }
+
+            // Give other batches a chance to join this transaction
+            batchesCondition_.wait_for(lock, groupCommitWindow, [this]() {
+                return isStopping_ || batches_.size() >= maxGroupSize;
+            });
+
+            while (!batches_.empty() && group.size() < maxGroupSize) {
+                group.push_back(std::move(batches_.front()));
+                batches_.pop_front();
+            }
+            isWriting_ = true;
+        }
+
+        writeGroup(group);
+
+        {
+            const std::lock_guard<std::mutex> lock(batchesMutex_);
+            isWriting_ = false;
+        }
+        idleCondition_.notify_all();
+    }
+}
+
+void AsyncWriter::writeGroup(std::vector<Batch> &group) {
+    std::vector<BatchResult> results(group.size());
+    std::unique_lock<std::mutex> commitLock(commitMutex_, std::defer_lock);
+
+    try {
+        // NOTE: using exclusive transaction, just like Database::beginTransaction
+        execute("begin exclusive transaction");
+        changeFeed_.begin();
+
+        try {
+            for (size_t i = 0; i < group.size(); i++) {
+                auto &result = results[i];
+                execute("savepoint watermelon_batch");
+                try {
+                    writeBatch(group[i].operationsJson, result);
+                    execute("release watermelon_batch");
+                    result.changes = changeFeed_.takeChanges();
+                    result.isComplete = changeFeed_.isComplete();
+                } catch (const std::exception &ex) {
+                    discardResult(result);
+                    result.error = ex.what();
+                    execute("rollback to watermelon_batch");
+                    execute("release watermelon_batch");
+                    changeFeed_.takeChanges();
+                }
+            }
+
+            commitLock.lock();
+            execute("commit transaction");
+            changeFeed_.finish();
+        } catch (const std::exception &ex) {
+            changeFeed_.finish();
+            consoleError("Async write transaction is being rolled back - " + std::string(ex.what()));
+            try {
+                execute("rollback transaction");
+            } catch (const std::exception &rollbackEx) {
+                consoleError("Error while attempting to roll back transaction, probably harmless: " + std::string(rollbackEx.what()));
+            }
+            throw;
+        }
+    } catch (const std::exception &ex) {
+        for (auto &result : results) {
+            discardResult(result);
+            result.error = ex.what();
+        }
+    }
+
+    // NOTE: If the group was committed, commitLock is still held
+    for (size_t i = 0; i < group.size(); i++) {
+        try {
+            group[i].onDone(std::move(results[i]));
+        } catch (const std::exception &ex) {
+            consoleError("Uncaught error in async writer callback - " + std::string(ex.what()));
+        }
+    }
+}
+
+void AsyncWriter::discardResult(BatchResult &result) {
+    result.cacheChanges.clear();
+    result.changes.clear();
+    result.isComplete = true;
+}
+
+void AsyncWriter::writeBatch(const std::string &operationsJson, BatchResult &result) {
+    BatchExecutor executor(db_->sqlite, statementCache_, partialUpdateSql_, multiRowInsertSql_, changeFeed_);
+    result.cacheChanges = executor.executeJSON(operationsJson);
+}
+
+void AsyncWriter::execute(const char *sql) {
+    char *errmsg = nullptr;
+    int resultExec = sqlite3_exec(db_->sqlite, sql, nullptr, nullptr, &errmsg);
+
+    if (errmsg) {
+        std::string message(errmsg);
+        sqlite3_free(errmsg);
+        throw std::runtime_error(message);
+    }
+
+    if (resultExec != SQLITE_OK) {
+        throw dbError("Failed to execute statements");
+    }
+}
+
+std::runtime_error AsyncWriter::dbError(std::string description) {
+    auto sqliteMessage = std::string(sqlite3_errmsg(db_->sqlite));
+    auto code = sqlite3_extended_errcode(db_->sqlite);
+    auto message = description + " - sqlite error " + std::to_string(code) + " (" + sqliteMessage + ")";
+    return std::runtime_error(message);
+}
+
+} // namespace watermelondb
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <stdexcept>
+#include <sqlite3.h>
+
+#include "Sqlite.h"
+#include "StatementCache.h"
+#include "PartialUpdateSql.h"
+#include "MultiRowInsertSql.h"
+#include "ChangeFeed.h"
+#include "BatchExecutor.h"
+
+namespace watermelondb {
+
+// Separate connection to the database with its own thread, used to write batches without blocking the
+// JS thread on transaction commits (fsync).
+// Batches enqueued within a short window of each other are committed together in a single transaction
+// (group commit), but each batch is isolated in a savepoint, so that a failing batch doesn't affect
+// others.
+// NOTE: This class knows nothing about JSI - callbacks are called on the writer thread, and results need
+// to be passed back to the JS thread (see platform::runOnJsThread)
+class AsyncWriter {
+public:
+    struct BatchResult {
+        std::string error; // empty if batch was committed
+        // IDs to add to/remove from record cache, in order
+        std::vector<BatchExecutor::CacheChanges> cacheChanges;
+        // Rows changed by the batch, as recorded by the writer's connection (see ChangeFeed)
+        std::vector<ChangeFeed::TableChanges> changes;
+        bool isComplete = true; // see ChangeFeed::isComplete
+    };
+
+    AsyncWriter(std::string path);
+    ~AsyncWriter();
+
+    // Waits for all enqueued batches to be committed, stops the writer thread and closes the connection
+    void destroy();
+
+    // Enqueues a batch in batchJSON format to be written. `onDone` is called on the writer thread after
+    // the transaction containing this batch is committed (or fails). Batches can't be committed again
+    // until `onDone` of all batches committed together returns (see holdCommits)
+    void enqueue(std::string operationsJson, std::function<void(BatchResult)> onDone);
+
+    // Blocks until all enqueued batches are committed (or failed)
+    void flush();
+
+    // Keeps batches from being committed for as long as the returned lock is held. Use to read from
+    // another connection knowing that everything committed by then has been passed to `onDone`
+    // NOTE: Don't call flush() while holding this lock - it would deadlock
+    std::unique_lock<std::mutex> holdCommits();
+
+    // Waits like flush(), and forgets prepared statements and cached SQL. Called after the database is
+    // reset or migrated on another connection, so that nothing made for the old schema is kept around
+    void clearCaches();
+
+private:
+    struct Batch {
+        std::string operationsJson;
+        std::function<void(BatchResult)> onDone;
+    };
+
+    std::unique_ptr<SqliteDb> db_;
+    StatementCache statementCache_;
+    PartialUpdateSql partialUpdateSql_;
+    MultiRowInsertSql multiRowInsertSql_;
+    ChangeFeed changeFeed_; // NOTE: Only used on the writer thread
+
+    std::thread thread_;
+    std::mutex commitMutex_; // held while committing, and until results are passed to `onDone`
+    std::mutex batchesMutex_;
+    std::condition_variable batchesCondition_;
+    std::condition_variable idleCondition_;
+    std::deque<Batch> batches_;
+    bool isWriting_;
+    bool isStopping_;
+    bool isDestroyed_;
+
+    void loop();
+    void writeGroup(std::vector<Batch> &group);
+    void writeBatch(const std::string &operationsJson, BatchResult &result);
+    void discardResult(BatchResult &result);
+    void execute(const char *sql);
+    std::runtime_error dbError(std::string description);
+};
+
+} // namespace watermelondb
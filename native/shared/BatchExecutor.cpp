@@ -0,0 +1,386 @@
+#include "BatchExecutor.h"
+#include "Sqlite.h"
+#include <cstring>
+
+// FIXME: Make these paths consistent across platforms
+#if __ANDROID__
+#import <simdjson.h>
+#elif defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+#include <simdjson.h>
+#else
+#include <simdjson/simdjson.h>
+#endif
+
+namespace watermelondb {
+
+namespace {
+
+// Reads batches in batchJSON format (JSON array of operations)
+// NOTE: simdjson::ondemand processes forwards-only, hence the weird field enumeration
+// We can't use subscript or backtrack.
+class JsonBatchReader : public BatchReader {
+public:
+    JsonBatchReader(std::string_view json) : json_(json), hasOperation_(false) {
+        doc_ = parser_.iterate(json_);
+        operations_ = doc_.get_array();
+        operationIt_ = operations_.begin();
+        operationsEnd_ = operations_.end();
+    }
+
+    bool nextOperation(BatchOperation &operation) override {
+        using namespace simdjson;
+
+        if (hasOperation_) {
+            ++operationIt_;
+        }
+        if (operationIt_ == operationsEnd_) {
+            return false;
+        }
+        hasOperation_ = true;
+
+        operation.cacheBehavior = 0;
+        operation.table = {};
+        operation.sql = {};
+        operation.columns.clear();
+        operation.rowCount = 0;
+
+        ondemand::array fields = *operationIt_;
+        size_t fieldIdx = 0;
+        for (auto field : fields) {
+            if (fieldIdx == 0) {
+                operation.cacheBehavior = (int) (int64_t) field;
+            } else if (fieldIdx == 1) {
+                if (field.type() == ondemand::json_type::string) {
+                    operation.table = (std::string_view) field;
+                }
+            } else if (fieldIdx == 2) {
+                if (field.type() == ondemand::json_type::array) {
+                    // Partial update - list of columns to set instead of SQL
+                    for (std::string_view column : field.get_array()) {
+                        operation.columns.push_back(column);
+                    }
+                } else {
+                    operation.sql = (std::string_view) field;
+                }
+            } else if (fieldIdx == 3) {
+                rows_ = field;
+                operation.rowCount = rows_.count_elements();
+                rowIt_ = rows_.begin();
+                return true;
+            }
+            fieldIdx++;
+        }
+        throw std::runtime_error("Malformed batch - operation is missing arguments");
+    }
+
+    void nextRow(std::vector<BatchValue> &args) override {
+        using namespace simdjson;
+
+        args.clear();
+        ondemand::array row = *rowIt_;
+        for (auto arg : row) {
+            ondemand::json_type type = arg.type();
+
+            if (type == ondemand::json_type::string) {
+                args.push_back({ BatchValue::Type::string, 0, (std::string_view) arg, false });
+            } else if (type == ondemand::json_type::number) {
+                args.push_back({ BatchValue::Type::number, (double) arg, {}, false });
+            } else if (type == ondemand::json_type::boolean) {
+                args.push_back({ BatchValue::Type::boolean, 0, {}, (bool) arg });
+            } else if (type == ondemand::json_type::null) {
+                args.push_back({ BatchValue::Type::null, 0, {}, false });
+            } else {
+                throw std::runtime_error("Invalid argument type for query - only strings, numbers, booleans and null are allowed");
+            }
+        }
+        ++rowIt_;
+    }
+
+private:
+    simdjson::padded_string json_;
+    simdjson::ondemand::parser parser_;
+    simdjson::ondemand::document doc_;
+    simdjson::ondemand::array operations_;
+    simdjson::ondemand::array_iterator operationIt_;
+    simdjson::ondemand::array_iterator operationsEnd_;
+    simdjson::ondemand::array rows_;
+    simdjson::ondemand::array_iterator rowIt_;
+    bool hasOperation_;
+};
+
+// Reads batches in binary format (see encodeBinaryBatch for the layout)
+// NOTE: Values are little-endian and unaligned, so we memcpy them out. All platforms we support
+// are little-endian
+class BinaryBatchReader : public BatchReader {
+public:
+    BinaryBatchReader(const uint8_t *data, size_t size) : data_(data), size_(size), offset_(0) {
+        uint32_t stringCount = readU32();
+        operationsLeft_ = readU32();
+
+        strings_.reserve(stringCount);
+        for (uint32_t i = 0; i < stringCount; i++) {
+            strings_.push_back(readString());
+        }
+    }
+
+    bool nextOperation(BatchOperation &operation) override {
+        if (operationsLeft_ == 0) {
+            return false;
+        }
+        operationsLeft_--;
+
+        operation.cacheBehavior = (int8_t) readU8();
+        uint32_t tableIndex = readU32();
+        uint32_t sqlIndex = readU32();
+
+        operation.table = tableIndex == noTable ? std::string_view() : stringAt(tableIndex);
+        operation.sql = {};
+        operation.columns.clear();
+        if (sqlIndex == partialUpdate) {
+            uint32_t columnCount = readU32();
+            operation.columns.reserve(columnCount);
+            for (uint32_t j = 0; j < columnCount; j++) {
+                operation.columns.push_back(stringAt(readU32()));
+            }
+        } else {
+            operation.sql = stringAt(sqlIndex);
+        }
+        operation.rowCount = readU32();
+        return true;
+    }
+
+    void nextRow(std::vector<BatchValue> &args) override {
+        args.clear();
+        uint32_t argCount = readU32();
+        for (uint32_t k = 0; k < argCount; k++) {
+            auto type = (ValueType) readU8();
+
+            if (type == ValueType::string) {
+                args.push_back({ BatchValue::Type::string, 0, readString(), false });
+            } else if (type == ValueType::number) {
+                args.push_back({ BatchValue::Type::number, readF64(), {}, false });
+            } else if (type == ValueType::trueValue || type == ValueType::falseValue) {
+                args.push_back({ BatchValue::Type::boolean, 0, {}, type == ValueType::trueValue });
+            } else if (type == ValueType::null) {
+                args.push_back({ BatchValue::Type::null, 0, {}, false });
+            } else {
+                throw std::runtime_error("Invalid argument type for query - only strings, numbers, booleans and null are allowed");
+            }
+        }
+    }
+
+private:
+    enum class ValueType : uint8_t { null = 0, number = 1, string = 2, trueValue = 3, falseValue = 4 };
+
+    static constexpr uint32_t noTable = 0xffffffff;
+    static constexpr uint32_t partialUpdate = 0xffffffff;
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t offset_;
+    uint32_t operationsLeft_;
+    std::vector<std::string_view> strings_;
+
+    uint8_t readU8() {
+        ensure(1);
+        return data_[offset_++];
+    }
+
+    uint32_t readU32() {
+        uint32_t value;
+        ensure(sizeof(value));
+        std::memcpy(&value, data_ + offset_, sizeof(value));
+        offset_ += sizeof(value);
+        return value;
+    }
+
+    double readF64() {
+        double value;
+        ensure(sizeof(value));
+        std::memcpy(&value, data_ + offset_, sizeof(value));
+        offset_ += sizeof(value);
+        return value;
+    }
+
+    // NOTE: Returned view points into the batch buffer, it's not copied
+    std::string_view readString() {
+        uint32_t length = readU32();
+        ensure(length);
+        std::string_view value(reinterpret_cast<const char *>(data_ + offset_), length);
+        offset_ += length;
+        return value;
+    }
+
+    std::string_view stringAt(uint32_t index) {
+        if (index >= strings_.size()) {
+            throw std::runtime_error("Malformed binary batch - string index out of range");
+        }
+        return strings_[index];
+    }
+
+    void ensure(size_t count) {
+        if (size_ - offset_ < count) {
+            throw std::runtime_error("Malformed binary batch - unexpected end of buffer");
+        }
+    }
+};
+
+std::string_view idOf(const std::vector<BatchValue> &args) {
+    return !args.empty() && args[0].type == BatchValue::Type::string ? args[0].string : std::string_view();
+}
+
+}
+
+BatchExecutor::BatchExecutor(sqlite3 *db,
+                             StatementCache &statementCache,
+                             PartialUpdateSql &partialUpdateSql,
+                             MultiRowInsertSql &multiRowInsertSql,
+                             ChangeFeed &changeFeed)
+    : db_(db),
+      statementCache_(statementCache),
+      partialUpdateSql_(partialUpdateSql),
+      multiRowInsertSql_(multiRowInsertSql),
+      changeFeed_(changeFeed) {}
+
+std::vector<BatchExecutor::CacheChanges> BatchExecutor::executeJSON(std::string_view json) {
+    JsonBatchReader reader(json);
+    return execute(reader);
+}
+
+std::vector<BatchExecutor::CacheChanges> BatchExecutor::executeBinary(const uint8_t *data, size_t size) {
+    BinaryBatchReader reader(data, size);
+    return execute(reader);
+}
+
+std::vector<BatchExecutor::CacheChanges> BatchExecutor::execute(BatchReader &reader) {
+    std::vector<CacheChanges> cacheChanges;
+    BatchOperation operation;
+
+    while (reader.nextOperation(operation)) {
+        std::string sql;
+        PartialUpdateSql::Statement partialUpdate { nullptr, {} };
+        if (operation.sql.empty()) {
+            if (operation.table.empty() || operation.columns.empty()) {
+                throw std::runtime_error("Malformed batch - missing SQL or table and columns of a partial update");
+            }
+            partialUpdate = partialUpdateSql_.statementFor(operation.table, operation.columns);
+            sql = *partialUpdate.sql;
+        } else {
+            sql = std::string(operation.sql);
+        }
+
+        CacheChanges *changes = nullptr;
+        if (operation.cacheBehavior == 1 || operation.cacheBehavior == -1) {
+            if (operation.table.empty()) {
+                throw std::runtime_error("Malformed batch - missing table of a cached operation");
+            }
+            cacheChanges.push_back({ std::string(operation.table), operation.cacheBehavior == -1, {} });
+            changes = &cacheChanges.back();
+            changes->ids.reserve(operation.rowCount);
+        }
+
+        // Creates are packed into multi-row inserts, which is much faster than inserting row by row
+        int rowArgsCount = operation.cacheBehavior == 1 && !partialUpdate.sql ? MultiRowInsertSql::rowArgsCount(sql) : 0;
+        if (rowArgsCount > 0) {
+            size_t rowsLeft = operation.rowCount;
+            int maxArgsCount = sqlite3_limit(db_, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+
+            while (rowsLeft > 0) {
+                int rowCount = MultiRowInsertSql::rowsPerStatement(rowsLeft, rowArgsCount, maxArgsCount);
+                auto stmt = prepare(rowCount == 1 ? sql : multiRowInsertSql_.sqlFor(sql, rowCount));
+                SqliteStatement statement(stmt, &statementCache_);
+
+                // NOTE: IDs of packed rows aren't passed to changeFeed_ - they're looked up by rowid later
+                for (int row = 0; row < rowCount; row++) {
+                    reader.nextRow(args_);
+                    bindArgs(stmt, nullptr, row * rowArgsCount, rowArgsCount);
+                    changes->ids.emplace_back(idOf(args_));
+                }
+
+                step(stmt);
+                rowsLeft -= rowCount;
+            }
+            continue;
+        }
+
+        auto stmt = prepare(sql);
+        SqliteStatement statement(stmt, &statementCache_);
+        auto placeholders = partialUpdate.sql ? &partialUpdate.placeholders : nullptr;
+        int argsCount = sqlite3_bind_parameter_count(stmt);
+        // (first argument of other operations isn't necessarily an ID)
+        bool hasId = operation.cacheBehavior != 0 || partialUpdate.sql;
+
+        for (size_t row = 0; row < operation.rowCount; row++) {
+            reader.nextRow(args_);
+            bindArgs(stmt, placeholders, 0, argsCount);
+
+            auto id = idOf(args_);
+            if (hasId) {
+                changeFeed_.setCurrentId(id);
+            }
+            step(stmt);
+            sqlite3_reset(stmt);
+            changeFeed_.clearCurrentId();
+
+            if (changes) {
+                changes->ids.emplace_back(id);
+            }
+        }
+    }
+
+    return cacheChanges;
+}
+
+sqlite3_stmt *BatchExecutor::prepare(const std::string &sql) {
+    bool isCached = false;
+    auto statement = statementCache_.prepare(db_, sql, isCached);
+    if (statement == nullptr) {
+        throw dbError("Failed to prepare query statement");
+    }
+    return statement;
+}
+
+// Binds args_ as arguments of a statement
+// NOTE: `argsOffset` and `argsCount` are for binding a single row of a multi-row statement
+// NOTE: Strings are bound without copying, so they must stay valid until the statement is executed
+void BatchExecutor::bindArgs(sqlite3_stmt *statement, const std::vector<int> *placeholders, int argsOffset, int argsCount) {
+    if ((int) args_.size() != argsCount) {
+        throw std::runtime_error("Number of args passed to query doesn't match number of arg placeholders");
+    }
+
+    for (int i = 0; i < argsCount; i++) {
+        auto &arg = args_[i];
+        // NOTE: Arguments of partial updates aren't in the same order as placeholders (see PartialUpdateSql)
+        int argIdx = argsOffset + (placeholders ? (*placeholders)[i] : i + 1);
+        int bindResult;
+
+        if (arg.type == BatchValue::Type::string) {
+            bindResult = sqlite3_bind_text(statement, argIdx, arg.string.data(), (int) arg.string.length(), SQLITE_STATIC);
+        } else if (arg.type == BatchValue::Type::number) {
+            bindResult = sqlite3_bind_double(statement, argIdx, arg.number);
+        } else if (arg.type == BatchValue::Type::boolean) {
+            bindResult = sqlite3_bind_int(statement, argIdx, arg.boolean);
+        } else {
+            bindResult = sqlite3_bind_null(statement, argIdx);
+        }
+
+        if (bindResult != SQLITE_OK) {
+            throw dbError("Failed to bind an argument for query");
+        }
+    }
+}
+
+void BatchExecutor::step(sqlite3_stmt *statement) {
+    if (sqlite3_step(statement) != SQLITE_DONE) {
+        throw dbError("Failed to execute db update");
+    }
+}
+
+std::runtime_error BatchExecutor::dbError(std::string description) {
+    auto sqliteMessage = std::string(sqlite3_errmsg(db_));
+    auto code = sqlite3_extended_errcode(db_);
+    auto message = description + " - sqlite error " + std::to_string(code) + " (" + sqliteMessage + ")";
+    return std::runtime_error(message);
+}
+
+} // namespace watermelondb
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include <sqlite3.h>
+
+#include "StatementCache.h"
+#include "PartialUpdateSql.h"
+#include "MultiRowInsertSql.h"
+#include "ChangeFeed.h"
+
+namespace watermelondb {
+
+// Value of a batch argument
+// NOTE: Strings point into memory of the BatchReader they were read from
+struct BatchValue {
+    enum class Type : uint8_t { null, number, string, boolean };
+    Type type;
+    double number;
+    std::string_view string;
+    bool boolean;
+};
+
+// Batch operation, as made by encodeBatch: `[cacheBehavior, table, sql or columns, argsBatches]`
+struct BatchOperation {
+    int cacheBehavior; // 1 - record is created (added to record cache), -1 - removed, 0 - neither
+    std::string_view table; // empty if not given
+    std::string_view sql; // empty for partial updates
+    std::vector<std::string_view> columns; // columns to set, for partial updates (see PartialUpdateSql)
+    size_t rowCount; // number of argsBatches
+};
+
+// Decodes operations of a batch in one of the formats passed from JS (JSON, binary, JSI array)
+// NOTE: Operations and their rows must be read in order. Values read must stay valid until the next
+// operation is read
+class BatchReader {
+public:
+    virtual ~BatchReader() = default;
+    // Returns false if there are no more operations
+    virtual bool nextOperation(BatchOperation &operation) = 0;
+    // Reads arguments of the next row (argsBatch) of the current operation
+    virtual void nextRow(std::vector<BatchValue> &args) = 0;
+};
+
+// Executes batches on a connection. Used by all batch methods, synchronous and async, so that they
+// behave (and perform) the same, regardless of the format batches are passed in.
+// NOTE: This class knows nothing about JSI or the record cache - IDs of records created and removed
+// are returned, to be applied to the cache once the batch is committed
+class BatchExecutor {
+public:
+    // IDs of records to add to (or remove from) the record cache of a table
+    struct CacheChanges {
+        std::string table;
+        bool isRemoved;
+        std::vector<std::string> ids;
+    };
+
+    BatchExecutor(sqlite3 *db,
+                  StatementCache &statementCache,
+                  PartialUpdateSql &partialUpdateSql,
+                  MultiRowInsertSql &multiRowInsertSql,
+                  ChangeFeed &changeFeed);
+
+    // Executes all operations read from `reader`. Must be called in a transaction, which the caller
+    // must roll back if this throws. Returned cache changes are in order of operations
+    std::vector<CacheChanges> execute(BatchReader &reader);
+    // Same as execute(), for batches in batchJSON and batchBinary (see encodeBinaryBatch) formats
+    std::vector<CacheChanges> executeJSON(std::string_view json);
+    std::vector<CacheChanges> executeBinary(const uint8_t *data, size_t size);
+
+private:
+    sqlite3 *db_;
+    StatementCache &statementCache_;
+    PartialUpdateSql &partialUpdateSql_;
+    MultiRowInsertSql &multiRowInsertSql_;
+    ChangeFeed &changeFeed_;
+    std::vector<BatchValue> args_;
+
+    sqlite3_stmt *prepare(const std::string &sql);
+    void bindArgs(sqlite3_stmt *statement, const std::vector<int> *placeholders, int argsOffset, int argsCount);
+    void step(sqlite3_stmt *statement);
+    std::runtime_error dbError(std::string description);
+};
+
+} // namespace watermelondb
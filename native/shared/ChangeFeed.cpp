@@ -0,0 +1,197 @@
+#include "ChangeFeed.h"
+#include <cstring>
+#include <unordered_map>
+
+namespace watermelondb {
+
+ChangeFeed::ChangeFeed()
+    : db_(nullptr), isRecording_(false), isComplete_(true), totalChangesAtBegin_(0), reportedCount_(0), lastTable_(0), committedCount_(0) {
+}
+
+void ChangeFeed::attach(sqlite3 *db) {
+    db_ = db;
+    sqlite3_update_hook(db, &ChangeFeed::onUpdate, this);
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+    sqlite3_preupdate_hook(db, &ChangeFeed::onPreupdate, this);
+#endif
+    sqlite3_commit_hook(db, &ChangeFeed::onCommit, this);
+    sqlite3_rollback_hook(db, &ChangeFeed::onRollback, this);
+}
+
+void ChangeFeed::begin() {
+    log_.clear();
+    committedCount_ = 0;
+    currentId_.clear();
+    isRecording_ = true;
+    totalChangesAtBegin_ = sqlite3_total_changes(db_);
+    reportedCount_ = 0;
+}
+
+void ChangeFeed::setCurrentId(std::string_view id) {
+    currentId_.assign(id.data(), id.size());
+}
+
+void ChangeFeed::clearCurrentId() {
+    currentId_.clear();
+}
+
+uint32_t ChangeFeed::tableIndex(const char *table) {
+    // NOTE: There's only a handful of tables, and consecutive changes are usually made to the same
+    // table, so this is faster than hashing the name
+    if (lastTable_ < tableNames_.size() && tableNames_[lastTable_] == table) {
+        return lastTable_;
+    }
+    for (uint32_t i = 0; i < tableNames_.size(); i++) {
+        if (tableNames_[i] == table) {
+            lastTable_ = i;
+            return i;
+        }
+    }
+    tableNames_.emplace_back(table);
+    lastTable_ = (uint32_t) tableNames_.size() - 1;
+    return lastTable_;
+}
+
+void ChangeFeed::onUpdate(void *self, int type, const char *database, const char *table, sqlite3_int64 rowid) {
+    auto feed = static_cast<ChangeFeed *>(self);
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+    // NOTE: Deletes are recorded by onPreupdate
+    if (type == SQLITE_DELETE) {
+        return;
+    }
+#endif
+    if (!feed->isRecording_) {
+        return;
+    }
+    feed->reportedCount_++;
+    // NOTE: Tables in other schemas (e.g. temp) can't hold records
+    if (std::strcmp(database, "main") != 0) {
+        return;
+    }
+
+    Operation operation = type == SQLITE_INSERT ? Operation::created
+                          : type == SQLITE_DELETE ? Operation::destroyed
+                                                  : Operation::updated;
+    feed->log_.push_back({ operation, feed->tableIndex(table), rowid, feed->currentId_ });
+}
+
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+void ChangeFeed::onPreupdate(void *self, sqlite3 *db, int type, const char *database, const char *table, sqlite3_int64 oldRowid, sqlite3_int64 newRowid) {
+    auto feed = static_cast<ChangeFeed *>(self);
+    if (type != SQLITE_DELETE || !feed->isRecording_) {
+        return;
+    }
+    feed->reportedCount_++;
+    if (std::strcmp(database, "main") != 0) {
+        return;
+    }
+
+    // NOTE: Not using currentId_, since this may be a different row (e.g. deleted by `insert or replace`)
+    std::string id;
+    sqlite3_value *value = nullptr;
+    if (sqlite3_preupdate_old(db, 0, &value) == SQLITE_OK && sqlite3_value_type(value) == SQLITE_TEXT) {
+        id.assign((const char *) sqlite3_value_text(value), sqlite3_value_bytes(value));
+    }
+    feed->log_.push_back({ Operation::destroyed, feed->tableIndex(table), oldRowid, std::move(id) });
+}
+#endif
+
+int ChangeFeed::onCommit(void *self) {
+    auto feed = static_cast<ChangeFeed *>(self);
+    feed->committedCount_ = feed->log_.size();
+    return 0; // (non-zero would turn the commit into a rollback)
+}
+
+void ChangeFeed::onRollback(void *self) {
+    auto feed = static_cast<ChangeFeed *>(self);
+    feed->log_.resize(feed->committedCount_);
+}
+
+std::vector<ChangeFeed::TableChanges> ChangeFeed::finish() {
+    isRecording_ = false;
+    currentId_.clear();
+    checkCompleteness();
+    return mergeCommitted();
+}
+
+std::vector<ChangeFeed::TableChanges> ChangeFeed::takeChanges() {
+    currentId_.clear();
+    checkCompleteness();
+    totalChangesAtBegin_ = sqlite3_total_changes(db_);
+    reportedCount_ = 0;
+    committedCount_ = log_.size();
+    return mergeCommitted();
+}
+
+void ChangeFeed::checkCompleteness() {
+    // NOTE: sqlite counts all rows changed by statements (and triggers), whether reported or not. It also
+    // counts changes that were rolled back, so this errs on the side of reporting changes as incomplete
+    isComplete_ = (size_t) (sqlite3_total_changes(db_) - totalChangesAtBegin_) <= reportedCount_;
+}
+
+// Merges changes in log_ before committedCount_ (see finish), and clears the log
+std::vector<ChangeFeed::TableChanges> ChangeFeed::mergeCommitted() {
+    std::vector<TableChanges> result;
+    // (indexed by table index) index in result, or -1
+    std::vector<int> resultIndices(tableNames_.size(), -1);
+    // (indexed by result index) rowid -> index in changes
+    std::vector<std::unordered_map<sqlite3_int64, size_t>> rowIndices;
+    // (indexed by result index, then by change index) whether the row didn't exist before
+    std::vector<std::vector<bool>> wasCreated;
+
+    for (size_t i = 0; i < committedCount_; i++) {
+        auto &logged = log_[i];
+
+        int &resultIndex = resultIndices[logged.table];
+        if (resultIndex == -1) {
+            resultIndex = (int) result.size();
+            result.push_back({ tableNames_[logged.table], {} });
+            rowIndices.emplace_back();
+            wasCreated.emplace_back();
+        }
+        auto &changes = result[resultIndex].changes;
+
+        // NOTE: A rowid can be reused after the row was deleted, and then it's a different row
+        auto row = rowIndices[resultIndex].find(logged.rowid);
+        if (row == rowIndices[resultIndex].end() || changes[row->second].operation == Operation::destroyed) {
+            rowIndices[resultIndex][logged.rowid] = changes.size();
+            changes.push_back({ logged.operation, logged.rowid, std::move(logged.id) });
+            wasCreated[resultIndex].push_back(logged.operation == Operation::created);
+            continue;
+        }
+
+        auto &change = changes[row->second];
+        if (!logged.id.empty()) {
+            change.id = std::move(logged.id);
+        }
+        if (logged.operation == Operation::destroyed) {
+            change.operation = Operation::destroyed;
+        }
+    }
+
+    // Rows that were both created and destroyed didn't really change
+    std::vector<TableChanges> merged;
+    for (size_t t = 0; t < result.size(); t++) {
+        auto &changes = result[t].changes;
+        size_t kept = 0;
+        for (size_t c = 0; c < changes.size(); c++) {
+            if (wasCreated[t][c] && changes[c].operation == Operation::destroyed) {
+                continue;
+            }
+            if (kept != c) {
+                changes[kept] = std::move(changes[c]);
+            }
+            kept++;
+        }
+        changes.resize(kept);
+        if (kept) {
+            merged.push_back(std::move(result[t]));
+        }
+    }
+
+    log_.clear();
+    committedCount_ = 0;
+    return merged;
+}
+
+} // namespace watermelondb
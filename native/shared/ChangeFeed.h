@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+
+namespace watermelondb {
+
+// Records rows inserted, updated, and deleted through a database connection (including by raw SQL)
+// using sqlite's update, commit, and rollback hooks, so that JS can be told what a write changed.
+// Changes made in a transaction that was rolled back are forgotten.
+// NOTE: This class knows nothing about JSI or record IDs - sqlite only reports rowids, so IDs are
+// attached by the caller (see setCurrentId) or looked up later (see Database::resolveChanges)
+// NOTE: If sqlite is compiled with SQLITE_ENABLE_PREUPDATE_HOOK, deletes are recorded using the
+// preupdate hook instead, which also reports IDs of deleted rows (from the first column - `id` in
+// record tables), and rows deleted by truncating a table or by `insert or replace`. Otherwise, those
+// rows aren't reported at all, but truncating a table is detected (see isComplete)
+class ChangeFeed {
+public:
+    enum class Operation : uint8_t { created, updated, destroyed };
+
+    struct Change {
+        Operation operation;
+        sqlite3_int64 rowid;
+        std::string id; // empty if not known
+    };
+
+    // Changes to a single table, at most one per row, in order of first change
+    struct TableChanges {
+        std::string table;
+        std::vector<Change> changes;
+    };
+
+    ChangeFeed();
+
+    ChangeFeed &operator=(const ChangeFeed &) = delete;
+    ChangeFeed(const ChangeFeed &) = delete;
+
+    // Registers hooks on the connection. Must be called once, before any changes are made
+    void attach(sqlite3 *db);
+
+    // Starts recording changes (forgetting ones recorded previously)
+    void begin();
+    // Stops recording, and returns changes committed since begin(). Multiple changes to the same row
+    // are merged (e.g. a row created and then updated is reported as created)
+    std::vector<TableChanges> finish();
+    // Returns changes recorded since begin() or the last takeChanges(), committed or not, and keeps
+    // recording. Used to tell apart changes made in savepoints of one transaction - the caller must
+    // forget changes of a savepoint that was rolled back (sqlite doesn't report that)
+    std::vector<TableChanges> takeChanges();
+    // Returns false if sqlite changed more rows than it reported since begin() (e.g. by truncating a
+    // table), so changes returned by finish() are incomplete. Valid after finish() or takeChanges()
+    bool isComplete() const { return isComplete_; }
+
+    // Changes made until clearCurrentId() are changes of record with this ID. This saves looking up
+    // the ID by rowid (and is the only way to know IDs of deleted rows without the preupdate hook)
+    void setCurrentId(std::string_view id);
+    void clearCurrentId();
+
+private:
+    struct LoggedChange {
+        Operation operation;
+        uint32_t table;
+        sqlite3_int64 rowid;
+        std::string id;
+    };
+
+    sqlite3 *db_;
+    bool isRecording_;
+    bool isComplete_;
+    int totalChangesAtBegin_;
+    size_t reportedCount_; // number of rows reported by sqlite since begin()
+    std::string currentId_;
+    std::vector<std::string> tableNames_;
+    uint32_t lastTable_;
+    std::vector<LoggedChange> log_;
+    size_t committedCount_; // changes in log_ before this index were committed
+
+    uint32_t tableIndex(const char *table);
+    void checkCompleteness();
+    std::vector<TableChanges> mergeCommitted();
+
+    static void onUpdate(void *self, int type, const char *database, const char *table, sqlite3_int64 rowid);
+#ifdef SQLITE_ENABLE_PREUPDATE_HOOK
+    static void onPreupdate(void *self, sqlite3 *db, int type, const char *database, const char *table, sqlite3_int64 oldRowid, sqlite3_int64 newRowid);
+#endif
+    static int onCommit(void *self);
+    static void onRollback(void *self);
+};
+
+} // namespace watermelondb
@@ -0,0 +1,396 @@
+#include "Database.h"
+#include "DatabasePlatform.h"
+#include "JSIHelpers.h"
+
+namespace watermelondb {
+
+using platform::consoleError;
+using platform::consoleLog;
+
+bool Database::canOpenSecondaryConnections() {
+    // NOTE: A separate connection to an in-memory database would see a different database, and with
+    // exclusive locking, other connections can't access the database at all
+    if (usesExclusiveLocking_ || path_ == "" || path_ == ":memory:" || path_.find("mode=memory") != std::string::npos) {
+        return false;
+    }
+    return true;
+}
+
+AsyncReader *Database::asyncReader() {
+    if (!canOpenSecondaryConnections()) {
+        return nullptr;
+    }
+    if (!reader_) {
+        reader_ = std::make_unique<AsyncReader>(path_, asyncReaderConnections_);
+    }
+    return reader_.get();
+}
+
+AsyncWriter *Database::asyncWriter() {
+    if (!canOpenSecondaryConnections()) {
+        return nullptr;
+    }
+    if (!writer_) {
+        writer_ = std::make_unique<AsyncWriter>(path_);
+    }
+    return writer_.get();
+}
+
+void Database::waitForAsyncWrites() {
+    // NOTE: Synchronous writes must not be reordered with async writes enqueued before them
+    if (writer_) {
+        writer_->flush();
+    }
+    applyAsyncCacheChanges();
+}
+
+// Async batches are committed on the writer's connection, but their promises are settled later, on the
+// JS thread. In the meantime, the main connection already sees records they created, so the record cache
+// must be updated right away, or records would be sent to JS as if they were new (making duplicate Models)
+// This keeps the writer from committing while the main connection reads records, and applies cache
+// changes of batches committed until now
+// NOTE: Must be called after DatabaseLock, and not held while waiting for async writes
+std::unique_lock<std::mutex> Database::holdAsyncCommits() {
+    std::unique_lock<std::mutex> lock;
+    if (writer_) {
+        lock = writer_->holdCommits();
+    }
+    applyAsyncCacheChanges();
+    return lock;
+}
+
+void Database::applyAsyncCacheChanges() {
+    std::vector<BatchExecutor::CacheChanges> cacheChanges;
+    {
+        const std::lock_guard<std::mutex> lock(asyncResults_->mutex);
+        cacheChanges.swap(asyncResults_->cacheChanges);
+    }
+    applyCacheChanges(cacheChanges);
+}
+
+std::vector<SqliteValue> Database::argsFromJsi(jsi::Array &arguments) {
+    auto &rt = getRt();
+    std::vector<SqliteValue> args = {};
+
+    for (size_t i = 0, len = arguments.length(rt); i < len; i++) {
+        jsi::Value value = arguments.getValueAtIndex(rt, i);
+
+        if (value.isNull() || value.isUndefined()) {
+            args.push_back({ SqliteValue::Type::null, 0, "" });
+        } else if (value.isString()) {
+            args.push_back({ SqliteValue::Type::text, 0, value.getString(rt).utf8(rt) });
+        } else if (value.isNumber()) {
+            args.push_back({ SqliteValue::Type::number, value.getNumber(), "" });
+        } else if (value.isBool()) {
+            args.push_back({ SqliteValue::Type::number, value.getBool() ? 1.0 : 0.0, "" });
+        } else {
+            throw jsi::JSError(rt, "Invalid argument type for query - only strings, numbers, booleans and null are allowed");
+        }
+    }
+
+    return args;
+}
+
+jsi::Value Database::valueFromSqlite(const SqliteValue &value) {
+    auto &rt = getRt();
+    if (value.type == SqliteValue::Type::number) {
+        return jsi::Value(value.number);
+    } else if (value.type == SqliteValue::Type::text) {
+        return jsi::String::createFromUtf8(rt, value.text);
+    }
+    return jsi::Value::null();
+}
+
+bool Database::canRunAsync() {
+    // NOTE: Results of async operations are passed back via the JS thread. If that failed before (or
+    // can't be done at all on this platform), we'd better fall back to doing things synchronously
+    return asyncResults_->canRunOnJsThread && platform::canRunOnJsThread();
+}
+
+jsi::Value Database::makePromise(std::function<void(int promiseId)> start) {
+    auto &rt = getRt();
+    auto promiseConstructor = rt.global().getPropertyAsFunction(rt, "Promise");
+    int promiseId = nextPromiseId_++;
+
+    // NOTE: Executor is called synchronously by the Promise constructor, so it's safe to capture `this`
+    auto executor = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forAscii(rt, "executor"), 2,
+                                                          [this, promiseId, start = std::move(start)]
+                                                          (jsi::Runtime &rt, const jsi::Value &, const jsi::Value *promiseArgs, size_t) {
+        pendingPromises_.emplace(promiseId, PendingPromise {
+            promiseArgs[0].getObject(rt).getFunction(rt),
+            promiseArgs[1].getObject(rt).getFunction(rt),
+        });
+
+        try {
+            start(promiseId);
+        } catch (const std::exception &ex) {
+            std::string error = ex.what();
+            settlePromise(promiseId, [&]() -> jsi::Value {
+                throw jsi::JSError(rt, error);
+            });
+        }
+
+        return jsi::Value::undefined();
+    });
+
+    return promiseConstructor.callAsConstructor(rt, executor);
+}
+
+void Database::settlePromise(int promiseId, std::function<jsi::Value(void)> getResult) {
+    auto &rt = getRt();
+
+    auto promiseSearch = pendingPromises_.find(promiseId);
+    if (promiseSearch == pendingPromises_.end()) {
+        return;
+    }
+    auto promise = std::move(promiseSearch->second);
+    pendingPromises_.erase(promiseSearch);
+
+    jsi::Value result;
+    try {
+        result = getResult();
+    } catch (const jsi::JSError &error) {
+        promise.reject.call(rt, makeError(rt, error.getMessage()));
+        return;
+    } catch (const std::exception &ex) {
+        promise.reject.call(rt, makeError(rt, ex.what()));
+        return;
+    }
+
+    promise.resolve.call(rt, result);
+}
+
+void Database::postAsyncResult(std::weak_ptr<Database> weakSelf, std::shared_ptr<AsyncResults> results, AsyncResults::Result result) {
+    {
+        const std::lock_guard<std::mutex> lock(results->mutex);
+        results->pending.push_back(std::move(result));
+    }
+
+    // NOTE: Only a weak reference to the Database is passed around, so that if JS let go of it in the
+    // meantime, it's destroyed on the JS thread, and not on the worker thread (which it would try to join)
+    bool isScheduled = platform::runOnJsThread([weakSelf]() {
+        if (auto self = weakSelf.lock()) {
+            self->settleAsyncResults();
+        }
+    });
+
+    if (!isScheduled) {
+        // NOTE: This result will be passed back at the beginning of the next async call (which will run
+        // synchronously from now on)
+        consoleError("Failed to pass async result back to JS thread - falling back to synchronous mode");
+        results->canRunOnJsThread = false;
+    }
+}
+
+void Database::settleAsyncResults() {
+    std::vector<AsyncResults::Result> results;
+    {
+        const std::lock_guard<std::mutex> lock(asyncResults_->mutex);
+        results.swap(asyncResults_->pending);
+    }
+
+    for (auto &result : results) {
+        result(*this);
+    }
+}
+
+jsi::Value Database::queryAsync(AsyncQueryType type, jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
+    auto &rt = getRt();
+    settleAsyncResults();
+
+    AsyncReader *reader = nullptr;
+    {
+        const DatabaseLock lock(*this);
+        if (isDestroyed_) {
+            throw jsi::JSError(rt, "Database is closed");
+        }
+        reader = canRunAsync() ? asyncReader() : nullptr;
+    }
+
+    if (!reader) {
+        // Fall back to querying synchronously
+        jsi::Value result;
+        if (type == AsyncQueryType::query) {
+            result = query(tableName, sql, arguments);
+        } else if (type == AsyncQueryType::queryIds) {
+            result = queryIds(sql, arguments);
+        } else if (type == AsyncQueryType::unsafeQueryRaw) {
+            result = unsafeQueryRaw(sql, arguments);
+        } else {
+            result = count(sql, arguments);
+        }
+        auto promiseConstructor = rt.global().getPropertyAsFunction(rt, "Promise");
+        return promiseConstructor.getPropertyAsFunction(rt, "resolve").callWithThis(rt, promiseConstructor, &result, 1);
+    }
+
+    auto table = tableName.utf8(rt);
+    auto sqlStr = sql.utf8(rt);
+    auto args = argsFromJsi(arguments);
+    std::weak_ptr<Database> weakSelf = shared_from_this();
+    auto results = asyncResults_;
+
+    // NOTE: The query will read from a snapshot taken later on, on another thread. Records removed from the
+    // cache from now on must not be cached again from its results (see asyncQueryResult)
+    uint64_t removalsMark = 0;
+    if (type == AsyncQueryType::query) {
+        const DatabaseLock lock(*this);
+        removalsMark = recordCache_.trackRemovals();
+    }
+
+    return makePromise([=](int promiseId) {
+        try {
+            reader->run([=](AsyncReader::Connection &connection) {
+                auto rows = std::make_shared<SqliteRows>();
+                std::string error = "";
+                try {
+                    *rows = connection.query(sqlStr, args);
+                } catch (const std::exception &ex) {
+                    error = ex.what();
+                }
+
+                // NOTE: JSI values must only be touched on the JS thread, so results are converted there
+                postAsyncResult(weakSelf, results, [promiseId, type, table, rows, error, removalsMark](Database &database) {
+                    database.settlePromise(promiseId, [&]() {
+                        return database.asyncQueryResult(type, table, *rows, error, removalsMark);
+                    });
+                });
+            });
+        } catch (const std::exception &ex) {
+            if (type == AsyncQueryType::query) {
+                const DatabaseLock lock(*this);
+                recordCache_.untrackRemovals();
+            }
+            throw;
+        }
+    });
+}
+
+jsi::Value Database::asyncQueryResult(AsyncQueryType type, const std::string &table, SqliteRows &rows, const std::string &error, uint64_t removalsMark) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+    if (type == AsyncQueryType::query) {
+        // NOTE: Removals recorded until now can still be checked (see RecordCache::trackRemovals)
+        recordCache_.untrackRemovals();
+    }
+
+    if (isDestroyed_) {
+        throw jsi::JSError(rt, "Database was closed before query could complete");
+    } else if (!error.empty()) {
+        throw jsi::JSError(rt, error);
+    }
+
+    if (type == AsyncQueryType::count) {
+        if (rows.rows.size() != 1 || rows.rows[0].size() != 1) {
+            throw jsi::JSError(rt, "Failed to get a row for query");
+        }
+        return jsi::Value(rows.rows[0][0].number);
+    }
+
+    bool hasIds = type == AsyncQueryType::query || type == AsyncQueryType::queryIds;
+    if (hasIds && !rows.columnNames.empty()) {
+        assert(rows.columnNames[0] == "id");
+    }
+
+    auto cachedIds = type == AsyncQueryType::query ? &recordCache_.table(table) : nullptr;
+    std::vector<jsi::PropNameID> columnNames;
+    for (auto const &column : rows.columnNames) {
+        columnNames.push_back(jsi::PropNameID::forUtf8(rt, column));
+    }
+
+    jsi::Array results(rt, rows.rows.size());
+    for (size_t i = 0; i < rows.rows.size(); i++) {
+        auto &row = rows.rows[i];
+
+        if (hasIds) {
+            if (row.empty() || row[0].type != SqliteValue::Type::text) {
+                throw jsi::JSError(rt, "Failed to get ID of a record");
+            }
+            auto &id = row[0].text;
+
+            if (type == AsyncQueryType::queryIds || cachedIds->contains(id)) {
+                results.setValueAtIndex(rt, i, jsi::String::createFromUtf8(rt, id));
+                continue;
+            }
+            // NOTE: A record removed since the query was started (e.g. destroyed by a batch) could still be
+            // in its results. It's sent to JS in full, but must not be cached again
+            if (!cachedIds->wasRemovedSince(id, removalsMark)) {
+                cachedIds->insert(id);
+            }
+        }
+
+        jsi::Object record(rt);
+        for (size_t j = 0; j < row.size(); j++) {
+            record.setProperty(rt, columnNames[j], valueFromSqlite(row[j]));
+        }
+        results.setValueAtIndex(rt, i, std::move(record));
+    }
+    return results;
+}
+
+jsi::Value Database::batchJSONAsync(jsi::String &&operationsJson) {
+    auto &rt = getRt();
+    settleAsyncResults();
+
+    AsyncWriter *writer = nullptr;
+    {
+        const DatabaseLock lock(*this);
+        if (isDestroyed_) {
+            throw jsi::JSError(rt, "Database is closed");
+        }
+        writer = canRunAsync() ? asyncWriter() : nullptr;
+    }
+
+    if (!writer) {
+        // Fall back to writing synchronously
+        auto changes = batchJSON(std::move(operationsJson));
+        auto promiseConstructor = rt.global().getPropertyAsFunction(rt, "Promise");
+        return promiseConstructor.getPropertyAsFunction(rt, "resolve").callWithThis(rt, promiseConstructor, changes);
+    }
+
+    auto json = std::make_shared<std::string>(operationsJson.utf8(rt));
+    std::weak_ptr<Database> weakSelf = shared_from_this();
+    auto results = asyncResults_;
+
+    return makePromise([=](int promiseId) {
+        writer->enqueue(std::move(*json), [=](AsyncWriter::BatchResult result) {
+            // NOTE: Called while the writer holds commits, so cache changes are queued before the main
+            // connection can read records of this batch (see holdAsyncCommits). Batches are committed in
+            // order, so cache changes are applied in order as well
+            {
+                const std::lock_guard<std::mutex> lock(results->mutex);
+                for (auto &changes : result.cacheChanges) {
+                    results->cacheChanges.push_back(std::move(changes));
+                }
+            }
+            auto sharedResult = std::make_shared<AsyncWriter::BatchResult>(std::move(result));
+            postAsyncResult(weakSelf, results, [promiseId, sharedResult](Database &database) {
+                database.settlePromise(promiseId, [&]() {
+                    return database.asyncBatchResult(*sharedResult);
+                });
+            });
+        });
+    });
+}
+
+jsi::Value Database::asyncBatchResult(AsyncWriter::BatchResult &result) {
+    auto &rt = getRt();
+
+    if (!result.error.empty()) {
+        throw jsi::JSError(rt, result.error);
+    }
+
+    const DatabaseLock lock(*this);
+    // NOTE: If the database was closed in the meantime, the batch is still committed, but there's no
+    // cache to update
+    if (isDestroyed_) {
+        return jsi::Value::undefined();
+    }
+    // NOTE: Cache changes of this batch may not have been applied yet
+    applyAsyncCacheChanges();
+    // Same as changes returned by a synchronous batch. NOTE: IDs of changed rows that weren't reported by
+    // the writer are looked up on this connection, which sees the batch, as it's already committed
+    return resolveChanges(result.changes, result.isComplete);
+}
+
+} // namespace watermelondb
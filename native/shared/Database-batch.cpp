@@ -1,124 +1,268 @@
 #include "Database.h"
+#include <algorithm>
+#include <deque>
+#include <optional>
 
 namespace watermelondb {
 
 using platform::consoleError;
 using platform::consoleLog;
 
-// TODO: Remove non-json batch once we can tell that there's no serious perf regression
-void Database::batch(jsi::Array &operations) {
+// Returns changes recorded since changeFeed_.begin() - see resolveChanges
+// NOTE: Must be called after the write is committed
+jsi::Value Database::finishChangeFeed() {
+    auto tableChanges = changeFeed_.finish();
+    return resolveChanges(tableChanges, changeFeed_.isComplete());
+}
+
+// Returns changes recorded by a ChangeFeed (of this or another connection) as
+// `{ table: { created, updated, destroyed } }` (arrays of record IDs), and notes them for query
+// observers. Tables that don't hold records (without an `id` column) are skipped
+// NOTE: Must be called after the write is committed
+jsi::Value Database::resolveChanges(std::vector<ChangeFeed::TableChanges> &tableChanges, bool isComplete) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
-    beginTransaction();
+    jsi::Object result(rt);
 
-    std::vector<std::string> addedIds = {};
-    std::vector<std::string> removedIds = {};
+    for (auto &table : tableChanges) {
+        bool isCached;
+        auto findIdStmt = statementCache_.prepare(db_->sqlite, "select `id` from `" + table.table + "` where rowid = ?", isCached);
+        if (!findIdStmt) {
+            continue;
+        }
+        SqliteStatement findIdStatement(findIdStmt, &statementCache_);
+        auto &cachedIds = recordCache_.table(table.table);
 
-    try {
-        size_t operationsCount = operations.length(rt);
-        for (size_t i = 0; i < operationsCount; i++) {
-            jsi::Array operation = operations.getValueAtIndex(rt, i).getObject(rt).getArray(rt);
-
-            auto cacheBehavior = operation.getValueAtIndex(rt, 0).getNumber();
-            auto table = cacheBehavior != 0 ? operation.getValueAtIndex(rt, 1).getString(rt).utf8(rt) : "";
-            auto sql = operation.getValueAtIndex(rt, 2).getString(rt).utf8(rt);
-
-            jsi::Array argsBatches = operation.getValueAtIndex(rt, 3).getObject(rt).getArray(rt);
-            size_t argsBatchesCount = argsBatches.length(rt);
-            for (size_t j = 0; j < argsBatchesCount; j++) {
-                jsi::Array args = argsBatches.getValueAtIndex(rt, j).getObject(rt).getArray(rt);
-                executeUpdate(sql, args);
-                if (cacheBehavior != 0) {
-                    auto id = args.getValueAtIndex(rt, 0).getString(rt).utf8(rt);
-                    if (cacheBehavior == 1) {
-                        addedIds.push_back(cacheKey(table, id));
-                    } else if (cacheBehavior == -1) {
-                        removedIds.push_back(cacheKey(table, id));
-                    }
+        std::vector<jsi::Value> createdIds;
+        std::vector<jsi::Value> updatedIds;
+        std::vector<std::string> destroyedIds;
+        size_t unknownDestroyedCount = 0;
+
+        for (auto &change : table.changes) {
+            if (change.operation == ChangeFeed::Operation::destroyed) {
+                if (change.id.empty()) {
+                    unknownDestroyedCount++;
+                } else {
+                    destroyedIds.push_back(std::move(change.id));
                 }
+                continue;
             }
 
+            if (change.id.empty()) {
+                sqlite3_bind_int64(findIdStmt, 1, change.rowid);
+                if (!getNextRowOrTrue(findIdStmt) && sqlite3_column_type(findIdStmt, 0) == SQLITE_TEXT) {
+                    change.id = std::string((const char *) sqlite3_column_text(findIdStmt, 0), sqlite3_column_bytes(findIdStmt, 0));
+                }
+                sqlite3_reset(findIdStmt);
+                if (change.id.empty()) {
+                    continue;
+                }
+            }
+            auto id = jsi::String::createFromUtf8(rt, change.id);
+            (change.operation == ChangeFeed::Operation::created ? createdIds : updatedIds).push_back(std::move(id));
         }
-        commit();
-    } catch (const std::exception &ex) {
-        rollback();
-        throw;
-    }
 
-    for (auto const &key : addedIds) {
-        markAsCached(key);
+        // Without the preupdate hook (see ChangeFeed), rows deleted by raw SQL can't be traced back to
+        // IDs. The ones that matter are those known to JS, so we check which of them no longer exist,
+        // unless that's much more work than the delete itself. Then, the table's cache is forgotten
+        // instead (cached records will be sent to JS in full once again)
+        bool hasUnknownDestroyedIds = unknownDestroyedCount > 0;
+        if (hasUnknownDestroyedIds && cachedIds.size() > std::max<size_t>(256, 16 * unknownDestroyedCount)) {
+            cachedIds.clear();
+        } else if (hasUnknownDestroyedIds && cachedIds.size()) {
+            auto existsStmt = prepareQuery("select 1 from `" + table.table + "` where `id` is ?");
+            SqliteStatement existsStatement(existsStmt, &statementCache_);
+            std::vector<std::string> candidates;
+            cachedIds.forEach([&](const std::string &id) {
+                candidates.push_back(id);
+            });
+            for (auto &id : candidates) {
+                sqlite3_bind_text(existsStmt, 1, id.c_str(), (int) id.length(), SQLITE_STATIC);
+                bool exists = !getNextRowOrTrue(existsStmt);
+                sqlite3_reset(existsStmt);
+                if (!exists) {
+                    destroyedIds.push_back(std::move(id));
+                }
+            }
+        }
+
+        std::vector<jsi::Value> destroyed;
+        for (auto const &id : destroyedIds) {
+            cachedIds.erase(id);
+            destroyed.push_back(jsi::String::createFromUtf8(rt, id));
+        }
+
+        if (hasUnknownDestroyedIds) {
+            // NOTE: Records that aren't cached (but could still be in observed results) could have been
+            // destroyed, too, and we don't know which
+            queryObservers_.invalidateTable(table.table);
+        } else if (!queryObservers_.empty()) {
+            std::vector<std::string> changedIds = std::move(destroyedIds);
+            for (auto &change : table.changes) {
+                if (change.operation != ChangeFeed::Operation::destroyed && !change.id.empty()) {
+                    changedIds.push_back(std::move(change.id));
+                }
+            }
+            queryObservers_.recordChanges(table.table, changedIds);
+        }
+
+        jsi::Object tableResult(rt);
+        tableResult.setProperty(rt, "created", arrayFromStd(createdIds));
+        tableResult.setProperty(rt, "updated", arrayFromStd(updatedIds));
+        tableResult.setProperty(rt, "destroyed", arrayFromStd(destroyed));
+        result.setProperty(rt, jsi::String::createFromUtf8(rt, table.table), std::move(tableResult));
     }
 
-    for (auto const &key : removedIds) {
-        removeFromCache(key);
+    if (!isComplete) {
+        // NOTE: We don't know which tables were changed without being reported
+        queryObservers_.invalidateAll();
     }
+    return result;
 }
 
-void Database::batchJSON(jsi::String &&jsiJson) {
-    using namespace simdjson;
+namespace {
 
-    auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
-    beginTransaction();
+// Reads batches passed as a JSI array of operations (see BatchReader)
+class JsiBatchReader : public BatchReader {
+public:
+    JsiBatchReader(jsi::Runtime &rt, jsi::Array &operations)
+        : rt_(rt), operations_(operations), operationIdx_(0), operationsCount_(operations.length(rt)), rowIdx_(0) {}
 
-    std::vector<std::string> addedIds = {};
-    std::vector<std::string> removedIds = {};
+    bool nextOperation(BatchOperation &operation) override {
+        auto &rt = rt_;
+        if (operationIdx_ >= operationsCount_) {
+            return false;
+        }
+        jsi::Array fields = operations_.getValueAtIndex(rt, operationIdx_++).getObject(rt).getArray(rt);
+        // NOTE: Values read before are no longer needed
+        strings_.clear();
 
-    try {
-        ondemand::parser parser;
-        auto json = padded_string(jsiJson.utf8(rt));
-        ondemand::document doc = parser.iterate(json);
-
-        // NOTE: simdjson::ondemand processes forwards-only, hence the weird field enumeration
-        // We can't use subscript or backtrack.
-        for (ondemand::array operation : doc) {
-            int64_t cacheBehavior = 0;
-            std::string table;
-            std::string sql;
-            size_t fieldIdx = 0;
-            for (auto field : operation) {
-                if (fieldIdx == 0) {
-                    cacheBehavior = field;
-                } else if (fieldIdx == 1) {
-                    if (cacheBehavior != 0) {
-                        table = (std::string_view) field;
-                    }
-                } else if (fieldIdx == 2) {
-                    sql = (std::string_view) field;
-                } else if (fieldIdx == 3) {
-                    ondemand::array argsBatches = field;
-                    auto stmt = prepareQuery(sql);
-                    SqliteStatement statement(stmt);
-
-                    for (ondemand::array args : argsBatches) {
-                        // NOTE: We must capture the ID once first parsed
-                        auto id = bindArgsAndReturnId(stmt, args);
-                        executeUpdate(stmt);
-                        sqlite3_reset(stmt);
-                        if (cacheBehavior == 1) {
-                            addedIds.push_back(cacheKey(table, id));
-                        } else if (cacheBehavior == -1) {
-                            removedIds.push_back(cacheKey(table, id));
-                        }
-                    }
-                }
-                fieldIdx++;
+        operation.cacheBehavior = (int) fields.getValueAtIndex(rt, 0).getNumber();
+        auto table = fields.getValueAtIndex(rt, 1);
+        operation.table = table.isString() ? ownString(table.getString(rt).utf8(rt)) : std::string_view();
+        operation.sql = {};
+        operation.columns.clear();
+
+        auto sqlOrColumns = fields.getValueAtIndex(rt, 2);
+        if (sqlOrColumns.isObject()) {
+            // Partial update - list of columns to set instead of SQL
+            auto columns = sqlOrColumns.getObject(rt).getArray(rt);
+            for (size_t i = 0, len = columns.length(rt); i < len; i++) {
+                operation.columns.push_back(ownString(columns.getValueAtIndex(rt, i).getString(rt).utf8(rt)));
+            }
+        } else {
+            operation.sql = ownString(sqlOrColumns.getString(rt).utf8(rt));
+        }
+
+        rows_.emplace(fields.getValueAtIndex(rt, 3).getObject(rt).getArray(rt));
+        rowIdx_ = 0;
+        operation.rowCount = rows_->length(rt);
+        return true;
+    }
+
+    void nextRow(std::vector<BatchValue> &args) override {
+        auto &rt = rt_;
+        args.clear();
+        jsi::Array row = rows_->getValueAtIndex(rt, rowIdx_++).getObject(rt).getArray(rt);
+        for (size_t i = 0, len = row.length(rt); i < len; i++) {
+            jsi::Value value = row.getValueAtIndex(rt, i);
+
+            if (value.isNull() || value.isUndefined()) {
+                args.push_back({ BatchValue::Type::null, 0, {}, false });
+            } else if (value.isString()) {
+                args.push_back({ BatchValue::Type::string, 0, ownString(value.getString(rt).utf8(rt)), false });
+            } else if (value.isNumber()) {
+                args.push_back({ BatchValue::Type::number, value.getNumber(), {}, false });
+            } else if (value.isBool()) {
+                args.push_back({ BatchValue::Type::boolean, 0, {}, value.getBool() });
+            } else if (value.isObject()) {
+                throw jsi::JSError(rt, "Invalid argument type (object) for query");
+            } else {
+                throw jsi::JSError(rt, "Invalid argument type (unknown) for query");
             }
         }
+    }
+
+private:
+    jsi::Runtime &rt_;
+    jsi::Array &operations_;
+    size_t operationIdx_;
+    size_t operationsCount_;
+    std::optional<jsi::Array> rows_;
+    size_t rowIdx_;
+    // NOTE: A deque, so that views of strings stay valid as more are added
+    std::deque<std::string> strings_;
+
+    std::string_view ownString(std::string &&string) {
+        strings_.push_back(std::move(string));
+        return strings_.back();
+    }
+};
+
+}
+
+// Executes a batch in a transaction on the main connection, applies its changes to the record cache, and
+// returns changes made (see resolveChanges)
+jsi::Value Database::executeBatch(std::function<std::vector<BatchExecutor::CacheChanges>(BatchExecutor &executor)> execute) {
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
+    changeFeed_.begin();
+    beginTransaction();
 
+    std::vector<BatchExecutor::CacheChanges> cacheChanges;
+    try {
+        BatchExecutor executor(db_->sqlite, statementCache_, partialUpdateSql_, multiRowInsertSql_, changeFeed_);
+        cacheChanges = execute(executor);
         commit();
     } catch (const std::exception &ex) {
         rollback();
+        changeFeed_.finish();
         throw;
     }
 
-    for (auto const &key : addedIds) {
-        markAsCached(key);
-    }
+    applyCacheChanges(cacheChanges);
+    return finishChangeFeed();
+}
 
-    for (auto const &key : removedIds) {
-        removeFromCache(key);
+// NOTE: Must be called after the batch is committed
+void Database::applyCacheChanges(const std::vector<BatchExecutor::CacheChanges> &cacheChanges) {
+    for (auto const &changes : cacheChanges) {
+        auto &cachedIds = recordCache_.table(changes.table);
+        for (auto const &id : changes.ids) {
+            if (changes.isRemoved) {
+                cachedIds.erase(id);
+            } else {
+                cachedIds.insert(id);
+            }
+        }
     }
 }
 
+// TODO: Remove non-json batch once we can tell that there's no serious perf regression
+jsi::Value Database::batch(jsi::Array &operations) {
+    auto &rt = getRt();
+    JsiBatchReader reader(rt, operations);
+    return executeBatch([&](BatchExecutor &executor) {
+        return executor.execute(reader);
+    });
+}
+
+jsi::Value Database::batchJSON(jsi::String &&jsiJson) {
+    auto &rt = getRt();
+    auto json = jsiJson.utf8(rt);
+    return executeBatch([&](BatchExecutor &executor) {
+        return executor.executeJSON(json);
+    });
+}
+
+jsi::Value Database::batchBinary(jsi::ArrayBuffer &buffer) {
+    auto &rt = getRt();
+    // NOTE: Reading straight from JS memory. The buffer is kept alive by the caller, and can't be
+    // modified while we're in native code
+    auto data = buffer.data(rt);
+    auto size = buffer.size(rt);
+    return executeBatch([&](BatchExecutor &executor) {
+        return executor.executeBinary(data, size);
+    });
+}
+
 }
@@ -0,0 +1,207 @@
+#include "Database.h"
+#include "DatabasePlatform.h"
+#include "JSIHelpers.h"
+
+namespace watermelondb {
+
+using platform::consoleError;
+using platform::consoleLog;
+
+std::shared_ptr<QueryCursor> Database::queryCursor(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+
+    // NOTE: Not using prepareQuery, because cached statements can't be left mid-execution - the same query
+    // may be executed again before the cursor is exhausted
+    sqlite3_stmt *statement = nullptr;
+    auto sqlStr = sql.utf8(rt);
+    int resultPrepare = sqlite3_prepare_v2(db_->sqlite, sqlStr.c_str(), -1, &statement, nullptr);
+
+    if (resultPrepare != SQLITE_OK) {
+        sqlite3_finalize(statement);
+        throw dbError("Failed to prepare query statement");
+    }
+
+    try {
+        bindArgs(statement, arguments);
+    } catch (const std::exception &ex) {
+        sqlite3_finalize(statement);
+        throw;
+    }
+
+    auto cursor = std::make_shared<QueryCursor>(shared_from_this(), tableName.utf8(rt), statement);
+    std::lock_guard<std::mutex> cursorsLock(cursorsMutex_);
+    openCursors_.insert(cursor.get());
+    return cursor;
+}
+
+jsi::Array Database::cursorNext(QueryCursor &cursor, size_t count) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+
+    std::vector<jsi::Value> records = {};
+    if (!cursor.stmt_) {
+        return arrayFromStd(records);
+    }
+
+    auto statement = cursor.stmt_;
+    auto cachedIds = cursor.tableName_.empty() ? nullptr : &recordCache_.table(cursor.tableName_);
+    std::optional<ResultShape> shape;
+
+    while (records.size() < count) {
+        if (getNextRowOrTrue(statement)) {
+            finalizeCursor(cursor);
+            break;
+        }
+
+        if (!shape) {
+            shape.emplace(resultShape(statement));
+        }
+
+        if (!cachedIds) {
+            records.push_back(resultDictionary(statement, *shape));
+            continue;
+        }
+
+        assert(std::string(sqlite3_column_name(statement, 0)) == "id");
+
+        const char *id = (const char *)sqlite3_column_text(statement, 0);
+        if (!id) {
+            throw jsi::JSError(rt, "Failed to get ID of a record");
+        }
+        std::string_view idView(id, sqlite3_column_bytes(statement, 0));
+
+        if (cachedIds->contains(idView)) {
+            jsi::String jsiId = jsi::String::createFromAscii(rt, id);
+            records.push_back(std::move(jsiId));
+        } else {
+            cachedIds->insert(idView);
+            jsi::Object record = resultDictionary(statement, *shape);
+            records.push_back(std::move(record));
+        }
+    }
+
+    return arrayFromStd(records);
+}
+
+void Database::closeCursor(QueryCursor &cursor) {
+    const DatabaseLock lock(*this);
+    finalizeCursor(cursor);
+}
+
+void Database::finalizeCursor(QueryCursor &cursor) {
+    sqlite3_stmt *statement = nullptr;
+    {
+        std::lock_guard<std::mutex> cursorsLock(cursorsMutex_);
+        std::swap(statement, cursor.stmt_);
+        openCursors_.erase(&cursor);
+    }
+    if (statement) {
+        finalizeCursorStatement(statement);
+    }
+}
+
+void Database::finalizeCursorStatement(sqlite3_stmt *statement) {
+    resultShapes_.erase(statement);
+    sqlite3_finalize(statement);
+}
+
+void Database::finalizeAbandonedCursors() {
+    std::vector<sqlite3_stmt *> statements = {};
+    {
+        std::lock_guard<std::mutex> cursorsLock(cursorsMutex_);
+        if (abandonedCursorStatements_.empty()) {
+            return;
+        }
+        std::swap(statements, abandonedCursorStatements_);
+    }
+    for (auto statement : statements) {
+        finalizeCursorStatement(statement);
+    }
+}
+
+void Database::finalizeAllCursors() {
+    finalizeAbandonedCursors();
+
+    std::vector<sqlite3_stmt *> statements = {};
+    {
+        std::lock_guard<std::mutex> cursorsLock(cursorsMutex_);
+        for (auto cursor : openCursors_) {
+            statements.push_back(cursor->stmt_);
+            cursor->stmt_ = nullptr;
+        }
+        openCursors_.clear();
+    }
+    for (auto statement : statements) {
+        finalizeCursorStatement(statement);
+    }
+}
+
+QueryCursor::QueryCursor(std::weak_ptr<Database> database, std::string tableName, sqlite3_stmt *statement)
+    : database_(database), tableName_(tableName), stmt_(statement) {
+}
+
+QueryCursor::~QueryCursor() {
+    // NOTE: Destructor is called by JS GC, which may happen while allocating JSI values inside another
+    // Database call (with mutex_ held by this thread, and a statement mid-execution), so it's not safe to
+    // touch sqlite here. The statement is finalized at the start of the next Database call instead
+    auto database = database_.lock();
+    if (!database) {
+        // NOTE: Database finalizes statements of open cursors when it's destroyed
+        return;
+    }
+    std::lock_guard<std::mutex> cursorsLock(database->cursorsMutex_);
+    if (stmt_) {
+        database->openCursors_.erase(this);
+        database->abandonedCursorStatements_.push_back(stmt_);
+        stmt_ = nullptr;
+    }
+}
+
+std::shared_ptr<Database> QueryCursor::database(jsi::Runtime &rt) {
+    auto database = database_.lock();
+    if (!database) {
+        throw jsi::JSError(rt, "Database is closed");
+    }
+    return database;
+}
+
+jsi::Value QueryCursor::get(jsi::Runtime &runtime, const jsi::PropNameID &name) {
+    auto methodName = name.utf8(runtime);
+    std::shared_ptr<QueryCursor> cursor = shared_from_this();
+
+    if (methodName == "next") {
+        return jsi::Function::createFromHostFunction(runtime, name, 1, [cursor]
+                                                     (jsi::Runtime &rt, const jsi::Value &, const jsi::Value *args, size_t count) {
+            return runBlock(rt, [&]() -> jsi::Value {
+                if (count != 1 || !args[0].isNumber() || args[0].getNumber() < 1) {
+                    throw jsi::JSError(rt, "next takes 1 argument - a positive number of rows");
+                }
+                return cursor->database(rt)->cursorNext(*cursor, (size_t) args[0].getNumber());
+            });
+        });
+    } else if (methodName == "close") {
+        return jsi::Function::createFromHostFunction(runtime, name, 0, [cursor]
+                                                     (jsi::Runtime &rt, const jsi::Value &, const jsi::Value *, size_t) {
+            return runBlock(rt, [&]() {
+                // NOTE: If the Database is gone, the statement was already finalized
+                if (auto database = cursor->database_.lock()) {
+                    database->closeCursor(*cursor);
+                }
+                return jsi::Value::undefined();
+            });
+        });
+    }
+
+    return jsi::Value::undefined();
+}
+
+std::vector<jsi::PropNameID> QueryCursor::getPropertyNames(jsi::Runtime &rt) {
+    std::vector<jsi::PropNameID> names;
+    names.push_back(jsi::PropNameID::forAscii(rt, "next"));
+    names.push_back(jsi::PropNameID::forAscii(rt, "close"));
+    return names;
+}
+
+} // namespace watermelondb
@@ -5,6 +5,20 @@ namespace watermelondb {
 using platform::consoleError;
 using platform::consoleLog;
 
+DatabaseLock::DatabaseLock(Database &database) : database_(database) {
+    if (database_.lockingThread_.load() == std::this_thread::get_id()) {
+        throw jsi::JSError(database_.getRt(), "Database can't be used while another call to it is in progress (e.g. from a sync progress callback)");
+    }
+    database_.mutex_.lock();
+    database_.lockingThread_ = std::this_thread::get_id();
+    database_.finalizeAbandonedCursors();
+}
+
+DatabaseLock::~DatabaseLock() {
+    database_.lockingThread_ = std::thread::id();
+    database_.mutex_.unlock();
+}
+
 jsi::Runtime &Database::getRt() {
     return *runtime_;
 }
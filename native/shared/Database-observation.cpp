@@ -0,0 +1,421 @@
+#include "Database.h"
+#include "JSIHelpers.h"
+#include <cmath>
+
+namespace watermelondb {
+
+using platform::consoleError;
+using platform::consoleLog;
+
+// NOTE: To keep the number of distinct cached statements low, changed records are checked in chunks of
+// one of these sizes, padded with a duplicate id if needed
+static const size_t observerCheckChunkSizes[] = { 1, 8, 64, 256 };
+
+jsi::Value Database::observeQuery(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments, jsi::Array &tables, bool isIncremental, const jsi::Value &conditions) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+
+    QueryObservers::Observer observer;
+    observer.table = tableName.utf8(rt);
+    observer.sql = sql.utf8(rt);
+    observer.arguments = argsFromJsi(arguments);
+    for (size_t i = 0, len = tables.length(rt); i < len; i++) {
+        observer.tables.push_back(tables.getValueAtIndex(rt, i).getString(rt).utf8(rt));
+    }
+    observer.isIncremental = isIncremental;
+    observer.isStale = false;
+    if (isIncremental && conditions.isObject()) {
+        auto conditionsArray = conditions.getObject(rt).getArray(rt);
+        auto matcher = std::make_unique<QueryMatcher>();
+        if (decodeQueryMatcher(conditionsArray, *matcher)) {
+            observer.matcher = std::move(matcher);
+        }
+    }
+
+    auto records = fetchObservedQuery(observer, observer.ids);
+    auto &cachedIds = recordCache_.table(observer.table);
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].isObject()) {
+            cachedIds.insert(observer.ids[i]);
+        }
+    }
+    if (isIncremental) {
+        observer.idSet.insert(observer.ids.begin(), observer.ids.end());
+        observer.ids.clear();
+    }
+
+    int observerId = queryObservers_.add(std::move(observer));
+    return jsi::Array::createWithElements(rt, jsi::Value(observerId), arrayFromStd(records));
+}
+
+void Database::unobserveQuery(int observerId) {
+    const DatabaseLock lock(*this);
+    queryObservers_.remove(observerId);
+}
+
+// Compiles `where` conditions of a QueryDescription. Returns false if some can't be checked natively
+bool Database::decodeQueryMatcher(jsi::Array &conditions, QueryMatcher &matcher) {
+    auto &rt = getRt();
+    std::vector<QueryMatcher::Condition> decoded = {};
+
+    for (size_t i = 0, len = conditions.size(rt); i < len; i++) {
+        auto where = conditions.getValueAtIndex(rt, i).getObject(rt);
+        QueryMatcher::Condition condition;
+        if (!decodeMatcherCondition(where, matcher, condition)) {
+            return false;
+        }
+        decoded.push_back(std::move(condition));
+    }
+
+    matcher.setConditions(std::move(decoded));
+    return true;
+}
+
+// Same as encodeValue (in JS)
+static bool decodeMatcherValue(jsi::Runtime &rt, const jsi::Value &value, QueryMatcher::Value &decoded) {
+    using Type = QueryMatcher::Value::Type;
+    if (value.isNull() || value.isUndefined()) {
+        decoded.type = Type::null;
+    } else if (value.isBool()) {
+        decoded.type = Type::number;
+        decoded.number = value.getBool() ? 1 : 0;
+    } else if (value.isNumber()) {
+        decoded.number = value.getNumber();
+        decoded.type = std::isnan(decoded.number) ? Type::null : Type::number;
+    } else if (value.isString()) {
+        decoded.type = Type::text;
+        decoded.text = value.getString(rt).utf8(rt);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Database::decodeMatcherCondition(jsi::Object &where, QueryMatcher &matcher, QueryMatcher::Condition &condition) {
+    using Operator = QueryMatcher::Operator;
+    using Type = QueryMatcher::Condition::Type;
+    auto &rt = getRt();
+    auto type = where.getProperty(rt, "type").getString(rt).utf8(rt);
+
+    if (type == "and" || type == "or") {
+        condition.type = type == "and" ? Type::allOf : Type::anyOf;
+        auto conditions = where.getProperty(rt, "conditions").getObject(rt).getArray(rt);
+        for (size_t i = 0, len = conditions.size(rt); i < len; i++) {
+            auto subwhere = conditions.getValueAtIndex(rt, i).getObject(rt);
+            QueryMatcher::Condition subcondition;
+            if (!decodeMatcherCondition(subwhere, matcher, subcondition)) {
+                return false;
+            }
+            condition.conditions.push_back(std::move(subcondition));
+        }
+        return true;
+    } else if (type != "where") {
+        // (Q.on, Q.unsafeSqlExpr, Q.unsafeLokiExpr)
+        return false;
+    }
+
+    condition.type = Type::comparison;
+    condition.leftColumn = matcher.addColumn(where.getProperty(rt, "left").getString(rt).utf8(rt));
+    condition.rightColumn = -1;
+
+    auto comparison = where.getProperty(rt, "comparison").getObject(rt);
+    auto opName = comparison.getProperty(rt, "operator").getString(rt).utf8(rt);
+    if (!QueryMatcher::operatorFromString(opName, condition.op)) {
+        return false;
+    }
+
+    // NOTE: Same precedence as getComparisonRight in encodeQuery
+    auto right = comparison.getProperty(rt, "right").getObject(rt);
+    auto values = right.getProperty(rt, "values");
+    auto column = right.getProperty(rt, "column");
+    if (values.isObject()) {
+        auto valuesArray = values.getObject(rt).getArray(rt);
+        for (size_t i = 0, len = valuesArray.size(rt); i < len; i++) {
+            QueryMatcher::Value value;
+            if (!decodeMatcherValue(rt, valuesArray.getValueAtIndex(rt, i), value)) {
+                return false;
+            }
+            condition.values.push_back(std::move(value));
+        }
+    } else if (column.isString()) {
+        condition.rightColumn = matcher.addColumn(column.getString(rt).utf8(rt));
+    } else {
+        QueryMatcher::Value value;
+        if (!decodeMatcherValue(rt, right.getProperty(rt, "value"), value)) {
+            return false;
+        }
+        condition.values.push_back(std::move(value));
+    }
+
+    // Only shapes that encodeQuery turns into valid SQL can be checked
+    bool hasValues = values.isObject();
+    bool hasColumn = condition.rightColumn != -1;
+    switch (condition.op) {
+    case Operator::oneOf:
+    case Operator::notIn:
+        return hasValues;
+    case Operator::between:
+        return hasValues && condition.values.size() == 2;
+    case Operator::like:
+    case Operator::notLike:
+    case Operator::includes:
+        // (patterns must be strings - numbers would be compared as text)
+        return !hasValues && !hasColumn && condition.values[0].type != QueryMatcher::Value::Type::number;
+    default:
+        return !hasValues;
+    }
+}
+
+// Binds observer's query arguments (as first arguments of the statement)
+void Database::bindObserverArgs(sqlite3_stmt *statement, QueryObservers::Observer &observer, int placeholderCount) {
+    auto &rt = getRt();
+    auto &arguments = observer.arguments;
+
+    if (sqlite3_bind_parameter_count(statement) != placeholderCount) {
+        throw jsi::JSError(rt, "Number of args passed to query doesn't match number of arg placeholders");
+    }
+
+    for (size_t i = 0; i < arguments.size(); i++) {
+        auto &argument = arguments[i];
+        int bindResult;
+        if (argument.type == SqliteValue::Type::number) {
+            bindResult = sqlite3_bind_double(statement, (int) i + 1, argument.number);
+        } else if (argument.type == SqliteValue::Type::text) {
+            bindResult = sqlite3_bind_text(statement, (int) i + 1, argument.text.c_str(), (int) argument.text.length(), SQLITE_STATIC);
+        } else {
+            bindResult = sqlite3_bind_null(statement, (int) i + 1);
+        }
+
+        if (bindResult != SQLITE_OK) {
+            throw dbError("Failed to bind an argument for query");
+        }
+    }
+}
+
+// Runs observer's query, and returns its results (IDs of records known to JS, raw records otherwise),
+// and IDs of all records in results
+// NOTE: Records aren't added to recordCache_, since the caller might not send all of them to JS
+std::vector<jsi::Value> Database::fetchObservedQuery(QueryObservers::Observer &observer, std::vector<std::string> &ids) {
+    auto &rt = getRt();
+
+    auto &cachedIds = recordCache_.table(observer.table);
+    auto stmt = prepareQuery(observer.sql);
+    SqliteStatement statement(stmt, &statementCache_);
+    bindObserverArgs(stmt, observer, (int) observer.arguments.size());
+
+    std::optional<ResultShape> shape;
+    std::vector<jsi::Value> records = {};
+    ids.clear();
+
+    while (true) {
+        if (getNextRowOrTrue(stmt)) {
+            break;
+        }
+
+        const char *id = (const char *) sqlite3_column_text(stmt, 0);
+        if (!id) {
+            throw jsi::JSError(rt, "Failed to get ID of a record");
+        }
+        ids.emplace_back(id, sqlite3_column_bytes(stmt, 0));
+
+        if (cachedIds.contains(ids.back())) {
+            records.push_back(jsi::String::createFromUtf8(rt, ids.back()));
+        } else {
+            if (!shape) {
+                shape.emplace(resultShape(stmt));
+            }
+            records.push_back(resultDictionary(stmt, *shape));
+        }
+    }
+
+    return records;
+}
+
+// Checks which of records changed since results were last fetched match the query now
+jsi::Value Database::fetchIncrementalQueryChanges(QueryObservers::Observer &observer) {
+    auto &rt = getRt();
+
+    auto &cachedIds = recordCache_.table(observer.table);
+    std::vector<std::string> idsToCheck = {};
+    std::unordered_set<std::string> seenIds = {};
+    for (auto &id : observer.changedIds) {
+        if (seenIds.insert(id).second) {
+            idsToCheck.push_back(id);
+        }
+    }
+
+    std::unordered_map<std::string, jsi::Value> matchingRecords = {};
+    auto matcher = observer.matcher.get();
+    size_t argsCount = observer.arguments.size();
+    size_t offset = 0;
+    while (offset < idsToCheck.size()) {
+        size_t remaining = idsToCheck.size() - offset;
+        size_t chunkSize = observerCheckChunkSizes[0];
+        for (auto size : observerCheckChunkSizes) {
+            chunkSize = size;
+            if (size >= remaining) {
+                break;
+            }
+        }
+        size_t count = std::min(chunkSize, remaining);
+
+        // If conditions were compiled, changed records are fetched and checked against them. Otherwise
+        // the query is run on just these records
+        // NOTE: sqlite flattens the subquery, so this is a lookup by id, not a scan of all results
+        std::string sql = matcher ? "select * from `" + observer.table + "` where `id` in (?"
+                                  : "select * from (" + observer.sql + ") where `id` in (?";
+        for (size_t i = 1; i < chunkSize; i++) {
+            sql += ", ?";
+        }
+        sql += ")";
+
+        auto stmt = prepareQuery(sql);
+        SqliteStatement statement(stmt, &statementCache_);
+        size_t idsOffset = matcher ? 0 : argsCount;
+        if (!matcher) {
+            bindObserverArgs(stmt, observer, (int) (argsCount + chunkSize));
+        } else if (!matcher->bindColumns(stmt)) {
+            throw jsi::JSError(rt, "Query observer's conditions refer to columns missing in table " + observer.table);
+        }
+        for (size_t i = 0; i < chunkSize; i++) {
+            auto &id = idsToCheck[offset + std::min(i, count - 1)];
+            if (sqlite3_bind_text(stmt, (int) (idsOffset + i + 1), id.c_str(), (int) id.length(), SQLITE_STATIC) != SQLITE_OK) {
+                throw dbError("Failed to bind an argument for query");
+            }
+        }
+
+        std::optional<ResultShape> shape;
+        while (true) {
+            if (getNextRowOrTrue(stmt)) {
+                break;
+            }
+            if (matcher && !matcher->matches(stmt)) {
+                continue;
+            }
+
+            const char *id = (const char *) sqlite3_column_text(stmt, 0);
+            if (!id) {
+                throw jsi::JSError(rt, "Failed to get ID of a record");
+            }
+            std::string idStr(id, sqlite3_column_bytes(stmt, 0));
+            if (matchingRecords.count(idStr) || observer.idSet.count(idStr)) {
+                // (already in results - nothing to send)
+                matchingRecords.emplace(std::move(idStr), jsi::Value::null());
+                continue;
+            }
+
+            if (cachedIds.contains(idStr)) {
+                auto jsiId = jsi::String::createFromUtf8(rt, idStr);
+                matchingRecords.emplace(std::move(idStr), std::move(jsiId));
+            } else {
+                if (!shape) {
+                    shape.emplace(resultShape(stmt));
+                }
+                matchingRecords.emplace(std::move(idStr), resultDictionary(stmt, *shape));
+            }
+        }
+
+        offset += count;
+    }
+
+    std::vector<jsi::Value> added = {};
+    std::vector<jsi::Value> removed = {};
+    for (auto &id : idsToCheck) {
+        auto matching = matchingRecords.find(id);
+        bool isInResults = observer.idSet.count(id) > 0;
+
+        if (matching != matchingRecords.end() && !isInResults) {
+            if (matching->second.isObject()) {
+                cachedIds.insert(id);
+            }
+            added.push_back(std::move(matching->second));
+            observer.idSet.insert(id);
+        } else if (matching == matchingRecords.end() && isInResults) {
+            removed.push_back(jsi::String::createFromUtf8(rt, id));
+            observer.idSet.erase(id);
+        }
+    }
+
+    if (added.empty() && removed.empty()) {
+        return jsi::Value::null();
+    }
+
+    jsi::Object changes(rt);
+    changes.setProperty(rt, "added", arrayFromStd(added));
+    changes.setProperty(rt, "removed", arrayFromStd(removed));
+    return changes;
+}
+
+jsi::Value Database::fetchQueryObserverChanges(int observerId) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+
+    auto observer = queryObservers_.get(observerId);
+    if (!observer) {
+        throw jsi::JSError(rt, "Query observer " + std::to_string(observerId) + " does not exist");
+    }
+
+    if (observer->isIncremental && !observer->isStale) {
+        auto changes = fetchIncrementalQueryChanges(*observer);
+        observer->changedIds.clear();
+        return changes;
+    }
+
+    if (!observer->isStale) {
+        return jsi::Value::null();
+    }
+
+    // Query has to be re-run
+    std::vector<std::string> ids = {};
+    auto records = fetchObservedQuery(*observer, ids);
+    auto &cachedIds = recordCache_.table(observer->table);
+    observer->isStale = false;
+    observer->changedIds.clear();
+
+    if (observer->isIncremental) {
+        std::unordered_set<std::string> idSet(ids.begin(), ids.end());
+        std::vector<jsi::Value> added = {};
+        std::vector<jsi::Value> removed = {};
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (!observer->idSet.count(ids[i])) {
+                if (records[i].isObject()) {
+                    cachedIds.insert(ids[i]);
+                }
+                added.push_back(std::move(records[i]));
+            }
+        }
+        for (auto &id : observer->idSet) {
+            if (!idSet.count(id)) {
+                removed.push_back(jsi::String::createFromUtf8(rt, id));
+            }
+        }
+        observer->idSet = std::move(idSet);
+
+        if (added.empty() && removed.empty()) {
+            return jsi::Value::null();
+        }
+        jsi::Object changes(rt);
+        changes.setProperty(rt, "added", arrayFromStd(added));
+        changes.setProperty(rt, "removed", arrayFromStd(removed));
+        return changes;
+    }
+
+    if (ids == observer->ids) {
+        return jsi::Value::null();
+    }
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (records[i].isObject()) {
+            cachedIds.insert(ids[i]);
+        }
+    }
+    observer->ids = std::move(ids);
+
+    jsi::Object changes(rt);
+    changes.setProperty(rt, "records", arrayFromStd(records));
+    return changes;
+}
+
+} // namespace watermelondb
@@ -1,5 +1,7 @@
 #include "Database.h"
 #include "DatabasePlatform.h"
+#include "JSIHelpers.h"
+#include <cstring>
 
 namespace watermelondb {
 
@@ -7,52 +9,178 @@ using platform::consoleError;
 using platform::consoleLog;
 
 jsi::Value Database::find(jsi::String &tableName, jsi::String &id) {
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+    return findImpl(tableName, id);
+}
+
+jsi::Value Database::findImpl(jsi::String &tableName, jsi::String &id) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
 
-    if (isCached(cacheKey(tableName.utf8(rt), id.utf8(rt)))) {
+    auto table = tableName.utf8(rt);
+    auto idStr = id.utf8(rt);
+    auto &cachedIds = recordCache_.table(table);
+
+    if (cachedIds.contains(idStr)) {
         return std::move(id);
     }
 
     auto args = jsi::Array::createWithElements(rt, id);
-    auto statement = executeQuery("select * from `" + tableName.utf8(rt) + "` where id == ? limit 1", args);
+    auto statement = executeQuery("select * from `" + table + "` where id == ? limit 1", args);
 
     if (getNextRowOrTrue(statement.stmt)) {
         return jsi::Value::null();
     }
 
-    auto record = resultDictionary(statement.stmt);
+    auto record = resultDictionary(statement.stmt, resultShape(statement.stmt));
 
-    markAsCached(cacheKey(tableName.utf8(rt), id.utf8(rt)));
+    cachedIds.insert(idStr);
 
     return record;
 }
 
-jsi::Value Database::query(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
+jsi::Array Database::findMany(jsi::String &tableName, jsi::Array &ids) {
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+    return findManyImpl(tableName, ids);
+}
+
+// NOTE: To keep the number of distinct cached statements low, ids are fetched in chunks of one of these
+// sizes, padded with a duplicate id if needed
+static const size_t findManyChunkSizes[] = { 1, 8, 64, 256 };
+
+jsi::Array Database::findManyImpl(jsi::String &tableName, jsi::Array &ids) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
 
+    auto table = tableName.utf8(rt);
+    auto &cachedIds = recordCache_.table(table);
+    size_t idsCount = ids.length(rt);
+    jsi::Array results(rt, idsCount);
+
+    // Cached ids are returned as is, and the rest need to be fetched (and can appear multiple times)
+    std::vector<std::string> idsToFetch = {};
+    std::unordered_map<std::string, std::vector<size_t>> indicesToFetch = {};
+
+    for (size_t i = 0; i < idsCount; i++) {
+        jsi::String jsiId = ids.getValueAtIndex(rt, i).getString(rt);
+        auto id = jsiId.utf8(rt);
+        if (cachedIds.contains(id)) {
+            results.setValueAtIndex(rt, i, std::move(jsiId));
+            continue;
+        }
+
+        results.setValueAtIndex(rt, i, jsi::Value::null());
+        auto &indices = indicesToFetch[id];
+        if (indices.empty()) {
+            idsToFetch.push_back(id);
+        }
+        indices.push_back(i);
+    }
+
+    size_t offset = 0;
+    while (offset < idsToFetch.size()) {
+        size_t remaining = idsToFetch.size() - offset;
+        size_t chunkSize = findManyChunkSizes[0];
+        for (auto size : findManyChunkSizes) {
+            chunkSize = size;
+            if (size >= remaining) {
+                break;
+            }
+        }
+        size_t count = std::min(chunkSize, remaining);
+
+        std::string sql = "select * from `" + table + "` where id in (?";
+        for (size_t i = 1; i < chunkSize; i++) {
+            sql += ", ?";
+        }
+        sql += ")";
+
+        auto stmt = prepareQuery(sql);
+        SqliteStatement statement(stmt, &statementCache_);
+        for (size_t i = 0; i < chunkSize; i++) {
+            auto &id = idsToFetch[offset + std::min(i, count - 1)];
+            if (sqlite3_bind_text(stmt, (int) i + 1, id.c_str(), (int) id.length(), SQLITE_STATIC) != SQLITE_OK) {
+                throw dbError("Failed to bind an argument for query");
+            }
+        }
+
+        std::optional<ResultShape> shape;
+        while (true) {
+            if (getNextRowOrTrue(stmt)) {
+                break;
+            }
+
+            assert(std::string(sqlite3_column_name(stmt, 0)) == "id");
+
+            const char *id = (const char *)sqlite3_column_text(stmt, 0);
+            if (!id) {
+                throw jsi::JSError(rt, "Failed to get ID of a record");
+            }
+            std::string_view idView(id, sqlite3_column_bytes(stmt, 0));
+
+            auto indices = indicesToFetch.find(std::string(idView));
+            if (indices == indicesToFetch.end() || cachedIds.contains(idView)) {
+                continue;
+            }
+
+            if (!shape) {
+                shape.emplace(resultShape(stmt));
+            }
+            cachedIds.insert(idView);
+            results.setValueAtIndex(rt, indices->second[0], resultDictionary(stmt, *shape));
+            for (size_t i = 1; i < indices->second.size(); i++) {
+                results.setValueAtIndex(rt, indices->second[i], jsi::String::createFromAscii(rt, id));
+            }
+        }
+
+        offset += count;
+    }
+
+    return results;
+}
+
+jsi::Value Database::query(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+    return queryImpl(tableName, sql, arguments);
+}
+
+jsi::Value Database::queryImpl(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
+    auto &rt = getRt();
     auto statement = executeQuery(sql.utf8(rt), arguments);
+    return queryRecords(tableName.utf8(rt), statement.stmt);
+}
+
+// Returns records (or IDs of cached records) fetched by an executed query statement
+jsi::Value Database::queryRecords(const std::string &tableName, sqlite3_stmt *statement) {
+    auto &rt = getRt();
+
+    auto &cachedIds = recordCache_.table(tableName);
+    std::optional<ResultShape> shape;
     std::vector<jsi::Value> records = {};
 
     while (true) {
-        if (getNextRowOrTrue(statement.stmt)) {
+        if (getNextRowOrTrue(statement)) {
             break;
         }
 
-        assert(std::string(sqlite3_column_name(statement.stmt, 0)) == "id");
+        assert(std::string(sqlite3_column_name(statement, 0)) == "id");
 
-        const char *id = (const char *)sqlite3_column_text(statement.stmt, 0);
+        const char *id = (const char *)sqlite3_column_text(statement, 0);
         if (!id) {
             throw jsi::JSError(rt, "Failed to get ID of a record");
         }
+        std::string_view idView(id, sqlite3_column_bytes(statement, 0));
 
-        if (isCached(cacheKey(tableName.utf8(rt), std::string(id)))) {
+        if (cachedIds.contains(idView)) {
             jsi::String jsiId = jsi::String::createFromAscii(rt, id);
             records.push_back(std::move(jsiId));
         } else {
-            markAsCached(cacheKey(tableName.utf8(rt), std::string(id)));
-            jsi::Object record = resultDictionary(statement.stmt);
+            cachedIds.insert(idView);
+            if (!shape) {
+                shape.emplace(resultShape(statement));
+            }
+            jsi::Object record = resultDictionary(statement, *shape);
             records.push_back(std::move(record));
         }
     }
@@ -61,10 +189,17 @@ jsi::Value Database::query(jsi::String &tableName, jsi::String &sql, jsi::Array
 }
 
 jsi::Value Database::queryAsArray(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+    return queryAsArrayImpl(tableName, sql, arguments);
+}
+
+jsi::Value Database::queryAsArrayImpl(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
 
+    auto &cachedIds = recordCache_.table(tableName.utf8(rt));
     auto statement = executeQuery(sql.utf8(rt), arguments);
+    std::optional<ResultShape> shape;
     std::vector<jsi::Value> results = {};
 
     while (true) {
@@ -78,18 +213,19 @@ jsi::Value Database::queryAsArray(jsi::String &tableName, jsi::String &sql, jsi:
         if (!id) {
             throw jsi::JSError(rt, "Failed to get ID of a record");
         }
+        std::string_view idView(id, sqlite3_column_bytes(statement.stmt, 0));
 
         if (results.size() == 0) {
-            jsi::Array columns = resultColumns(statement.stmt);
-            results.push_back(std::move(columns));
+            shape.emplace(resultShape(statement.stmt));
+            results.push_back(resultHeader(*shape));
         }
 
-        if (isCached(cacheKey(tableName.utf8(rt), std::string(id)))) {
+        if (cachedIds.contains(idView)) {
             jsi::String jsiId = jsi::String::createFromAscii(rt, id);
             results.push_back(std::move(jsiId));
         } else {
-            markAsCached(cacheKey(tableName.utf8(rt), std::string(id)));
-            jsi::Array record = resultArray(statement.stmt);
+            cachedIds.insert(idView);
+            jsi::Array record = resultArray(statement.stmt, *shape);
             results.push_back(std::move(record));
         }
     }
@@ -97,9 +233,182 @@ jsi::Value Database::queryAsArray(jsi::String &tableName, jsi::String &sql, jsi:
     return arrayFromStd(results);
 }
 
+// Columnar result layout (native endianness, offsets in bytes):
+//   u32 rowCount, u32 columnCount, u32 blobLength, u32 numberCount, u32 stringCount, u32 (reserved)
+//   f64[numberCount] number values
+//   u32[stringCount] string starts, u32[stringCount] string lengths
+//   u32[columns] column name starts, u32[columns] column name lengths
+//   u32[columns] index of column's first number, u32[columns] index of column's first string
+//   u8[rows] 1 if row is a cached record (only its id is filled in)
+//   u8[rows * columns] cell types (see ColumnarCellType), column-major (index = column * rowCount + row)
+//   u8[blobLength] UTF-8 blob of all strings
+// Numbers and strings are stored column by column, and only for cells of that type, so a null costs
+// one byte, and a number or a string nine bytes (plus its UTF-8 text in the blob)
+// String starts and lengths are in UTF-16 code units of the decoded blob, so that JS can decode the
+// whole blob at once and slice it, instead of decoding each string separately
+// NOTE: Must be kept in sync with decodeColumnarQueryResult
+enum ColumnarCellType : uint8_t { columnarNull = 0, columnarNumber = 1, columnarString = 2 };
+
+// Returns length of UTF-8 text in UTF-16 code units
+static size_t utf16Length(const char *text, size_t length) {
+    size_t result = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = (uint8_t) text[i];
+        // Every code point has one non-continuation byte, and ones outside BMP take two code units
+        result += (byte & 0xc0) != 0x80;
+        result += byte >= 0xf0;
+    }
+    return result;
+}
+
+jsi::Value Database::queryColumnar(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+
+    auto &cachedIds = recordCache_.table(tableName.utf8(rt));
+    auto statement = executeQuery(sql.utf8(rt), arguments);
+
+    // NOTE: Cells are written straight into buffers of their column as rows are stepped through,
+    // and only copied once more, to the final buffer (whose size is not known until the last row)
+    struct Column {
+        std::vector<uint8_t> types;
+        std::vector<double> numbers;
+        std::vector<uint32_t> stringStarts;
+        std::vector<uint32_t> stringLengths;
+    };
+    std::vector<Column> columns = {};
+    std::vector<uint8_t> cached = {};
+    std::vector<uint32_t> nameStarts = {};
+    std::vector<uint32_t> nameLengths = {};
+    std::string blob = "";
+    size_t blobUtf16Length = 0;
+
+    auto appendString = [&](const char *text, size_t length, std::vector<uint32_t> &starts, std::vector<uint32_t> &lengths) {
+        size_t decodedLength = utf16Length(text, length);
+        starts.push_back((uint32_t) blobUtf16Length);
+        lengths.push_back((uint32_t) decodedLength);
+        blob.append(text, length);
+        blobUtf16Length += decodedLength;
+    };
+
+    while (true) {
+        if (getNextRowOrTrue(statement.stmt)) {
+            break;
+        }
+
+        assert(std::string(sqlite3_column_name(statement.stmt, 0)) == "id");
+
+        const char *id = (const char *)sqlite3_column_text(statement.stmt, 0);
+        if (!id) {
+            throw jsi::JSError(rt, "Failed to get ID of a record");
+        }
+        std::string_view idView(id, sqlite3_column_bytes(statement.stmt, 0));
+
+        if (cached.size() == 0) {
+            columns.resize(sqlite3_column_count(statement.stmt));
+            for (size_t i = 0; i < columns.size(); i++) {
+                const char *column = sqlite3_column_name(statement.stmt, (int) i);
+                appendString(column, strlen(column), nameStarts, nameLengths);
+            }
+        }
+
+        bool isCached = cachedIds.contains(idView);
+        cached.push_back(isCached ? 1 : 0);
+        if (!isCached) {
+            cachedIds.insert(idView);
+        }
+
+        for (size_t i = 0; i < columns.size(); i++) {
+            auto &column = columns[i];
+            auto type = i == 0 || !isCached ? sqlite3_column_type(statement.stmt, (int) i) : SQLITE_NULL;
+            if (type == SQLITE_INTEGER || type == SQLITE_FLOAT) {
+                column.numbers.push_back(sqlite3_column_double(statement.stmt, (int) i));
+                column.types.push_back(columnarNumber);
+            } else if (type == SQLITE_TEXT) {
+                const char *text = (const char *)sqlite3_column_text(statement.stmt, (int) i);
+                appendString(text, sqlite3_column_bytes(statement.stmt, (int) i), column.stringStarts, column.stringLengths);
+                column.types.push_back(columnarString);
+            } else if (type == SQLITE_NULL) {
+                column.types.push_back(columnarNull);
+            } else {
+                throw jsi::JSError(rt, "Unable to fetch record from database - unknown column type (WatermelonDB does not support blobs or custom sqlite types");
+            }
+        }
+    }
+
+    size_t rowCount = cached.size();
+    size_t columnCount = columns.size();
+    size_t numberCount = 0;
+    size_t stringCount = 0;
+    std::vector<uint32_t> firstNumbers = {};
+    std::vector<uint32_t> firstStrings = {};
+    for (auto &column : columns) {
+        firstNumbers.push_back((uint32_t) numberCount);
+        firstStrings.push_back((uint32_t) stringCount);
+        numberCount += column.numbers.size();
+        stringCount += column.stringStarts.size();
+    }
+
+    size_t numbersOffset = 6 * sizeof(uint32_t);
+    size_t stringStartsOffset = numbersOffset + numberCount * sizeof(double);
+    size_t stringLengthsOffset = stringStartsOffset + stringCount * sizeof(uint32_t);
+    size_t nameStartsOffset = stringLengthsOffset + stringCount * sizeof(uint32_t);
+    size_t nameLengthsOffset = nameStartsOffset + columnCount * sizeof(uint32_t);
+    size_t firstNumbersOffset = nameLengthsOffset + columnCount * sizeof(uint32_t);
+    size_t firstStringsOffset = firstNumbersOffset + columnCount * sizeof(uint32_t);
+    size_t cachedOffset = firstStringsOffset + columnCount * sizeof(uint32_t);
+    size_t typesOffset = cachedOffset + rowCount;
+    size_t blobOffset = typesOffset + rowCount * columnCount;
+    size_t byteLength = blobOffset + blob.size();
+
+    // NOTE: Creating ArrayBuffer via JS constructor, since jsi::ArrayBuffer can't be created natively on older RN versions
+    jsi::ArrayBuffer arrayBuffer = rt.global()
+        .getPropertyAsFunction(rt, "ArrayBuffer")
+        .callAsConstructor(rt, (double) byteLength)
+        .getObject(rt)
+        .getArrayBuffer(rt);
+    uint8_t *data = arrayBuffer.data(rt);
+
+    uint32_t header[6] = {
+        (uint32_t) rowCount, (uint32_t) columnCount, (uint32_t) blob.size(), (uint32_t) numberCount, (uint32_t) stringCount, 0
+    };
+    memcpy(data, header, sizeof(header));
+
+    auto copy = [&](size_t offset, const auto &items) {
+        if (!items.empty()) {
+            memcpy(data + offset, items.data(), items.size() * sizeof(items[0]));
+        }
+        return offset + items.size() * sizeof(items[0]);
+    };
+
+    size_t numbersOut = numbersOffset;
+    size_t stringStartsOut = stringStartsOffset;
+    size_t stringLengthsOut = stringLengthsOffset;
+    size_t typesOut = typesOffset;
+    for (auto &column : columns) {
+        numbersOut = copy(numbersOut, column.numbers);
+        stringStartsOut = copy(stringStartsOut, column.stringStarts);
+        stringLengthsOut = copy(stringLengthsOut, column.stringLengths);
+        typesOut = copy(typesOut, column.types);
+    }
+    copy(nameStartsOffset, nameStarts);
+    copy(nameLengthsOffset, nameLengths);
+    copy(firstNumbersOffset, firstNumbers);
+    copy(firstStringsOffset, firstStrings);
+    copy(cachedOffset, cached);
+    memcpy(data + blobOffset, blob.data(), blob.size());
+
+    return arrayBuffer;
+}
+
 jsi::Array Database::queryIds(jsi::String &sql, jsi::Array &arguments) {
+    const DatabaseLock lock(*this);
+    return queryIdsImpl(sql, arguments);
+}
+
+jsi::Array Database::queryIdsImpl(jsi::String &sql, jsi::Array &arguments) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
 
     auto statement = executeQuery(sql.utf8(rt), arguments);
     std::vector<jsi::Value> ids = {};
@@ -124,10 +433,15 @@ jsi::Array Database::queryIds(jsi::String &sql, jsi::Array &arguments) {
 }
 
 jsi::Array Database::unsafeQueryRaw(jsi::String &sql, jsi::Array &arguments) {
+    const DatabaseLock lock(*this);
+    return unsafeQueryRawImpl(sql, arguments);
+}
+
+jsi::Array Database::unsafeQueryRawImpl(jsi::String &sql, jsi::Array &arguments) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
 
     auto statement = executeQuery(sql.utf8(rt), arguments);
+    std::optional<ResultShape> shape;
     std::vector<jsi::Value> raws = {};
 
     while (true) {
@@ -135,7 +449,10 @@ jsi::Array Database::unsafeQueryRaw(jsi::String &sql, jsi::Array &arguments) {
             break;
         }
 
-        jsi::Object raw = resultDictionary(statement.stmt);
+        if (!shape) {
+            shape.emplace(resultShape(statement.stmt));
+        }
+        jsi::Object raw = resultDictionary(statement.stmt, *shape);
         raws.push_back(std::move(raw));
     }
 
@@ -143,20 +460,66 @@ jsi::Array Database::unsafeQueryRaw(jsi::String &sql, jsi::Array &arguments) {
 }
 
 jsi::Value Database::count(jsi::String &sql, jsi::Array &arguments) {
-    auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
+    const DatabaseLock lock(*this);
+    return countImpl(sql, arguments);
+}
 
+jsi::Value Database::countImpl(jsi::String &sql, jsi::Array &arguments) {
+    auto &rt = getRt();
     auto statement = executeQuery(sql.utf8(rt), arguments);
-    getRow(statement.stmt);
+    return countResult(statement.stmt);
+}
 
-    assert(sqlite3_data_count(statement.stmt) == 1);
-    int count = sqlite3_column_int(statement.stmt, 0);
+jsi::Value Database::countResult(sqlite3_stmt *statement) {
+    getRow(statement);
+
+    assert(sqlite3_data_count(statement) == 1);
+    int count = sqlite3_column_int(statement, 0);
     return jsi::Value(count);
 }
 
+// Returns [sql, args] - see encodeQuerySql
+jsi::Array Database::encodeQuery(jsi::Object &query, bool countMode) {
+    auto &rt = getRt();
+    auto querySql = encodeQuerySql(rt, query, countMode);
+
+    jsi::Array arguments(rt, querySql.arguments.size());
+    for (size_t i = 0; i < querySql.arguments.size(); i++) {
+        arguments.setValueAtIndex(rt, i, valueFromSqlite(querySql.arguments[i]));
+    }
+    return jsi::Array::createWithElements(rt, jsi::String::createFromUtf8(rt, querySql.sql), std::move(arguments));
+}
+
+// Same as query(), but for a SerializedQuery, encoded natively (see encodeQuerySql). Unlike calling
+// encodeQuery() and then query(), the encoded SQL and arguments don't have to be passed through JS
+jsi::Value Database::queryEncoded(jsi::Object &query) {
+    auto &rt = getRt();
+    auto querySql = encodeQuerySql(rt, query, false);
+    auto tableName = query.getProperty(rt, "table").getString(rt).utf8(rt);
+
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+    auto statement = executeQuery(querySql.sql, querySql.arguments);
+    return queryRecords(tableName, statement.stmt);
+}
+
+// Same as count(), but for a SerializedQuery - see queryEncoded
+jsi::Value Database::countEncoded(jsi::Object &query) {
+    auto &rt = getRt();
+    auto querySql = encodeQuerySql(rt, query, true);
+
+    const DatabaseLock lock(*this);
+    auto statement = executeQuery(querySql.sql, querySql.arguments);
+    return countResult(statement.stmt);
+}
+
 jsi::Value Database::getLocal(jsi::String &key) {
+    const DatabaseLock lock(*this);
+    return getLocalImpl(key);
+}
+
+jsi::Value Database::getLocalImpl(jsi::String &key) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
 
     auto args = jsi::Array::createWithElements(rt, key);
     auto statement = executeQuery("select value from local_storage where key = ?", args);
@@ -175,4 +538,89 @@ jsi::Value Database::getLocal(jsi::String &key) {
     return jsi::String::createFromUtf8(rt, text);
 }
 
+jsi::Array Database::multiQuery(jsi::Array &operations) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    const auto asyncCommits = holdAsyncCommits();
+
+    // NOTE: All reads are done in a single (deferred) transaction, so that they see a consistent snapshot.
+    // It's committed when leaving scope, on failure, too - there's nothing to roll back in a read-only transaction
+    class ReadTransaction {
+    public:
+        explicit ReadTransaction(Database &database) : database_(database) {
+            database_.executeUpdate("begin deferred transaction");
+        }
+        ~ReadTransaction() {
+            // NOTE: sqlite may have already ended the transaction (e.g. on IO errors)
+            if (sqlite3_get_autocommit(database_.db_->sqlite)) {
+                return;
+            }
+            try {
+                database_.commit();
+            } catch (const std::exception &ex) {
+                consoleError("Failed to end multiQuery transaction: " + std::string(ex.what()));
+            }
+        }
+
+    private:
+        Database &database_;
+    };
+    const ReadTransaction transaction(*this);
+
+    size_t operationsCount = operations.length(rt);
+    jsi::Array results(rt, operationsCount);
+
+    for (size_t i = 0; i < operationsCount; i++) {
+        // NOTE: Errors are returned per operation instead of thrown, because successful operations have
+        // already marked their records as cached, so their results must get to JS
+        try {
+            results.setValueAtIndex(rt, i, multiQueryOperation(operations.getValueAtIndex(rt, i)));
+        } catch (const jsi::JSError &error) {
+            results.setValueAtIndex(rt, i, makeError(rt, error.getMessage()));
+        } catch (const std::exception &ex) {
+            results.setValueAtIndex(rt, i, makeError(rt, ex.what()));
+        }
+    }
+
+    return results;
+}
+
+jsi::Value Database::multiQueryOperation(const jsi::Value &operationValue) {
+    auto &rt = getRt();
+    jsi::Array operation = operationValue.getObject(rt).getArray(rt);
+    auto type = operation.getValueAtIndex(rt, 0).getString(rt).utf8(rt);
+
+    if (type == "find") {
+        jsi::String tableName = operation.getValueAtIndex(rt, 1).getString(rt);
+        jsi::String id = operation.getValueAtIndex(rt, 2).getString(rt);
+        return findImpl(tableName, id);
+    } else if (type == "findMany") {
+        jsi::String tableName = operation.getValueAtIndex(rt, 1).getString(rt);
+        jsi::Array ids = operation.getValueAtIndex(rt, 2).getObject(rt).getArray(rt);
+        return findManyImpl(tableName, ids);
+    } else if (type == "query" || type == "queryAsArray") {
+        jsi::String tableName = operation.getValueAtIndex(rt, 1).getString(rt);
+        jsi::String sql = operation.getValueAtIndex(rt, 2).getString(rt);
+        jsi::Array arguments = operation.getValueAtIndex(rt, 3).getObject(rt).getArray(rt);
+        if (type == "query") {
+            return queryImpl(tableName, sql, arguments);
+        }
+        return queryAsArrayImpl(tableName, sql, arguments);
+    } else if (type == "queryIds" || type == "unsafeQueryRaw" || type == "count") {
+        jsi::String sql = operation.getValueAtIndex(rt, 1).getString(rt);
+        jsi::Array arguments = operation.getValueAtIndex(rt, 2).getObject(rt).getArray(rt);
+        if (type == "queryIds") {
+            return queryIdsImpl(sql, arguments);
+        } else if (type == "unsafeQueryRaw") {
+            return unsafeQueryRawImpl(sql, arguments);
+        }
+        return countImpl(sql, arguments);
+    } else if (type == "getLocal") {
+        jsi::String key = operation.getValueAtIndex(rt, 1).getString(rt);
+        return getLocalImpl(key);
+    }
+
+    throw jsi::JSError(rt, "Invalid multiQuery operation type: " + type);
+}
+
 }
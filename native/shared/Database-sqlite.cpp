@@ -9,18 +9,12 @@ using platform::consoleError;
 using platform::consoleLog;
 
 sqlite3_stmt* Database::prepareQuery(std::string sql) {
-    sqlite3_stmt *statement = cachedStatements_[sql];
+    bool isCached = false;
+    sqlite3_stmt *statement = statementCache_.prepare(db_->sqlite, sql, isCached);
 
     if (statement == nullptr) {
-        int resultPrepare = sqlite3_prepare_v2(db_->sqlite, sql.c_str(), -1, &statement, nullptr);
-
-        if (resultPrepare != SQLITE_OK) {
-            sqlite3_finalize(statement);
-            throw dbError("Failed to prepare query statement");
-        }
-
-        cachedStatements_[sql] = statement;
-    } else {
+        throw dbError("Failed to prepare query statement");
+    } else if (isCached) {
         // in theory, this shouldn't be necessary, since statements ought to be reset *after* use, not before use
         // but still this might prevent some crashes if this is not done right
         // TODO: Remove this later - should not be necessary, and it wastes time
@@ -66,53 +60,44 @@ void Database::bindArgs(sqlite3_stmt *statement, jsi::Array &arguments) {
     }
 }
 
-std::string Database::bindArgsAndReturnId(sqlite3_stmt *statement, simdjson::ondemand::array &args) {
-    using namespace simdjson;
+void Database::bindArgs(sqlite3_stmt *statement, const std::vector<SqliteValue> &arguments) {
     auto &rt = getRt();
-    std::string returnId = "";
-
     int argsCount = sqlite3_bind_parameter_count(statement);
-    int i = 0;
-    for (auto arg : args) {
-        int bindResult;
-        ondemand::json_type type = arg.type();
 
-        if (type == ondemand::json_type::string) {
-            std::string_view stringView = arg;
-            bindResult = sqlite3_bind_text(statement, i + 1, stringView.data(), (int) stringView.length(), SQLITE_STATIC);
-            if (i == 0) {
-                returnId = std::string(stringView);
-            }
-        } else if (type == ondemand::json_type::number) {
-            bindResult = sqlite3_bind_double(statement, i + 1, (double) arg);
-        } else if (type == ondemand::json_type::boolean) {
-            bindResult = sqlite3_bind_int(statement, i + 1, (bool) arg);
-        } else if (type == ondemand::json_type::null) {
-            bindResult = sqlite3_bind_null(statement, i + 1);
+    if (argsCount != (int) arguments.size()) {
+        sqlite3_reset(statement);
+        throw jsi::JSError(rt, "Number of args passed to query doesn't match number of arg placeholders");
+    }
+
+    for (int i = 0; i < argsCount; i++) {
+        auto &argument = arguments[i];
+
+        int bindResult;
+        if (argument.type == SqliteValue::Type::number) {
+            bindResult = sqlite3_bind_double(statement, i + 1, argument.number);
+        } else if (argument.type == SqliteValue::Type::text) {
+            bindResult = sqlite3_bind_text(statement, i + 1, argument.text.c_str(), (int) argument.text.length(), SQLITE_TRANSIENT);
         } else {
-            throw jsi::JSError(rt, "Invalid argument type for query - only strings, numbers, booleans and null are allowed");
+            bindResult = sqlite3_bind_null(statement, i + 1);
         }
 
-        i++;
-
         if (bindResult != SQLITE_OK) {
             sqlite3_reset(statement);
             throw dbError("Failed to bind an argument for query");
         }
     }
-
-    if (argsCount != i) {
-        sqlite3_reset(statement);
-        throw jsi::JSError(rt, "Number of args passed to query doesn't match number of arg placeholders");
-    }
-
-    return returnId;
 }
 
 SqliteStatement Database::executeQuery(std::string sql, jsi::Array &arguments) {
     auto statement = prepareQuery(sql);
     bindArgs(statement, arguments);
-    return SqliteStatement(statement);
+    return SqliteStatement(statement, &statementCache_);
+}
+
+SqliteStatement Database::executeQuery(std::string sql, const std::vector<SqliteValue> &arguments) {
+    auto statement = prepareQuery(sql);
+    bindArgs(statement, arguments);
+    return SqliteStatement(statement, &statementCache_);
 }
 
 void Database::executeUpdate(sqlite3_stmt *statement) {
@@ -123,16 +108,9 @@ void Database::executeUpdate(sqlite3_stmt *statement) {
     }
 }
 
-void Database::executeUpdate(std::string sql, jsi::Array &args) {
-    auto stmt = prepareQuery(sql);
-    bindArgs(stmt, args);
-    SqliteStatement statement(stmt);
-    executeUpdate(stmt);
-}
-
 void Database::executeUpdate(std::string sql) {
     auto stmt = prepareQuery(sql);
-    SqliteStatement statement(stmt);
+    SqliteStatement statement(stmt, &statementCache_);
     executeUpdate(stmt);
 }
 
@@ -158,6 +136,9 @@ bool Database::getNextRowOrTrue(sqlite3_stmt *stmt) {
 
 void Database::executeMultiple(std::string sql) {
     auto &rt = getRt();
+    waitForAsyncWrites();
+    // NOTE: arbitrary SQL may alter tables, so column lists of cached statements may no longer be valid
+    invalidateResultShapes();
     char *errmsg = nullptr;
     int resultExec = sqlite3_exec(db_->sqlite, sql.c_str(), nullptr, nullptr, &errmsg);
 
@@ -174,13 +155,85 @@ void Database::executeMultiple(std::string sql) {
     }
 }
 
-jsi::Object Database::resultDictionary(sqlite3_stmt *statement) {
+jsi::Value Database::unsafeExecuteMultiple(std::string sql) {
+    const DatabaseLock lock(*this);
+    // NOTE: Statements aren't wrapped in a transaction, since they might manage transactions themselves
+    // (or do things like VACUUM, which can't be done in a transaction)
+    changeFeed_.begin();
+    try {
+        executeMultiple(sql);
+    } catch (const std::exception &ex) {
+        changeFeed_.finish();
+        queryObservers_.invalidateAll();
+        throw;
+    }
+    auto changes = finishChangeFeed();
+    // NOTE: Not all changes made by arbitrary SQL are reported by sqlite (e.g. rows deleted by `insert or
+    // replace` because of a conflicting unique index, or tables dropped and recreated), so
+    // incremental observation can't be trusted here
+    queryObservers_.invalidateAll();
+    return changes;
+}
+
+jsi::Value Database::getStatementCacheStats() {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+
+    auto stats = statementCache_.stats();
+    jsi::Object result(rt);
+    result.setProperty(rt, "hits", jsi::Value((double) stats.hits));
+    result.setProperty(rt, "misses", jsi::Value((double) stats.misses));
+    result.setProperty(rt, "evictions", jsi::Value((double) stats.evictions));
+    result.setProperty(rt, "count", jsi::Value((double) stats.count));
+    result.setProperty(rt, "bytes", jsi::Value((double) stats.bytes));
+    return result;
+}
+
+ResultShape Database::resultShape(sqlite3_stmt *statement) {
+    auto &rt = getRt();
+    auto &names = resultShapes_[statement];
+    int count = sqlite3_column_count(statement);
+
+    // NOTE: Column count check is a cheap safety net in case schema changed without us noticing
+    // (sqlite transparently re-prepares statements after schema changes)
+    if ((int) names.size() != count) {
+        names.clear();
+        names.reserve(count);
+        for (int i = 0; i < count; i++) {
+            const char *column = sqlite3_column_name(statement, i);
+            assert(column);
+            names.push_back(column);
+        }
+    }
+
+    std::vector<jsi::PropNameID> columnNames;
+    columnNames.reserve(count);
+    for (auto const &name : names) {
+        columnNames.push_back(jsi::PropNameID::forUtf8(rt, name));
+    }
+    return ResultShape { count, std::move(columnNames) };
+}
+
+// Returns a new header row for queryAsArray. NOTE: JS may mutate it, so it can't be reused
+jsi::Array Database::resultHeader(const ResultShape &shape) {
+    auto &rt = getRt();
+    jsi::Array header(rt, shape.columnCount);
+    for (int i = 0; i < shape.columnCount; i++) {
+        header.setValueAtIndex(rt, i, jsi::String::createFromUtf8(rt, shape.columnNames[i].utf8(rt)));
+    }
+    return header;
+}
+
+void Database::invalidateResultShapes() {
+    resultShapes_.clear();
+}
+
+jsi::Object Database::resultDictionary(sqlite3_stmt *statement, const ResultShape &shape) {
     auto &rt = getRt();
     jsi::Object dictionary(rt);
 
-    for (int i = 0, len = sqlite3_column_count(statement); i < len; i++) {
-        const char *column = sqlite3_column_name(statement, i);
-        assert(column);
+    for (int i = 0, len = shape.columnCount; i < len; i++) {
+        auto &column = shape.columnNames[i];
 
         auto type = sqlite3_column_type(statement, i);
         if (type == SQLITE_INTEGER) {
@@ -206,9 +259,9 @@ jsi::Object Database::resultDictionary(sqlite3_stmt *statement) {
     return dictionary; // TODO: Make sure this value is moved, not copied
 }
 
-jsi::Array Database::resultArray(sqlite3_stmt *statement) {
+jsi::Array Database::resultArray(sqlite3_stmt *statement, const ResultShape &shape) {
     auto &rt = getRt();
-    int count = sqlite3_column_count(statement);
+    int count = shape.columnCount;
     jsi::Array result(rt, count);
 
     // TODO: DRY with resultDictionary (but check for performance regressions)
@@ -237,20 +290,6 @@ jsi::Array Database::resultArray(sqlite3_stmt *statement) {
     return result;
 }
 
-jsi::Array Database::resultColumns(sqlite3_stmt *statement) {
-    auto &rt = getRt();
-    int count = sqlite3_column_count(statement);
-    jsi::Array columns(rt, count);
-
-    for (int i = 0; i < count; i++) {
-        const char *column = sqlite3_column_name(statement, i);
-        assert(column);
-        columns.setValueAtIndex(rt, i, jsi::String::createFromUtf8(rt, column));
-    }
-
-    return columns;
-}
-
 void Database::beginTransaction() {
     // NOTE: using exclusive transaction, because that's what FMDB does
     // In theory, `deferred` seems better, since it's less likely to get locked
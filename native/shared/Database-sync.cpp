@@ -0,0 +1,328 @@
+#include "Database.h"
+#include "TableSchema.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace watermelondb {
+
+using platform::consoleError;
+using platform::consoleLog;
+
+// Appends `text` as a JSON string literal (escaped the same way as JSON.stringify does)
+void appendJsonString(std::string &json, const char *text, size_t length) {
+    json += '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = text[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        json.append(text + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"': json += "\\\""; break;
+            case '\\': json += "\\\\"; break;
+            case '\n': json += "\\n"; break;
+            case '\r': json += "\\r"; break;
+            case '\t': json += "\\t"; break;
+            case '\b': json += "\\b"; break;
+            case '\f': json += "\\f"; break;
+            default: {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                json += escaped;
+            }
+        }
+    }
+    json.append(text + runStart, length - runStart);
+    json += '"';
+}
+
+// Appends shortest representation of a (finite) number that parses back to the same value
+void appendJsonNumber(std::string &json, double value) {
+    if (value == 0) {
+        // NOTE: -0 is sanitized to 0 in JS, too
+        json += '0';
+        return;
+    }
+    char buffer[32];
+    for (int precision = 15; precision <= 17; precision++) {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if (strtod(buffer, nullptr) == value) {
+            break;
+        }
+    }
+    json += buffer;
+}
+
+// Appends value of a column, sanitized the same way as `sanitizedRaw` in JS does it
+void appendSanitizedJsonValue(std::string &json, sqlite3_stmt *stmt, int i, const ColumnSchema &column) {
+    int type = sqlite3_column_type(stmt, i);
+
+    if (column.type == ColumnType::string) {
+        if (type == SQLITE_TEXT) {
+            appendJsonString(json, (const char *) sqlite3_column_text(stmt, i), sqlite3_column_bytes(stmt, i));
+            return;
+        }
+        json += column.isOptional ? "null" : "\"\"";
+    } else if (column.type == ColumnType::boolean) {
+        if (type == SQLITE_INTEGER || type == SQLITE_FLOAT) {
+            double value = sqlite3_column_double(stmt, i);
+            if (value == 1 || value == 0) {
+                json += value ? "true" : "false";
+                return;
+            }
+        }
+        json += column.isOptional ? "null" : "false";
+    } else if (column.type == ColumnType::number) {
+        if (type == SQLITE_INTEGER) {
+            json += std::to_string(sqlite3_column_int64(stmt, i));
+            return;
+        } else if (type == SQLITE_FLOAT) {
+            appendJsonNumber(json, sqlite3_column_double(stmt, i));
+            return;
+        }
+        json += column.isOptional ? "null" : "0";
+    }
+}
+
+// SQL selecting everything that's pushed for a record (see appendLocalChangeJson)
+std::string localChangeSelectSql(const std::string &tableName, const TableSchemaArray &columns) {
+    std::string sql = "select `id`, `_status`, `_changed";
+    for (auto const &column : columns) {
+        sql += "`, `" + column.name;
+    }
+    sql += "` from `" + tableName + "`";
+    return sql;
+}
+
+// Appends a row selected with localChangeSelectSql as a JSON object equal to sanitized raw record
+void appendLocalChangeJson(std::string &json, sqlite3_stmt *stmt, const TableSchemaArray &columns) {
+    json += "{\"id\":";
+    appendJsonString(json, (const char *) sqlite3_column_text(stmt, 0), sqlite3_column_bytes(stmt, 0));
+    json += ",\"_status\":";
+    appendJsonString(json, (const char *) sqlite3_column_text(stmt, 1), sqlite3_column_bytes(stmt, 1));
+    json += ",\"_changed\":";
+    if (sqlite3_column_type(stmt, 2) == SQLITE_TEXT) {
+        appendJsonString(json, (const char *) sqlite3_column_text(stmt, 2), sqlite3_column_bytes(stmt, 2));
+    } else {
+        json += "\"\"";
+    }
+    for (auto const &column : columns) {
+        json += ',';
+        appendJsonString(json, column.name.c_str(), column.name.size());
+        json += ':';
+        appendSanitizedJsonValue(json, stmt, column.index + 3, column);
+    }
+    json += '}';
+}
+
+// Hash of contents of a record (FNV-1a of its JSON), used to check if record changed since it was pushed
+// NOTE: Truncated to 53 bits, so that it can be passed to and from JS as a number without loss
+uint64_t localChangeHash(const char *json, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) json[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash & ((1ULL << 53) - 1);
+}
+
+jsi::Value Database::fetchLocalChangesJSON(jsi::Object &schema, jsi::Array &tables) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
+
+    auto tableSchemas = schema.getProperty(rt, "tables").getObject(rt);
+
+    std::string json = "{\"changes\":{";
+    std::string hashes = "\"hashes\":{";
+    std::string updated;
+    std::string deleted;
+
+    // NOTE: All tables are read in a single (deferred) transaction, so that they see a consistent snapshot
+    executeUpdate("begin deferred transaction");
+
+    try {
+        for (size_t t = 0, tablesCount = tables.size(rt); t < tablesCount; t++) {
+            auto tableName = tables.getValueAtIndex(rt, t).getString(rt).utf8(rt);
+            auto columns = decodeTableSchema(rt, tableSchemas.getProperty(rt, tableName.c_str()).getObject(rt));
+
+            auto stmt = prepareQuery(localChangeSelectSql(tableName, columns) +
+                                     " where `_status` in ('created', 'updated', 'deleted')");
+            SqliteStatement statement(stmt, &statementCache_);
+
+            if (t > 0) {
+                json += ',';
+                hashes += ',';
+            }
+            appendJsonString(json, tableName.c_str(), tableName.size());
+            json += ":{\"created\":[";
+            appendJsonString(hashes, tableName.c_str(), tableName.size());
+            hashes += ":{";
+            updated.clear();
+            deleted.clear();
+
+            // NOTE: Created records are written to output directly, updated/deleted ones are appended later
+            bool hasCreated = false;
+            bool hasHashes = false;
+            while (!getNextRowOrTrue(stmt)) {
+                const char *id = (const char *) sqlite3_column_text(stmt, 0);
+                const char *status = (const char *) sqlite3_column_text(stmt, 1);
+                if (!id || !status) {
+                    throw jsi::JSError(rt, "Failed to get ID or status of a record");
+                }
+
+                if (strcmp(status, "deleted") == 0) {
+                    if (!deleted.empty()) {
+                        deleted += ',';
+                    }
+                    appendJsonString(deleted, id, sqlite3_column_bytes(stmt, 0));
+                    continue;
+                }
+
+                bool isCreated = strcmp(status, "created") == 0;
+                std::string &out = isCreated ? json : updated;
+                if (isCreated ? hasCreated : !updated.empty()) {
+                    out += ',';
+                }
+                hasCreated = hasCreated || isCreated;
+
+                size_t recordStart = out.size();
+                appendLocalChangeJson(out, stmt, columns);
+
+                if (hasHashes) {
+                    hashes += ',';
+                }
+                hasHashes = true;
+                appendJsonString(hashes, id, sqlite3_column_bytes(stmt, 0));
+                hashes += ':';
+                hashes += std::to_string(localChangeHash(out.data() + recordStart, out.size() - recordStart));
+            }
+
+            json += "],\"updated\":[";
+            json += updated;
+            json += "],\"deleted\":[";
+            json += deleted;
+            json += "]}";
+            hashes += '}';
+        }
+    } catch (...) {
+        // NOTE: Not using rollback(), since there's nothing to roll back in a read-only transaction
+        commit();
+        throw;
+    }
+
+    commit();
+    json += "},";
+    json += hashes;
+    json += "}}";
+
+    return jsi::String::createFromUtf8(rt, json);
+}
+
+jsi::Value Database::markAsSynced(jsi::Object &schema, jsi::Array &operations) {
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
+
+    auto tableSchemas = schema.getProperty(rt, "tables").getObject(rt);
+    std::vector<std::pair<RecordCache::Table *, std::string>> removedIds = {};
+    // (table, ids of synced and destroyed records)
+    std::vector<std::pair<std::string, std::vector<std::string>>> changedIds = {};
+    std::string recordJson;
+
+    beginTransaction();
+    try {
+        jsi::Object result(rt);
+
+        for (size_t i = 0, len = operations.size(rt); i < len; i++) {
+            // [table, [[id, hash], ...], [deletedId, ...]]
+            auto operation = operations.getValueAtIndex(rt, i).getObject(rt).getArray(rt);
+            auto tableName = operation.getValueAtIndex(rt, 0).getString(rt).utf8(rt);
+            auto records = operation.getValueAtIndex(rt, 1).getObject(rt).getArray(rt);
+            auto deletedIds = operation.getValueAtIndex(rt, 2).getObject(rt).getArray(rt);
+            auto columns = decodeTableSchema(rt, tableSchemas.getProperty(rt, tableName.c_str()).getObject(rt));
+            auto &cachedIds = recordCache_.table(tableName);
+
+            std::vector<jsi::Value> syncedIds;
+            std::vector<jsi::Value> destroyedIds;
+            changedIds.emplace_back(tableName, std::vector<std::string>());
+            auto &tableChangedIds = changedIds.back().second;
+
+            size_t recordsCount = records.size(rt);
+            if (recordsCount) {
+                auto findStmt = prepareQuery(localChangeSelectSql(tableName, columns) + " where `id` is ?");
+                SqliteStatement findStatement(findStmt, &statementCache_);
+                auto updateStmt = prepareQuery("update `" + tableName + "` set `_status` = 'synced', `_changed` = '' where `id` is ?");
+                SqliteStatement updateStatement(updateStmt, &statementCache_);
+
+                for (size_t r = 0; r < recordsCount; r++) {
+                    auto record = records.getValueAtIndex(rt, r).getObject(rt).getArray(rt);
+                    auto id = record.getValueAtIndex(rt, 0).getString(rt).utf8(rt);
+                    auto pushedHash = (uint64_t) record.getValueAtIndex(rt, 1).getNumber();
+
+                    // Only records that didn't change since they were pushed can be marked as synced
+                    sqlite3_bind_text(findStmt, 1, id.c_str(), (int) id.length(), SQLITE_STATIC);
+                    bool isUnchanged = false;
+                    if (!getNextRowOrTrue(findStmt)) {
+                        recordJson.clear();
+                        appendLocalChangeJson(recordJson, findStmt, columns);
+                        isUnchanged = localChangeHash(recordJson.data(), recordJson.size()) == pushedHash;
+                    }
+                    sqlite3_reset(findStmt);
+
+                    if (!isUnchanged) {
+                        continue;
+                    }
+
+                    sqlite3_bind_text(updateStmt, 1, id.c_str(), (int) id.length(), SQLITE_STATIC);
+                    executeUpdate(updateStmt);
+                    sqlite3_reset(updateStmt);
+                    syncedIds.push_back(jsi::String::createFromUtf8(rt, id));
+                    tableChangedIds.push_back(std::move(id));
+                }
+            }
+
+            size_t deletedCount = deletedIds.size(rt);
+            if (deletedCount) {
+                auto deleteStmt = prepareQuery("delete from `" + tableName + "` where `id` is ?");
+                SqliteStatement deleteStatement(deleteStmt, &statementCache_);
+
+                for (size_t d = 0; d < deletedCount; d++) {
+                    auto id = deletedIds.getValueAtIndex(rt, d).getString(rt).utf8(rt);
+                    sqlite3_bind_text(deleteStmt, 1, id.c_str(), (int) id.length(), SQLITE_STATIC);
+                    executeUpdate(deleteStmt);
+                    sqlite3_reset(deleteStmt);
+                    destroyedIds.push_back(jsi::String::createFromUtf8(rt, id));
+                    if (cachedIds.contains(id)) {
+                        removedIds.emplace_back(&cachedIds, id);
+                    }
+                    tableChangedIds.push_back(std::move(id));
+                }
+            }
+
+            jsi::Object tableResult(rt);
+            tableResult.setProperty(rt, "synced", arrayFromStd(syncedIds));
+            tableResult.setProperty(rt, "destroyed", arrayFromStd(destroyedIds));
+            result.setProperty(rt, jsi::String::createFromUtf8(rt, tableName), std::move(tableResult));
+        }
+
+        commit();
+
+        for (auto const &removed : removedIds) {
+            removed.first->erase(removed.second);
+        }
+        for (auto const &changed : changedIds) {
+            queryObservers_.recordChanges(changed.first, changed.second);
+        }
+
+        return result;
+    } catch (const std::exception &ex) {
+        rollback();
+        throw;
+    }
+}
+
+} // namespace watermelondb
@@ -1,80 +1,735 @@
 #include "Database.h"
+#include "JsonStreamReader.h"
+#include "SpscQueue.h"
+#include "TableSchema.h"
+#include <thread>
+#include <memory>
+#include <algorithm>
 
 namespace watermelondb {
 
 using platform::consoleError;
 using platform::consoleLog;
 
-enum ColumnType { string, number, boolean };
-struct ColumnSchema {
-    int index;
+std::string insertSqlFor(jsi::Runtime &rt, const std::string &tableName, const TableSchemaArray &columns) {
+    std::string sql = "insert into `" + tableName + "` (`id`, `_status`, `_changed";
+    for (auto const &column : columns) {
+        sql += "`, `" + column.name;
+    }
+    sql += "`) values (?, 'synced', ''";
+    for (size_t i = 0, len = columns.size(); i < len; i++) {
+        sql += ", ?";
+    }
+    sql += ")";
+    return sql;
+}
+
+// Table schema compiled for decoding synced records. Compiled once per table per sync, and reused
+// across changesets
+struct SyncTable {
     std::string name;
-    ColumnType type;
-    bool isOptional;
+    TableSchemaArray columns;
+    std::string insertSql;
+    // Columns sorted by name, so that record fields can be looked up without allocations
+    std::vector<const ColumnSchema *> columnsByName;
+
+    // Returns column named `name`, or nullptr if there's no such column
+    const ColumnSchema *column(std::string_view name) const {
+        auto found = std::lower_bound(columnsByName.begin(), columnsByName.end(), name, [](const ColumnSchema *column, std::string_view name) {
+            return std::string_view(column->name) < name;
+        });
+        if (found == columnsByName.end() || (*found)->name != name) {
+            return nullptr;
+        }
+        return *found;
+    }
 };
 
-ColumnType columnTypeFromStr(std::string &type) {
-    if (type == "string") {
-        return ColumnType::string;
-    } else if (type == "number") {
-        return ColumnType::number;
-    } else if (type == "boolean") {
-        return ColumnType::boolean;
+// NOTE: Compiled tables must not be moved (columnsByName points into columns), hence unique_ptr. Tables
+// missing from schema are cached as nullptr
+using SyncTables = std::unordered_map<std::string, std::unique_ptr<SyncTable>>;
+
+std::unique_ptr<SyncTable> compileSyncTable(jsi::Runtime &rt, const std::string &tableName, jsi::Object schema) {
+    auto table = std::make_unique<SyncTable>();
+    table->name = tableName;
+    table->columns = decodeTableSchema(rt, std::move(schema));
+    table->insertSql = insertSqlFor(rt, tableName, table->columns);
+    for (auto const &column : table->columns) {
+        table->columnsByName.push_back(&column);
+    }
+    std::sort(table->columnsByName.begin(), table->columnsByName.end(), [](const ColumnSchema *a, const ColumnSchema *b) {
+        return a->name < b->name;
+    });
+    return table;
+}
+
+// Returns compiled schema of a table (compiling it on first use), or nullptr if table is not in schema
+const SyncTable *syncTableFor(jsi::Runtime &rt, jsi::Object &tableSchemas, SyncTables &tables, const std::string &tableName) {
+    auto found = tables.find(tableName);
+    if (found != tables.end()) {
+        return found->second.get();
+    }
+
+    auto &table = tables[tableName];
+    auto tableSchemaJsi = tableSchemas.getProperty(rt, jsi::String::createFromUtf8(rt, tableName));
+    if (tableSchemaJsi.isObject()) {
+        table = compileSyncTable(rt, tableName, tableSchemaJsi.getObject(rt));
+    }
+    return table.get();
+}
+
+// Value of a synced record's column, sanitized according to schema (same rules as sanitizedRaw)
+// NOTE: Strings point into simdjson's buffers, so they're only valid until the next document is parsed
+struct SyncRecordValue {
+    // (missing: field not in the record - sanitized, but can be told apart from an invalid value)
+    enum class Type { missing, sanitized, string, number, boolean };
+
+    const ColumnSchema *column;
+    Type type;
+    std::string_view string;
+    double number;
+};
+
+SyncRecordValue decodeSyncRecordValue(const ColumnSchema &column, simdjson::ondemand::value &value) {
+    using namespace simdjson;
+    ondemand::json_type type = value.type();
+    SyncRecordValue recordValue { &column, SyncRecordValue::Type::sanitized, {}, 0 };
+
+    if (column.type == ColumnType::string && type == ondemand::json_type::string) {
+        recordValue.type = SyncRecordValue::Type::string;
+        recordValue.string = value;
+    } else if (column.type == ColumnType::boolean) {
+        if (type == ondemand::json_type::boolean) {
+            recordValue.type = SyncRecordValue::Type::boolean;
+            recordValue.number = (bool) value;
+        } else if (type == ondemand::json_type::number && ((double) value == 0 || (double) value == 1)) {
+            recordValue.type = SyncRecordValue::Type::boolean; // needed for compat with sanitizeRaw
+            recordValue.number = (double) value;
+        }
+    } else if (column.type == ColumnType::number && type == ondemand::json_type::number) {
+        recordValue.type = SyncRecordValue::Type::number;
+        recordValue.number = (double) value;
+    }
+
+    return recordValue;
+}
+
+// Binds value that sanitizedRaw would give to a missing or invalid field
+void bindSanitizedValue(jsi::Runtime &rt, sqlite3_stmt *stmt, int argumentsIdx, const ColumnSchema &column) {
+    if (column.isOptional) {
+        sqlite3_bind_null(stmt, argumentsIdx);
     } else {
-        throw std::invalid_argument("invalid column type in schema");
+        if (column.type == ColumnType::string) {
+            sqlite3_bind_text(stmt, argumentsIdx, "", -1, SQLITE_STATIC);
+        } else if (column.type == ColumnType::boolean) {
+            sqlite3_bind_int(stmt, argumentsIdx, 0);
+        } else if (column.type == ColumnType::number) {
+            sqlite3_bind_double(stmt, argumentsIdx, 0);
+        } else {
+            throw jsi::JSError(rt, "Unknown schema type");
+        }
     }
 }
 
-using TableSchemaArray = std::vector<ColumnSchema>;
-using TableSchema = std::unordered_map<std::string, ColumnSchema>;
-std::pair<TableSchemaArray, TableSchema> decodeTableSchema(jsi::Runtime &rt, jsi::Object schema) {
-    auto columnArr = schema.getProperty(rt, "columnArray").getObject(rt).getArray(rt);
+void bindSyncRecordValue(jsi::Runtime &rt, sqlite3_stmt *stmt, int argumentsIdx, const SyncRecordValue &value) {
+    switch (value.type) {
+        case SyncRecordValue::Type::string:
+            sqlite3_bind_text(stmt, argumentsIdx, value.string.data(), (int) value.string.length(), SQLITE_STATIC);
+            break;
+        case SyncRecordValue::Type::number:
+            sqlite3_bind_double(stmt, argumentsIdx, value.number);
+            break;
+        case SyncRecordValue::Type::boolean:
+            sqlite3_bind_int(stmt, argumentsIdx, (bool) value.number);
+            break;
+        case SyncRecordValue::Type::missing:
+        case SyncRecordValue::Type::sanitized:
+            bindSanitizedValue(rt, stmt, argumentsIdx, *value.column);
+            break;
+    }
+}
 
-    TableSchemaArray columnsArray = {};
-    TableSchema columns = {};
+// Item passed from the parser thread to the writer (JS) thread of a pipelined sync
+// NOTE: Strings point into the JSON and simdjson's buffers, which outlive both threads' work
+struct SyncRowBatch {
+    enum class Type { rows, residualValue, done, error };
 
-    for (size_t i = 0, len = columnArr.size(rt); i < len; i++) {
-        auto columnObj = columnArr.getValueAtIndex(rt, i).getObject(rt);
-        auto name = columnObj.getProperty(rt, "name").getString(rt).utf8(rt);
-        auto typeStr = columnObj.getProperty(rt, "type").getString(rt).utf8(rt);
-        ColumnType type = columnTypeFromStr(typeStr);
-        auto isOptionalProp = columnObj.getProperty(rt, "isOptional");
-        bool isOptional = isOptionalProp.isBool() ? isOptionalProp.getBool() : false;
-        ColumnSchema column = { (int) i, name, type, isOptional };
+    Type type;
+    // rows: `rowCount` records of `table` - their ids, and values of all columns (in schema order)
+    const SyncTable *table;
+    size_t rowCount;
+    std::vector<std::string_view> ids;
+    std::vector<SyncRecordValue> values;
+    size_t bytesParsed; // after the last record
+    // residualValue: top-level field other than `changes`, as raw JSON
+    std::string_view key;
+    std::string_view json;
+    // error: exception thrown while parsing
+    std::exception_ptr error;
+};
 
-        columnsArray.push_back(column);
-        columns[name] = column;
+// Records per SyncRowBatch. Batches are reused, so this (times number of columns) is the only
+// allocation needed for rows
+constexpr size_t pipelinedRowsPerBatch = 256;
+// Batches that can be parsed ahead of the writer
+constexpr size_t pipelinedQueueCapacity = 8;
+
+// Decodes a synced record into a row of values of all columns (missing fields are sanitized), and returns its id
+std::string_view decodeSyncRow(const SyncTable &table, simdjson::ondemand::object &record, SyncRecordValue *row) {
+    for (auto const &column : table.columns) {
+        row[column.index] = { &column, SyncRecordValue::Type::missing, {}, 0 };
     }
 
-    return std::make_pair(columnsArray, columns);
+    std::string_view id;
+    for (auto valueField : record) {
+        std::string_view key = valueField.unescaped_key();
+        simdjson::ondemand::value value = valueField.value();
+
+        if (key == "id") {
+            id = value;
+            continue;
+        }
+
+        auto column = table.column(key);
+        if (!column) {
+            continue;
+        }
+        row[column->index] = decodeSyncRecordValue(*column, value);
+    }
+
+    if (id.data() == nullptr) {
+        throw std::invalid_argument("synced record is missing an id");
+    }
+    return id;
 }
 
-std::string insertSqlFor(jsi::Runtime &rt, std::string tableName, TableSchemaArray columns) {
-    std::string sql = "insert into `" + tableName + "` (`id`, `_status`, `_changed";
-    for (auto const &column : columns) {
-        sql += "`, `" + column.name;
+// Binds a row decoded by decodeSyncRow to an insert statement made by insertSqlFor
+void bindSyncRow(jsi::Runtime &rt, sqlite3_stmt *stmt, const SyncTable &table, std::string_view id, const SyncRecordValue *row) {
+    for (size_t i = 0, len = table.columns.size(); i < len; i++) {
+        bindSyncRecordValue(rt, stmt, (int) i + 2, row[i]);
     }
-    sql += "`) values (?, 'synced', ''";
-    for (size_t i = 0, len = columns.size(); i < len; i++) {
-        sql += ", ?";
+    sqlite3_bind_text(stmt, 1, id.data(), (int) id.length(), SQLITE_STATIC);
+}
+
+// Returns number of bytes of sync JSON parsed so far
+size_t bytesParsed(simdjson::ondemand::document &doc, const simdjson::padded_string &json) {
+    const char *location;
+    if (doc.current_location().get(location)) {
+        // Past the end of the document
+        return json.size();
     }
-    sql += ")";
-    return sql;
+    return location - json.data();
+}
+
+// Returns callback reporting sync load progress to `onProgress` JS function, or nullptr if it's not a function
+// NOTE: It's called synchronously, while the database is locked - calling the database from it throws
+// (see DatabaseLock)
+SyncLoadProgress::Callback syncLoadProgressCallback(jsi::Runtime &rt, jsi::Value &onProgress) {
+    if (!onProgress.isObject() || !onProgress.getObject(rt).isFunction(rt)) {
+        return nullptr;
+    }
+    auto function = std::make_shared<jsi::Function>(onProgress.getObject(rt).getFunction(rt));
+
+    return [&rt, function](const SyncLoadProgress &progress) {
+        jsi::Object rowsInserted(rt);
+        for (auto const &tableRows : progress.rowsInserted()) {
+            rowsInserted.setProperty(rt, jsi::String::createFromUtf8(rt, tableRows.first), (double) tableRows.second);
+        }
+
+        jsi::Object progressObj(rt);
+        progressObj.setProperty(rt, "bytesParsed", (double) progress.bytesParsed());
+        progressObj.setProperty(rt, "bytesTotal", (double) progress.bytesTotal());
+        progressObj.setProperty(rt, "rowsInserted", std::move(rowsInserted));
+
+        // Returning `false` cancels the load
+        auto result = function->call(rt, std::move(progressObj));
+        return !(result.isBool() && !result.getBool());
+    };
+}
+
+// Parser thread of a pipelined sync - parses the whole sync JSON into batches of rows, ending with
+// `done` or `error` batch. Returns early if queue is cancelled by the writer
+void parseSyncJsonPipelined(simdjson::ondemand::parser &parser,
+                            simdjson::padded_string &json,
+                            const SyncTables &tables,
+                            SpscQueue<SyncRowBatch> &queue) {
+    using namespace simdjson;
+    try {
+        ondemand::document doc = parser.iterate(json);
+
+        for (auto docField : (ondemand::object) doc) {
+            std::string_view fieldNameView = docField.unescaped_key();
+
+            if (fieldNameView != "changes") {
+                ondemand::value value = docField.value();
+                auto batch = queue.beginPush();
+                if (!batch) {
+                    return;
+                }
+                batch->type = SyncRowBatch::Type::residualValue;
+                batch->key = fieldNameView;
+                batch->json = simdjson::to_json_string(value);
+                queue.endPush();
+                continue;
+            }
+
+            ondemand::object changeSet = docField.value();
+            for (auto changeSetField : changeSet) {
+                auto tableName = (std::string) (std::string_view) changeSetField.unescaped_key();
+                ondemand::object tableChangeSet = changeSetField.value();
+                auto found = tables.find(tableName);
+                const SyncTable *table = found != tables.end() ? found->second.get() : nullptr;
+
+                for (auto tableChangeSetField : tableChangeSet) {
+                    std::string_view tableChangeSetKey = tableChangeSetField.unescaped_key();
+                    ondemand::array records = tableChangeSetField.value();
+
+                    if (tableChangeSetKey == "deleted") {
+                        if (records.begin() != records.end()) {
+                            throw std::invalid_argument("expected deleted field to be empty");
+                        }
+                        continue;
+                    } else if (tableChangeSetKey != "updated" && tableChangeSetKey != "created") {
+                        throw std::invalid_argument("bad changeset field");
+                    }
+
+                    if (!table) {
+                        continue;
+                    }
+                    size_t columnCount = table->columns.size();
+
+                    SyncRowBatch *batch = nullptr;
+                    for (ondemand::object record : records) {
+                        if (!batch) {
+                            batch = queue.beginPush();
+                            if (!batch) {
+                                return;
+                            }
+                            batch->type = SyncRowBatch::Type::rows;
+                            batch->table = table;
+                            batch->rowCount = 0;
+                            batch->ids.resize(pipelinedRowsPerBatch);
+                            batch->values.resize(pipelinedRowsPerBatch * columnCount);
+                        }
+
+                        auto row = batch->values.data() + batch->rowCount * columnCount;
+                        batch->ids[batch->rowCount] = decodeSyncRow(*table, record, row);
+
+                        if (++batch->rowCount == pipelinedRowsPerBatch) {
+                            batch->bytesParsed = bytesParsed(doc, json);
+                            queue.endPush();
+                            batch = nullptr;
+                        }
+                    }
+                    if (batch) {
+                        batch->bytesParsed = bytesParsed(doc, json);
+                        queue.endPush();
+                    }
+                }
+            }
+        }
+
+        auto batch = queue.beginPush();
+        if (batch) {
+            batch->type = SyncRowBatch::Type::done;
+            queue.endPush();
+        }
+    } catch (...) {
+        // NOTE: If we failed in the middle of a batch, it wasn't pushed, so we get the same slot back
+        auto batch = queue.beginPush();
+        if (batch) {
+            batch->type = SyncRowBatch::Type::error;
+            batch->error = std::current_exception();
+            queue.endPush();
+        }
+    }
+}
+
+// Loads sync JSON using two threads - one parsing JSON into rows, and this one (the JS thread) inserting
+// them, so that parsing and sqlite's work overlap. Must be called within a transaction
+void Database::loadSyncJsonPipelined(simdjson::padded_string &json,
+                                     jsi::Object &tableSchemas,
+                                     jsi::Object &residualValues,
+                                     SyncLoadProgress &progress) {
+    auto &rt = getRt();
+
+    // NOTE: All tables are compiled upfront, because the parser thread can't use JSI
+    SyncTables tables;
+    auto tableNames = tableSchemas.getPropertyNames(rt);
+    for (size_t i = 0, len = tableNames.size(rt); i < len; i++) {
+        syncTableFor(rt, tableSchemas, tables, tableNames.getValueAtIndex(rt, i).getString(rt).utf8(rt));
+    }
+
+    simdjson::ondemand::parser parser;
+    SpscQueue<SyncRowBatch> queue(pipelinedQueueCapacity);
+    std::thread parserThread([&]() {
+        parseSyncJsonPipelined(parser, json, tables, queue);
+    });
+
+    const SyncTable *table = nullptr;
+    sqlite3_stmt *stmt = nullptr;
+    try {
+        while (true) {
+            // NOTE: Never null - only we cancel the queue
+            auto batch = queue.beginPop();
+
+            if (batch->type == SyncRowBatch::Type::done) {
+                queue.endPop();
+                break;
+            } else if (batch->type == SyncRowBatch::Type::error) {
+                std::rethrow_exception(batch->error);
+            } else if (batch->type == SyncRowBatch::Type::residualValue) {
+                residualValues.setProperty(rt,
+                                           jsi::String::createFromUtf8(rt, (std::string) batch->key),
+                                           jsi::String::createFromUtf8(rt, (std::string) batch->json));
+            } else {
+                if (batch->table != table) {
+                    table = batch->table;
+                    stmt = prepareQuery(table->insertSql);
+                    progress.beginTable(table->name);
+                }
+
+                size_t columnCount = table->columns.size();
+                for (size_t row = 0; row < batch->rowCount; row++) {
+                    bindSyncRow(rt, stmt, *table, batch->ids[row], batch->values.data() + row * columnCount);
+                    executeUpdate(stmt);
+                    sqlite3_reset(stmt);
+                    progress.didInsertRecord(batch->bytesParsed);
+                }
+            }
+            queue.endPop();
+        }
+    } catch (...) {
+        if (stmt) {
+            sqlite3_reset(stmt);
+        }
+        queue.cancel();
+        parserThread.join();
+        throw;
+    }
+    parserThread.join();
+}
+
+// Page cache used during a bulk load, in KiB. Large enough that sqlite doesn't have to spill a big
+// transaction's dirty pages to the WAL (and read them back) while loading
+constexpr int bulkLoadCacheSize = 64 * 1024;
+
+int Database::queryInt(std::string sql) {
+    auto stmt = prepareQuery(sql);
+    SqliteStatement statement(stmt, &statementCache_);
+    getRow(stmt);
+    return sqlite3_column_int(stmt, 0);
+}
+
+// When loading into an empty database, we can trade durability for speed: disk syncs are disabled until
+// the load is done, and a larger page cache is used. To make this crash-safe, database version is
+// (durably) set to 0 until the load is committed and synced, so that if the load is interrupted,
+// `initialize` reports that schema is needed, and the database is reset, instead of being left
+// half-loaded or corrupted.
+// Must be called outside of a transaction. Returns settings to restore with endBulkLoad
+BulkLoad Database::beginBulkLoad(jsi::Object &tableSchemas) {
+    auto &rt = getRt();
+    BulkLoad bulkLoad = { false, 0, 0, 0, 0 };
+
+    // NOTE: A reset would lose local data, so we only do this if there's none
+    if (queryInt("select exists(select 1 from `local_storage`)")) {
+        return bulkLoad;
+    }
+    auto tableNames = tableSchemas.getPropertyNames(rt);
+    for (size_t i = 0, len = tableNames.size(rt); i < len; i++) {
+        auto tableName = tableNames.getValueAtIndex(rt, i).getString(rt).utf8(rt);
+        if (queryInt("select exists(select 1 from `" + tableName + "`)")) {
+            return bulkLoad;
+        }
+    }
+
+    bulkLoad.isActive = true;
+    bulkLoad.userVersion = getUserVersion();
+    bulkLoad.synchronous = queryInt("pragma synchronous");
+    bulkLoad.walAutocheckpoint = queryInt("pragma wal_autocheckpoint");
+    bulkLoad.cacheSize = queryInt("pragma cache_size");
+
+    // NOTE: Version is changed before syncs are disabled. In WAL mode, frames are only ever valid after
+    // all frames before them, so the load can't survive a crash without this change surviving it too.
+    // Checkpoints are disabled for the same reason - they'd copy pages to the database without syncing
+    setUserVersion(0);
+    executeMultiple("pragma synchronous = OFF;"
+                    "pragma wal_autocheckpoint = 0;"
+                    "pragma cache_size = -" + std::to_string(bulkLoadCacheSize) + ";");
+    return bulkLoad;
+}
+
+// Restores settings changed by beginBulkLoad. Must be called after the load is committed or rolled back
+void Database::endBulkLoad(const BulkLoad &bulkLoad) {
+    if (!bulkLoad.isActive) {
+        return;
+    }
+
+    executeMultiple("pragma synchronous = " + std::to_string(bulkLoad.synchronous) + ";"
+                    "pragma wal_autocheckpoint = " + std::to_string(bulkLoad.walAutocheckpoint) + ";"
+                    "pragma cache_size = " + std::to_string(bulkLoad.cacheSize) + ";");
+    // Syncs are enabled again, so once this is durable, so is the load
+    setUserVersion(bulkLoad.userVersion);
+}
+
+// Same as endBulkLoad, but errors are only logged, so that they don't replace the error that aborted the load
+void Database::endBulkLoadAfterError(const BulkLoad &bulkLoad) {
+    try {
+        endBulkLoad(bulkLoad);
+    } catch (const std::exception &ex) {
+        consoleError("Failed to restore settings after a failed bulk load: " + std::string(ex.what()));
+    }
+}
+
+jsi::Value Database::unsafeLoadFromSync(int jsonId, jsi::Object &schema, std::string preamble, std::string postamble, jsi::Value &onProgress) {
+    using namespace simdjson;
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
+
+    jsi::Object residualValues(rt);
+    auto tableSchemas = schema.getProperty(rt, "tables").getObject(rt);
+    auto bulkLoad = beginBulkLoad(tableSchemas);
+    beginTransaction();
+
+    try {
+        // NOTE: Preamble drops indices, and postamble recreates them, which is much faster than
+        // updating them on every insert
+        executeMultiple(preamble);
+
+        auto json = padded_string(platform::getSyncJson(jsonId));
+        SyncLoadProgress progress(json.size(), syncLoadProgressCallback(rt, onProgress));
+
+        // On multi-core devices, parsing JSON and inserting records are done in parallel
+        if (std::thread::hardware_concurrency() > 1) {
+            loadSyncJsonPipelined(json, tableSchemas, residualValues, progress);
+        } else {
+            ondemand::parser parser;
+            SyncTables tables;
+            std::vector<SyncRecordValue> row;
+            ondemand::document doc = parser.iterate(json);
+
+            // NOTE: simdjson::ondemand processes forwards-only, hence the weird field enumeration
+            // We can't use subscript or backtrack.
+            for (auto docField : (ondemand::object) doc) {
+                std::string_view fieldNameView = docField.unescaped_key();
+
+                if (fieldNameView != "changes") {
+                    ondemand::value value = docField.value();
+                    std::string_view valueJson = simdjson::to_json_string(value);
+                    residualValues.setProperty(rt,
+                                               jsi::String::createFromUtf8(rt, (std::string) fieldNameView),
+                                               jsi::String::createFromUtf8(rt, (std::string) valueJson));
+                } else {
+                    ondemand::object changeSet = docField.value();
+                    for (auto changeSetField : changeSet) {
+                        auto tableName = (std::string) (std::string_view) changeSetField.unescaped_key();
+                        ondemand::object tableChangeSet = changeSetField.value();
+
+                        for (auto tableChangeSetField : tableChangeSet) {
+                            std::string_view tableChangeSetKey = tableChangeSetField.unescaped_key();
+                            ondemand::array records = tableChangeSetField.value();
+
+                            if (tableChangeSetKey == "deleted") {
+                                if (records.begin() != records.end()) {
+                                    throw jsi::JSError(rt, "expected deleted field to be empty");
+                                }
+                                continue;
+                            } else if (tableChangeSetKey != "updated" && tableChangeSetKey != "created") {
+                                throw jsi::JSError(rt, "bad changeset field");
+                            }
+
+                            auto table = syncTableFor(rt, tableSchemas, tables, tableName);
+                            if (!table) {
+                                continue;
+                            }
+
+                            sqlite3_stmt *stmt = prepareQuery(table->insertSql);
+                            SqliteStatement statement(stmt, &statementCache_);
+                            row.resize(table->columns.size());
+                            progress.beginTable(tableName);
+
+                            for (ondemand::object record : records) {
+                                auto id = decodeSyncRow(*table, record, row.data());
+                                bindSyncRow(rt, stmt, *table, id, row.data());
+                                executeUpdate(stmt);
+                                sqlite3_reset(stmt);
+                                progress.didInsertRecord(bytesParsed(doc, json));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        progress.finish(json.size());
+        executeMultiple(postamble);
+        commit();
+    } catch (const std::exception &ex) {
+        platform::deleteSyncJson(jsonId);
+        rollback();
+        endBulkLoadAfterError(bulkLoad);
+        throw;
+    }
+
+    platform::deleteSyncJson(jsonId);
+    endBulkLoad(bulkLoad);
+    queryObservers_.invalidateAll();
+    return residualValues;
 }
 
-jsi::Value Database::unsafeLoadFromSync(int jsonId, jsi::Object &schema, std::string preamble, std::string postamble) {
+jsi::Value Database::unsafeLoadFromSyncFile(std::string path, jsi::Object &schema, std::string preamble, std::string postamble, jsi::Value &onProgress) {
     using namespace simdjson;
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
+
+    jsi::Object residualValues(rt);
+    auto tableSchemas = schema.getProperty(rt, "tables").getObject(rt);
+    auto bulkLoad = beginBulkLoad(tableSchemas);
     beginTransaction();
 
     try {
         executeMultiple(preamble);
 
+        // NOTE: Unlike unsafeLoadFromSync, the file is never loaded into memory as a whole. We walk
+        // the outer structure of the document, and only parse records with simdjson, one at a time, so
+        // memory use is bounded by the size of the largest record, not the whole sync
+        JsonStreamReader reader(path);
+        SyncLoadProgress progress(reader.size(), syncLoadProgressCallback(rt, onProgress));
+        ondemand::parser parser;
+        std::string valueJson;
+        SyncTables tables;
+        std::vector<SyncRecordValue> row;
+
+        reader.expect('{');
+        if (!reader.consume('}')) {
+            do {
+                auto fieldName = reader.readString();
+                reader.expect(':');
+
+                if (fieldName != "changes") {
+                    reader.readValue(valueJson);
+                    residualValues.setProperty(rt,
+                                               jsi::String::createFromUtf8(rt, fieldName),
+                                               jsi::String::createFromUtf8(rt, valueJson));
+                    continue;
+                }
+
+                reader.expect('{');
+                if (reader.consume('}')) {
+                    continue;
+                }
+                do {
+                    auto tableName = reader.readString();
+                    reader.expect(':');
+                    reader.expect('{');
+                    if (reader.consume('}')) {
+                        continue;
+                    }
+                    do {
+                        auto tableChangeSetKey = reader.readString();
+                        reader.expect(':');
+                        reader.expect('[');
+
+                        if (tableChangeSetKey == "deleted") {
+                            if (!reader.consume(']')) {
+                                throw jsi::JSError(rt, "expected deleted field to be empty");
+                            }
+                            continue;
+                        } else if (tableChangeSetKey != "updated" && tableChangeSetKey != "created") {
+                            throw jsi::JSError(rt, "bad changeset field");
+                        }
+
+                        if (reader.consume(']')) {
+                            continue;
+                        }
+
+                        auto table = syncTableFor(rt, tableSchemas, tables, tableName);
+                        if (!table) {
+                            // Unknown table - skip its records
+                            do {
+                                reader.readValue(valueJson);
+                            } while (reader.consume(','));
+                            reader.expect(']');
+                            continue;
+                        }
+
+                        sqlite3_stmt *stmt = prepareQuery(table->insertSql);
+                        SqliteStatement statement(stmt, &statementCache_);
+                        row.resize(table->columns.size());
+                        progress.beginTable(tableName);
+
+                        do {
+                            reader.readValue(valueJson);
+                            auto valueJsonLength = valueJson.length();
+                            valueJson.append(SIMDJSON_PADDING, ' ');
+                            ondemand::document doc = parser.iterate(padded_string_view(valueJson.data(), valueJsonLength, valueJson.length()));
+                            ondemand::object record = doc;
+                            auto id = decodeSyncRow(*table, record, row.data());
+                            bindSyncRow(rt, stmt, *table, id, row.data());
+
+                            executeUpdate(stmt);
+                            sqlite3_reset(stmt);
+                            progress.didInsertRecord(reader.bytesRead());
+                        } while (reader.consume(','));
+                        reader.expect(']');
+                    } while (reader.consume(','));
+                    reader.expect('}');
+                } while (reader.consume(','));
+                reader.expect('}');
+            } while (reader.consume(','));
+            reader.expect('}');
+        }
+
+        progress.finish(reader.bytesRead());
+        executeMultiple(postamble);
+        commit();
+    } catch (const std::exception &ex) {
+        rollback();
+        endBulkLoadAfterError(bulkLoad);
+        throw;
+    }
+
+    endBulkLoad(bulkLoad);
+    queryObservers_.invalidateAll();
+    return residualValues;
+}
+
+// Returns whether `column` is one of columns in `changed` (comma-separated list of locally changed columns)
+bool isLocallyChanged(std::string_view changed, const std::string &column) {
+    while (!changed.empty()) {
+        auto separator = changed.find(',');
+        if (changed.substr(0, separator) == column) {
+            return true;
+        }
+        if (separator == std::string_view::npos) {
+            break;
+        }
+        changed.remove_prefix(separator + 1);
+    }
+    return false;
+}
+
+jsi::Value Database::unsafeLoadIncrementalFromSync(int jsonId, jsi::Object &schema) {
+    using namespace simdjson;
+    auto &rt = getRt();
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
+    beginTransaction();
+
+    // Ids of records whose JS models are cached, and must be refreshed/removed by JS
+    std::vector<std::pair<RecordCache::Table *, std::string>> removedIds = {};
+
+    try {
         jsi::Object residualValues(rt);
+        jsi::Object changes(rt);
         auto tableSchemas = schema.getProperty(rt, "tables").getObject(rt);
 
         ondemand::parser parser;
+        SyncTables tables;
+        std::vector<SyncRecordValue> row;
+        std::vector<std::string_view> updateColumns;
+        std::vector<const SyncRecordValue *> updateValues;
         auto json = padded_string(platform::getSyncJson(jsonId));
         ondemand::document doc = parser.iterate(json);
 
@@ -89,101 +744,175 @@ jsi::Value Database::unsafeLoadFromSync(int jsonId, jsi::Object &schema, std::st
                 residualValues.setProperty(rt,
                                            jsi::String::createFromUtf8(rt, (std::string) fieldNameView),
                                            jsi::String::createFromUtf8(rt, (std::string) valueJson));
-            } else {
-                ondemand::object changeSet = docField.value();
-                for (auto changeSetField : changeSet) {
-                    auto tableName = (std::string) (std::string_view) changeSetField.unescaped_key();
-                    ondemand::object tableChangeSet = changeSetField.value();
+                continue;
+            }
 
-                    for (auto tableChangeSetField : tableChangeSet) {
-                        std::string_view tableChangeSetKey = tableChangeSetField.unescaped_key();
-                        ondemand::array records = tableChangeSetField.value();
+            ondemand::object changeSet = docField.value();
+            for (auto changeSetField : changeSet) {
+                auto tableName = (std::string) (std::string_view) changeSetField.unescaped_key();
+                ondemand::object tableChangeSet = changeSetField.value();
 
-                        if (tableChangeSetKey == "deleted") {
-                            if (records.begin() != records.end()) {
-                                throw jsi::JSError(rt, "expected deleted field to be empty");
-                            }
-                            continue;
-                        } else if (tableChangeSetKey != "updated" && tableChangeSetKey != "created") {
-                            throw jsi::JSError(rt, "bad changeset field");
+                auto table = syncTableFor(rt, tableSchemas, tables, tableName);
+                if (!table) {
+                    continue;
+                }
+                auto &cachedIds = recordCache_.table(tableName);
+
+                std::vector<jsi::Value> updatedIds;
+                std::vector<jsi::Value> destroyedIds;
+                std::vector<std::string> cachedUpdatedIds;
+
+                for (auto tableChangeSetField : tableChangeSet) {
+                    std::string_view tableChangeSetKey = tableChangeSetField.unescaped_key();
+                    ondemand::array records = tableChangeSetField.value();
+
+                    if (tableChangeSetKey == "deleted") {
+                        std::vector<std::string> ids;
+                        for (std::string_view id : records) {
+                            ids.emplace_back(id);
                         }
 
-                        auto tableSchemaJsi = tableSchemas.getProperty(rt, jsi::String::createFromUtf8(rt, tableName));
-                        if (!tableSchemaJsi.isObject()) {
-                            continue;
+                        // Delete in batches, `where id in (...)`
+                        int maxArgsCount = sqlite3_limit(db_->sqlite, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+                        size_t idx = 0;
+                        while (idx < ids.size()) {
+                            int count = (int) std::min(ids.size() - idx, (size_t) maxArgsCount);
+                            std::string sql = "delete from `" + tableName + "` where `id` in (?";
+                            for (int i = 1; i < count; i++) {
+                                sql += ", ?";
+                            }
+                            sql += ")";
+
+                            auto stmt = prepareQuery(sql);
+                            SqliteStatement statement(stmt, &statementCache_);
+                            for (int i = 0; i < count; i++) {
+                                auto &id = ids[idx + i];
+                                sqlite3_bind_text(stmt, i + 1, id.data(), (int) id.length(), SQLITE_STATIC);
+                            }
+                            executeUpdate(stmt);
+                            idx += count;
                         }
-                        auto tableSchemas = decodeTableSchema(rt, tableSchemaJsi.getObject(rt));
-                        auto tableSchemaArray = tableSchemas.first;
-                        auto tableSchema = tableSchemas.second;
-
-                        sqlite3_stmt *stmt = prepareQuery(insertSqlFor(rt, tableName, tableSchemaArray));
-                        SqliteStatement statement(stmt);
-
-                        for (ondemand::object record : records) {
-                            // TODO: It would be much more natural to iterate over schema, and then get json's field
-                            // and not the other way around, but simdjson doesn't allow us to do that right now
-                            // I think 1.0 will allow subscripting objects even if it means backtracking
-                            // So we need this stupid hack where we pre-bind null/0/false/'' to sanitize missing fields
-                            for (auto column : tableSchemaArray) {
-                                auto argumentsIdx = column.index + 2;
-                                if (column.isOptional) {
-                                    sqlite3_bind_null(stmt, argumentsIdx);
-                                } else {
-                                    if (column.type == ColumnType::string) {
-                                        sqlite3_bind_text(stmt, argumentsIdx, "", -1, SQLITE_STATIC);
-                                    } else if (column.type == ColumnType::boolean) {
-                                        sqlite3_bind_int(stmt, argumentsIdx, 0);
-                                    } else if (column.type == ColumnType::number) {
-                                        sqlite3_bind_double(stmt, argumentsIdx, 0);
-                                    } else {
-                                        throw jsi::JSError(rt, "Unknown schema type");
-                                    }
-                                }
+
+                        for (auto &id : ids) {
+                            destroyedIds.push_back(jsi::String::createFromUtf8(rt, id));
+                            if (cachedIds.contains(id)) {
+                                removedIds.emplace_back(&cachedIds, std::move(id));
                             }
+                        }
+                        continue;
+                    } else if (tableChangeSetKey != "updated" && tableChangeSetKey != "created") {
+                        throw jsi::JSError(rt, "bad changeset field");
+                    }
+                    bool isCreated = tableChangeSetKey == "created";
 
-                            for (auto valueField : record) {
-                                auto key = (std::string) (std::string_view) valueField.unescaped_key();
-                                auto value = valueField.value();
+                    sqlite3_stmt *insertStmt = prepareQuery(table->insertSql);
+                    SqliteStatement insertStatement(insertStmt, &statementCache_);
+                    sqlite3_stmt *findStmt = prepareQuery("select `_status`, `_changed` from `" + tableName + "` where `id` is ?");
+                    SqliteStatement findStatement(findStmt, &statementCache_);
 
-                                if (key == "id") {
-                                    std::string_view idView = value;
-                                    sqlite3_bind_text(stmt, 1, idView.data(), (int) idView.length(), SQLITE_STATIC);
-                                    continue;
+                    row.resize(table->columns.size());
+                    for (ondemand::object record : records) {
+                        auto id = decodeSyncRow(*table, record, row.data());
+
+                        sqlite3_bind_text(findStmt, 1, id.data(), (int) id.length(), SQLITE_STATIC);
+                        bool exists = !getNextRowOrTrue(findStmt);
+                        std::string status;
+                        std::string changed;
+                        if (exists) {
+                            auto statusText = sqlite3_column_text(findStmt, 0);
+                            auto changedText = sqlite3_column_text(findStmt, 1);
+                            status = statusText ? (const char *) statusText : "";
+                            changed = changedText ? (const char *) changedText : "";
+                        }
+                        sqlite3_reset(findStmt);
+
+                        if (exists && status == "deleted") {
+                            if (!isCreated) {
+                                // Locally deleted, deletion will be pushed later
+                                continue;
+                            }
+                            // Server wants to (re)create a record deleted locally (probably a partially executed
+                            // sync) - replace it
+                            auto deleteStmt = prepareQuery("delete from `" + tableName + "` where `id` is ?");
+                            SqliteStatement deleteStatement(deleteStmt, &statementCache_);
+                            sqlite3_bind_text(deleteStmt, 1, id.data(), (int) id.length(), SQLITE_STATIC);
+                            executeUpdate(deleteStmt);
+                            exists = false;
+                        }
+
+                        if (!exists) {
+                            bindSyncRow(rt, insertStmt, *table, id, row.data());
+                            executeUpdate(insertStmt);
+                            sqlite3_reset(insertStmt);
+                        } else {
+                            // Update columns sent by server, except ones changed locally (those win, and will be pushed)
+                            // _status and _changed are left as is
+                            // NOTE: Columns missing from the remote record keep their local values, same as in JS,
+                            // where the remote raw is applied on top of the local one (see resolveConflict)
+                            updateColumns.clear();
+                            updateValues.clear();
+                            for (auto const &value : row) {
+                                if (value.type != SyncRecordValue::Type::missing &&
+                                    (changed.empty() || !isLocallyChanged(changed, value.column->name))) {
+                                    updateColumns.push_back(value.column->name);
+                                    updateValues.push_back(&value);
                                 }
+                            }
 
-                                try {
-                                    auto &column = tableSchema.at(key);
-                                    ondemand::json_type type = value.type();
-                                    auto argumentsIdx = column.index + 2;
-
-                                    if (column.type == ColumnType::string && type == ondemand::json_type::string) {
-                                        std::string_view stringView = value;
-                                        sqlite3_bind_text(stmt, argumentsIdx, stringView.data(), (int) stringView.length(), SQLITE_STATIC);
-                                    } else if (column.type == ColumnType::boolean) {
-                                        if (type == ondemand::json_type::boolean) {
-                                            sqlite3_bind_int(stmt, argumentsIdx, (bool) value);
-                                        } else if (type == ondemand::json_type::number && ((double) value == 0 || (double) value == 1)) {
-                                            sqlite3_bind_int(stmt, argumentsIdx, (bool) (double) value); // needed for compat with sanitizeRaw
-                                        }
-                                    } else if (column.type == ColumnType::number && type == ondemand::json_type::number) {
-                                        sqlite3_bind_double(stmt, argumentsIdx, (double) value);
-                                    }
-                                } catch (const std::out_of_range &ex) {
-                                    continue;
+                            if (!updateColumns.empty()) {
+                                auto partialUpdate = partialUpdateSql_.statementFor(tableName, updateColumns);
+                                auto updateStmt = prepareQuery(*partialUpdate.sql);
+                                SqliteStatement updateStatement(updateStmt, &statementCache_);
+                                sqlite3_bind_text(updateStmt, partialUpdate.placeholders[0], id.data(), (int) id.length(), SQLITE_STATIC);
+                                for (size_t i = 0; i < updateValues.size(); i++) {
+                                    bindSyncRecordValue(rt, updateStmt, partialUpdate.placeholders[i + 1], *updateValues[i]);
                                 }
+                                executeUpdate(updateStmt);
                             }
+                        }
 
-                            executeUpdate(stmt);
-                            sqlite3_reset(stmt);
+                        updatedIds.push_back(jsi::String::createFromUtf8(rt, (const uint8_t *) id.data(), id.length()));
+                        if (cachedIds.contains(id)) {
+                            cachedUpdatedIds.emplace_back(id);
+                        }
+                    }
+                }
+
+                // Send fresh raws of records that JS has cached, so that it can update them in place
+                std::vector<jsi::Value> cachedRecords;
+                if (!cachedUpdatedIds.empty()) {
+                    auto stmt = prepareQuery("select * from `" + tableName + "` where `id` is ?");
+                    SqliteStatement statement(stmt, &statementCache_);
+                    auto shape = resultShape(stmt);
+                    for (auto &id : cachedUpdatedIds) {
+                        sqlite3_bind_text(stmt, 1, id.data(), (int) id.length(), SQLITE_STATIC);
+                        if (!getNextRowOrTrue(stmt)) {
+                            cachedRecords.push_back(resultDictionary(stmt, shape));
                         }
+                        sqlite3_reset(stmt);
                     }
                 }
+
+                jsi::Object tableChanges(rt);
+                tableChanges.setProperty(rt, "updated", arrayFromStd(updatedIds));
+                tableChanges.setProperty(rt, "destroyed", arrayFromStd(destroyedIds));
+                tableChanges.setProperty(rt, "cachedRecords", arrayFromStd(cachedRecords));
+                changes.setProperty(rt, jsi::String::createFromUtf8(rt, tableName), std::move(tableChanges));
             }
         }
-        executeMultiple(postamble);
+
         commit();
         platform::deleteSyncJson(jsonId);
-        return residualValues;
+
+        for (auto const &removed : removedIds) {
+            removed.first->erase(removed.second);
+        }
+        queryObservers_.invalidateAll();
+
+        jsi::Object result(rt);
+        result.setProperty(rt, "residualValues", std::move(residualValues));
+        result.setProperty(rt, "changes", std::move(changes));
+        return result;
     } catch (const std::exception &ex) {
         platform::deleteSyncJson(jsonId);
         rollback();
@@ -5,8 +5,22 @@ namespace watermelondb {
 using platform::consoleError;
 using platform::consoleLog;
 
-Database::Database(jsi::Runtime *runtime, std::string path, bool usesExclusiveLocking) : runtime_(runtime), mutex_() {
+Database::Database(jsi::Runtime *runtime, std::string path, bool usesExclusiveLocking, int asyncReaderConnections)
+    : initialized_(false),
+      isDestroyed_(false),
+      mutex_(),
+      lockingThread_(std::thread::id()),
+      runtime_(runtime),
+      path_(path),
+      usesExclusiveLocking_(usesExclusiveLocking),
+      asyncReaderConnections_(asyncReaderConnections),
+      asyncResults_(std::make_shared<AsyncResults>()),
+      nextPromiseId_(0) {
     db_ = std::make_unique<SqliteDb>(path);
+    changeFeed_.attach(db_->sqlite);
+    statementCache_.onEvict([this](sqlite3_stmt *statement) {
+        resultShapes_.erase(statement);
+    });
 
     std::string initSql = "";
 
@@ -40,17 +54,22 @@ Database::Database(jsi::Runtime *runtime, std::string path, bool usesExclusiveLo
 }
 
 void Database::destroy() {
-    const std::lock_guard<std::mutex> lock(mutex_);
+    const DatabaseLock lock(*this);
 
     if (isDestroyed_) {
         return;
     }
     isDestroyed_ = true;
-    for (auto const &cachedStatement : cachedStatements_) {
-        sqlite3_stmt *statement = cachedStatement.second;
-        sqlite3_finalize(statement);
+    if (reader_) {
+        reader_->destroy();
     }
-    cachedStatements_ = {};
+    if (writer_) {
+        // NOTE: This waits for pending writes to be committed
+        writer_->destroy();
+    }
+    finalizeAllCursors();
+    statementCache_.clear();
+    resultShapes_.clear();
     db_->destroy();
 }
 
@@ -58,19 +77,10 @@ Database::~Database() {
     destroy();
 }
 
-bool Database::isCached(std::string cacheKey) {
-    return cachedRecords_.find(cacheKey) != cachedRecords_.end();
-}
-void Database::markAsCached(std::string cacheKey) {
-    cachedRecords_.insert(cacheKey);
-}
-void Database::removeFromCache(std::string cacheKey) {
-    cachedRecords_.erase(cacheKey);
-}
-
 void Database::unsafeResetDatabase(jsi::String &schema, int schemaVersion) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
 
     // TODO: in non-memory mode, just delete the DB files
     // NOTE: As of iOS 14, selecting tables from sqlite_master and deleting them does not work
@@ -80,22 +90,30 @@ void Database::unsafeResetDatabase(jsi::String &schema, int schemaVersion) {
     if (sqlite3_db_config(db_->sqlite, SQLITE_DBCONFIG_RESET_DATABASE, 1, 0) != SQLITE_OK) {
         throw jsi::JSError(rt, "Failed to enable reset database mode");
     }
-    // NOTE: We can't VACUUM in a transaction
+    // NOTE: We can't VACUUM in a transaction, or with statements in progress
+    finalizeAllCursors();
     executeMultiple("vacuum");
 
     if (sqlite3_db_config(db_->sqlite, SQLITE_DBCONFIG_RESET_DATABASE, 0, 0) != SQLITE_OK) {
         throw jsi::JSError(rt, "Failed to disable reset database mode");
     }
 
+    if (writer_) {
+        writer_->clearCaches();
+    }
+
     beginTransaction();
     try {
-        cachedRecords_ = {};
+        recordCache_.clear();
+        partialUpdateSql_.clear();
+        multiRowInsertSql_.clear();
 
         // Reinitialize schema
         executeMultiple(schema.utf8(rt));
         setUserVersion(schemaVersion);
 
         commit();
+        queryObservers_.invalidateAll();
     } catch (const std::exception &ex) {
         rollback();
         throw;
@@ -104,7 +122,8 @@ void Database::unsafeResetDatabase(jsi::String &schema, int schemaVersion) {
 
 void Database::migrate(jsi::String &migrationSql, int fromVersion, int toVersion) {
     auto &rt = getRt();
-    const std::lock_guard<std::mutex> lock(mutex_);
+    const DatabaseLock lock(*this);
+    waitForAsyncWrites();
 
     beginTransaction();
     try {
@@ -114,6 +133,11 @@ void Database::migrate(jsi::String &migrationSql, int fromVersion, int toVersion
         setUserVersion(toVersion);
 
         commit();
+        partialUpdateSql_.clear();
+        multiRowInsertSql_.clear();
+        if (writer_) {
+            writer_->clearCaches();
+        }
     } catch (const std::exception &ex) {
         rollback();
         throw;
@@ -4,6 +4,10 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <optional>
 #include <sqlite3.h>
 
 // FIXME: Make these paths consistent across platforms
@@ -17,58 +21,213 @@
 #endif
 
 #include "Sqlite.h"
+#include "RecordCache.h"
+#include "ChangeFeed.h"
+#include "QueryObservers.h"
+#include "QuerySql.h"
+#include "StatementCache.h"
+#include "PartialUpdateSql.h"
+#include "MultiRowInsertSql.h"
+#include "BatchExecutor.h"
+#include "SyncLoadProgress.h"
+#include "QueryCursor.h"
+#include "AsyncReader.h"
+#include "AsyncWriter.h"
 #include "DatabasePlatform.h"
 
 using namespace facebook;
 
 namespace watermelondb {
 
-class Database : public jsi::HostObject {
+// Column names of results of a statement, made once per call (see resultShape)
+// NOTE: JSI values are never cached across calls, since they must not outlive the runtime (and cache
+// eviction can happen at any time)
+struct ResultShape {
+    int columnCount;
+    std::vector<jsi::PropNameID> columnNames;
+};
+
+enum class AsyncQueryType { query, queryIds, unsafeQueryRaw, count };
+
+class Database;
+
+// Results of async operations, computed on worker threads and waiting to be passed back to JS.
+// NOTE: Shared with worker threads instead of the Database itself, so that a Database is never
+// destroyed (and its threads joined) on one of its own threads. Results must not contain JSI values
+struct AsyncResults {
+    using Result = std::function<void(Database &database)>; // called on the JS thread
+    std::mutex mutex;
+    std::vector<Result> pending;
+    // Record cache changes of committed async batches, to be applied before the cache is used again
+    // (see Database::holdAsyncCommits)
+    std::vector<BatchExecutor::CacheChanges> cacheChanges;
+    std::atomic<bool> canRunOnJsThread { true }; // false if a result couldn't be posted to the JS thread
+};
+
+// Locks the database for the duration of a call. If the database is called re-entrantly - from a JS
+// callback called by native code while the database is locked (e.g. turbo sync progress) - this throws
+// instead of deadlocking (the mutex isn't recursive)
+class DatabaseLock {
+public:
+    DatabaseLock(Database &database);
+    ~DatabaseLock();
+
+    DatabaseLock &operator=(const DatabaseLock &) = delete;
+    DatabaseLock(const DatabaseLock &) = delete;
+
+private:
+    Database &database_;
+};
+
+// Promise of an async operation, settled once its result is back on the JS thread
+struct PendingPromise {
+    jsi::Function resolve;
+    jsi::Function reject;
+};
+
+// Connection settings changed for the duration of a bulk load (see beginBulkLoad), to be restored afterwards
+struct BulkLoad {
+    bool isActive;
+    int userVersion;
+    int synchronous;
+    int walAutocheckpoint;
+    int cacheSize;
+};
+
+class Database : public jsi::HostObject, public std::enable_shared_from_this<Database> {
 public:
     static void install(jsi::Runtime *runtime);
-    Database(jsi::Runtime *runtime, std::string path, bool usesExclusiveLocking);
+    Database(jsi::Runtime *runtime, std::string path, bool usesExclusiveLocking, int asyncReaderConnections);
     ~Database();
     void destroy();
 
     jsi::Value find(jsi::String &tableName, jsi::String &id);
+    jsi::Array findMany(jsi::String &tableName, jsi::Array &ids);
     jsi::Value query(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments);
     jsi::Value queryAsArray(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments);
+    jsi::Value queryColumnar(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments);
     jsi::Array queryIds(jsi::String &sql, jsi::Array &arguments);
     jsi::Array unsafeQueryRaw(jsi::String &sql, jsi::Array &arguments);
     jsi::Value count(jsi::String &sql, jsi::Array &arguments);
-    void batch(jsi::Array &operations);
-    void batchJSON(jsi::String &&operationsJson);
-    jsi::Value unsafeLoadFromSync(int jsonId, jsi::Object &schema, std::string preamble, std::string postamble);
+    jsi::Array encodeQuery(jsi::Object &query, bool countMode);
+    jsi::Value queryEncoded(jsi::Object &query);
+    jsi::Value countEncoded(jsi::Object &query);
+    jsi::Array multiQuery(jsi::Array &operations);
+    jsi::Value queryAsync(AsyncQueryType type, jsi::String &tableName, jsi::String &sql, jsi::Array &arguments);
+    std::shared_ptr<QueryCursor> queryCursor(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments);
+    jsi::Array cursorNext(QueryCursor &cursor, size_t count);
+    void closeCursor(QueryCursor &cursor);
+    jsi::Value observeQuery(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments, jsi::Array &tables, bool isIncremental, const jsi::Value &conditions);
+    void unobserveQuery(int observerId);
+    jsi::Value fetchQueryObserverChanges(int observerId);
+    jsi::Value batch(jsi::Array &operations);
+    jsi::Value batchJSON(jsi::String &&operationsJson);
+    jsi::Value batchBinary(jsi::ArrayBuffer &buffer);
+    jsi::Value batchJSONAsync(jsi::String &&operationsJson);
+    jsi::Value unsafeLoadFromSync(int jsonId, jsi::Object &schema, std::string preamble, std::string postamble, jsi::Value &onProgress);
+    jsi::Value unsafeLoadFromSyncFile(std::string path, jsi::Object &schema, std::string preamble, std::string postamble, jsi::Value &onProgress);
+    jsi::Value unsafeLoadIncrementalFromSync(int jsonId, jsi::Object &schema);
+    jsi::Value fetchLocalChangesJSON(jsi::Object &schema, jsi::Array &tables);
+    jsi::Value markAsSynced(jsi::Object &schema, jsi::Array &operations);
     void unsafeResetDatabase(jsi::String &schema, int schemaVersion);
     jsi::Value getLocal(jsi::String &key);
     void executeMultiple(std::string sql);
+    jsi::Value unsafeExecuteMultiple(std::string sql);
+    jsi::Value getStatementCacheStats();
 
 private:
+    friend class QueryCursor;
+    friend class DatabaseLock;
+
     bool initialized_;
     bool isDestroyed_;
-    std::mutex mutex_;
+    std::mutex mutex_; // NOTE: Use DatabaseLock
+    std::atomic<std::thread::id> lockingThread_;
     jsi::Runtime *runtime_; // TODO: std::shared_ptr would be better, but I don't know how to make it from void* in RCTCxxBridge
+    std::string path_;
+    bool usesExclusiveLocking_;
+    int asyncReaderConnections_;
     std::unique_ptr<SqliteDb> db_;
-    std::unordered_map<std::string, sqlite3_stmt *> cachedStatements_; // NOTE: may contain null pointers!
-    std::unordered_set<std::string> cachedRecords_;
+    std::unique_ptr<AsyncReader> reader_; // NOTE: lazily created, see asyncReader()
+    std::unique_ptr<AsyncWriter> writer_; // NOTE: lazily created, see asyncWriter()
+    StatementCache statementCache_;
+    PartialUpdateSql partialUpdateSql_;
+    MultiRowInsertSql multiRowInsertSql_;
+    std::unordered_map<sqlite3_stmt *, std::vector<std::string>> resultShapes_; // statement -> column names
+    RecordCache recordCache_;
+    ChangeFeed changeFeed_;
+    QueryObservers queryObservers_;
+    // NOTE: Cursors can be destroyed by JS GC in the middle of another Database call, so cursor bookkeeping
+    // is guarded by a separate mutex, which is never held while calling into JSI or sqlite
+    std::mutex cursorsMutex_;
+    std::unordered_set<QueryCursor *> openCursors_; // NOTE: Guarded by cursorsMutex_
+    std::vector<sqlite3_stmt *> abandonedCursorStatements_; // of cursors destroyed while open. Guarded by cursorsMutex_
+    std::shared_ptr<AsyncResults> asyncResults_;
+    std::unordered_map<int, PendingPromise> pendingPromises_; // promise id -> promise. JS thread only
+    int nextPromiseId_;
 
     jsi::Runtime &getRt();
     jsi::JSError dbError(std::string description);
 
     sqlite3_stmt* prepareQuery(std::string sql);
     void bindArgs(sqlite3_stmt *statement, jsi::Array &arguments);
-    std::string bindArgsAndReturnId(sqlite3_stmt *statement, simdjson::ondemand::array &args);
+    void bindArgs(sqlite3_stmt *statement, const std::vector<SqliteValue> &arguments);
     SqliteStatement executeQuery(std::string sql, jsi::Array &arguments);
+    SqliteStatement executeQuery(std::string sql, const std::vector<SqliteValue> &arguments);
     void executeUpdate(sqlite3_stmt *statement);
-    void executeUpdate(std::string sql, jsi::Array &arguments);
     void executeUpdate(std::string sql);
     void getRow(sqlite3_stmt *stmt);
     bool getNextRowOrTrue(sqlite3_stmt *stmt);
-    jsi::Object resultDictionary(sqlite3_stmt *statement);
-    jsi::Array resultArray(sqlite3_stmt *statement);
-    jsi::Array resultColumns(sqlite3_stmt *statement);
+    jsi::Value findImpl(jsi::String &tableName, jsi::String &id);
+    jsi::Array findManyImpl(jsi::String &tableName, jsi::Array &ids);
+    jsi::Value queryImpl(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments);
+    jsi::Value queryRecords(const std::string &tableName, sqlite3_stmt *statement);
+    jsi::Value queryAsArrayImpl(jsi::String &tableName, jsi::String &sql, jsi::Array &arguments);
+    jsi::Array queryIdsImpl(jsi::String &sql, jsi::Array &arguments);
+    jsi::Array unsafeQueryRawImpl(jsi::String &sql, jsi::Array &arguments);
+    jsi::Value countImpl(jsi::String &sql, jsi::Array &arguments);
+    jsi::Value countResult(sqlite3_stmt *statement);
+    jsi::Value getLocalImpl(jsi::String &key);
+    jsi::Value multiQueryOperation(const jsi::Value &operation);
+
+    ResultShape resultShape(sqlite3_stmt *statement);
+    jsi::Array resultHeader(const ResultShape &shape);
+    void invalidateResultShapes();
+    jsi::Object resultDictionary(sqlite3_stmt *statement, const ResultShape &shape);
+    jsi::Array resultArray(sqlite3_stmt *statement, const ResultShape &shape);
     jsi::Array arrayFromStd(std::vector<jsi::Value> &vector);
 
+    bool canOpenSecondaryConnections();
+    AsyncReader *asyncReader();
+    AsyncWriter *asyncWriter();
+    void waitForAsyncWrites();
+    std::unique_lock<std::mutex> holdAsyncCommits();
+    void applyAsyncCacheChanges();
+    std::vector<SqliteValue> argsFromJsi(jsi::Array &arguments);
+    jsi::Value valueFromSqlite(const SqliteValue &value);
+    jsi::Value makePromise(std::function<void(int promiseId)> start);
+    void settlePromise(int promiseId, std::function<jsi::Value(void)> getResult);
+    static void postAsyncResult(std::weak_ptr<Database> weakSelf, std::shared_ptr<AsyncResults> results, AsyncResults::Result result);
+    void settleAsyncResults();
+    bool canRunAsync();
+    jsi::Value asyncQueryResult(AsyncQueryType type, const std::string &table, SqliteRows &rows, const std::string &error, uint64_t removalsMark);
+    jsi::Value asyncBatchResult(AsyncWriter::BatchResult &result);
+
+    void finalizeCursor(QueryCursor &cursor);
+    void finalizeCursorStatement(sqlite3_stmt *statement);
+    void finalizeAbandonedCursors();
+    void finalizeAllCursors();
+
+    jsi::Value executeBatch(std::function<std::vector<BatchExecutor::CacheChanges>(BatchExecutor &executor)> execute);
+    void applyCacheChanges(const std::vector<BatchExecutor::CacheChanges> &cacheChanges);
+    jsi::Value finishChangeFeed();
+    jsi::Value resolveChanges(std::vector<ChangeFeed::TableChanges> &tableChanges, bool isComplete);
+    void bindObserverArgs(sqlite3_stmt *statement, QueryObservers::Observer &observer, int placeholderCount);
+    std::vector<jsi::Value> fetchObservedQuery(QueryObservers::Observer &observer, std::vector<std::string> &ids);
+    jsi::Value fetchIncrementalQueryChanges(QueryObservers::Observer &observer);
+    bool decodeQueryMatcher(jsi::Array &conditions, QueryMatcher &matcher);
+    bool decodeMatcherCondition(jsi::Object &where, QueryMatcher &matcher, QueryMatcher::Condition &condition);
+
     void beginTransaction();
     void commit();
     void rollback();
@@ -77,13 +236,14 @@ private:
     void setUserVersion(int newVersion);
     void migrate(jsi::String &migrationSql, int fromVersion, int toVersion);
 
-    bool isCached(std::string cacheKey);
-    void markAsCached(std::string cacheKey);
-    void removeFromCache(std::string cacheKey);
+    void loadSyncJsonPipelined(simdjson::padded_string &json,
+                               jsi::Object &tableSchemas,
+                               jsi::Object &residualValues,
+                               SyncLoadProgress &progress);
+    BulkLoad beginBulkLoad(jsi::Object &tableSchemas);
+    void endBulkLoad(const BulkLoad &bulkLoad);
+    void endBulkLoadAfterError(const BulkLoad &bulkLoad);
+    int queryInt(std::string sql);
 };
 
-inline std::string cacheKey(std::string tableName, std::string recordId) {
-    return tableName + "$" + recordId; // NOTE: safe as long as table names cannot contain $ sign
-}
-
 } // namespace watermelondb
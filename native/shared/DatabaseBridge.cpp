@@ -10,13 +10,14 @@ using platform::consoleLog;
 void Database::install(jsi::Runtime *runtime) {
     jsi::Runtime &rt = *runtime;
     auto globalObject = rt.global();
-    createMethod(rt, globalObject, "nativeWatermelonCreateAdapter", 2, [runtime](jsi::Runtime &rt, const jsi::Value *args) {
+    createMethod(rt, globalObject, "nativeWatermelonCreateAdapter", 3, [runtime](jsi::Runtime &rt, const jsi::Value *args) {
         std::string dbPath = args[0].getString(rt).utf8(rt);
         bool usesExclusiveLocking = args[1].getBool();
+        int asyncReaderConnections = (int) args[2].getNumber();
 
         jsi::Object adapter(rt);
 
-        std::shared_ptr<Database> database = std::make_shared<Database>(runtime, dbPath, usesExclusiveLocking);
+        std::shared_ptr<Database> database = std::make_shared<Database>(runtime, dbPath, usesExclusiveLocking, asyncReaderConnections);
         adapter.setProperty(rt, "database", jsi::Object::createFromHostObject(rt, database));
 
         // FIXME: Important hack!
@@ -137,6 +138,13 @@ void Database::install(jsi::Runtime *runtime) {
             jsi::String id = args[1].getString(rt);
             return database->find(tableName, id);
         });
+        createMethod(rt, adapter, "findMany", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // Returns array matching ids: cached id, record, or null if not found
+            jsi::String tableName = args[0].getString(rt);
+            jsi::Array ids = args[1].getObject(rt).getArray(rt);
+            return database->findMany(tableName, ids);
+        });
         createMethod(rt, adapter, "query", 3, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
             jsi::String tableName = args[0].getString(rt);
@@ -151,6 +159,13 @@ void Database::install(jsi::Runtime *runtime) {
             jsi::Array arguments = args[2].getObject(rt).getArray(rt);
             return database->queryAsArray(tableName, sql, arguments);
         });
+        createMethod(rt, adapter, "queryColumnar", 3, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            jsi::String tableName = args[0].getString(rt);
+            jsi::String sql = args[1].getString(rt);
+            jsi::Array arguments = args[2].getObject(rt).getArray(rt);
+            return database->queryColumnar(tableName, sql, arguments);
+        });
         createMethod(rt, adapter, "queryIds", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
             jsi::String sql = args[0].getString(rt);
@@ -169,35 +184,162 @@ void Database::install(jsi::Runtime *runtime) {
             jsi::Array arguments = args[1].getObject(rt).getArray(rt);
             return database->count(sql, arguments);
         });
+        createMethod(rt, adapter, "encodeQuery", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            jsi::Object query = args[0].getObject(rt);
+            bool countMode = args[1].getBool();
+            // Returns [sql, args]
+            return database->encodeQuery(query, countMode);
+        });
+        createMethod(rt, adapter, "queryEncoded", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // Same as encodeQuery + query, in a single call
+            jsi::Object query = args[0].getObject(rt);
+            return database->queryEncoded(query);
+        });
+        createMethod(rt, adapter, "countEncoded", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // Same as encodeQuery + count, in a single call
+            jsi::Object query = args[0].getObject(rt);
+            return database->countEncoded(query);
+        });
+        createMethod(rt, adapter, "queryCursor", 3, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // NOTE: Pass null table to fetch raw rows (like unsafeQueryRaw) instead of records
+            jsi::String tableName = args[0].isNull() ? jsi::String::createFromAscii(rt, "") : args[0].getString(rt);
+            jsi::String sql = args[1].getString(rt);
+            jsi::Array arguments = args[2].getObject(rt).getArray(rt);
+            return jsi::Object::createFromHostObject(rt, database->queryCursor(tableName, sql, arguments));
+        });
+        createMethod(rt, adapter, "queryAsync", 3, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            jsi::String tableName = args[0].getString(rt);
+            jsi::String sql = args[1].getString(rt);
+            jsi::Array arguments = args[2].getObject(rt).getArray(rt);
+            return database->queryAsync(AsyncQueryType::query, tableName, sql, arguments);
+        });
+        createMethod(rt, adapter, "queryIdsAsync", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            jsi::String tableName = jsi::String::createFromAscii(rt, "");
+            jsi::String sql = args[0].getString(rt);
+            jsi::Array arguments = args[1].getObject(rt).getArray(rt);
+            return database->queryAsync(AsyncQueryType::queryIds, tableName, sql, arguments);
+        });
+        createMethod(rt, adapter, "unsafeQueryRawAsync", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            jsi::String tableName = jsi::String::createFromAscii(rt, "");
+            jsi::String sql = args[0].getString(rt);
+            jsi::Array arguments = args[1].getObject(rt).getArray(rt);
+            return database->queryAsync(AsyncQueryType::unsafeQueryRaw, tableName, sql, arguments);
+        });
+        createMethod(rt, adapter, "countAsync", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            jsi::String tableName = jsi::String::createFromAscii(rt, "");
+            jsi::String sql = args[0].getString(rt);
+            jsi::Array arguments = args[1].getObject(rt).getArray(rt);
+            return database->queryAsync(AsyncQueryType::count, tableName, sql, arguments);
+        });
+        createMethod(rt, adapter, "multiQuery", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // Operations: ['find', table, id], ['findMany', table, ids], ['query' | 'queryAsArray', table, sql, args],
+            // ['queryIds' | 'unsafeQueryRaw' | 'count', sql, args], ['getLocal', key]
+            // Returns an array of results, with an Error in place of each operation that failed
+            jsi::Array operations = args[0].getObject(rt).getArray(rt);
+            return database->multiQuery(operations);
+        });
         createMethod(rt, adapter, "batch", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
             jsi::Array operations = args[0].getObject(rt).getArray(rt);
-            database->batch(operations);
-            return jsi::Value::undefined();
+            // Returns records changed by the batch - see Database::finishChangeFeed
+            return database->batch(operations);
         });
         createMethod(rt, adapter, "batchJSON", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
-            database->batchJSON(args[0].getString(rt));
+            return database->batchJSON(args[0].getString(rt));
+        });
+        createMethod(rt, adapter, "batchBinary", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // See encodeBinaryBatch for the format
+            jsi::ArrayBuffer buffer = args[0].getObject(rt).getArrayBuffer(rt);
+            return database->batchBinary(buffer);
+        });
+        createMethod(rt, adapter, "batchJSONAsync", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // Returns a Promise that resolves once the batch is committed
+            return database->batchJSONAsync(args[0].getString(rt));
+        });
+        createMethod(rt, adapter, "observeQuery", 6, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            jsi::String tableName = args[0].getString(rt);
+            jsi::String sql = args[1].getString(rt);
+            jsi::Array arguments = args[2].getObject(rt).getArray(rt);
+            jsi::Array tables = args[3].getObject(rt).getArray(rt);
+            bool isIncremental = args[4].getBool();
+            // `where` conditions of query's description, or null
+            const jsi::Value &conditions = args[5];
+            // Returns [observerId, records]
+            return database->observeQuery(tableName, sql, arguments, tables, isIncremental, conditions);
+        });
+        createMethod(rt, adapter, "unobserveQuery", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            database->unobserveQuery((int) args[0].getNumber());
             return jsi::Value::undefined();
         });
+        createMethod(rt, adapter, "fetchQueryObserverChanges", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // Returns null (no changes), { added, removed } (incremental), or { records } (re-run)
+            return database->fetchQueryObserverChanges((int) args[0].getNumber());
+        });
         createMethod(rt, adapter, "getLocal", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
             jsi::String key = args[0].getString(rt);
             return database->getLocal(key);
         });
-        createMethod(rt, adapter, "unsafeLoadFromSync", 4, [database](jsi::Runtime &rt, const jsi::Value *args) {
+        createMethod(rt, adapter, "unsafeLoadFromSync", 5, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
             auto jsonId = (int) args[0].getNumber();
             auto schema = args[1].getObject(rt);
             auto preamble = args[2].getString(rt).utf8(rt);
             auto postamble = args[3].getString(rt).utf8(rt);
-            return database->unsafeLoadFromSync(jsonId, schema, preamble, postamble);
+            jsi::Value onProgress(rt, args[4]);
+            return database->unsafeLoadFromSync(jsonId, schema, preamble, postamble, onProgress);
+        });
+        createMethod(rt, adapter, "unsafeLoadFromSyncFile", 5, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            auto path = args[0].getString(rt).utf8(rt);
+            auto schema = args[1].getObject(rt);
+            auto preamble = args[2].getString(rt).utf8(rt);
+            auto postamble = args[3].getString(rt).utf8(rt);
+            jsi::Value onProgress(rt, args[4]);
+            return database->unsafeLoadFromSyncFile(path, schema, preamble, postamble, onProgress);
+        });
+        createMethod(rt, adapter, "unsafeLoadIncrementalFromSync", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            auto jsonId = (int) args[0].getNumber();
+            auto schema = args[1].getObject(rt);
+            return database->unsafeLoadIncrementalFromSync(jsonId, schema);
+        });
+        createMethod(rt, adapter, "fetchLocalChangesJSON", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            auto schema = args[0].getObject(rt);
+            auto tables = args[1].getObject(rt).getArray(rt);
+            return database->fetchLocalChangesJSON(schema, tables);
+        });
+        createMethod(rt, adapter, "markAsSynced", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            auto schema = args[0].getObject(rt);
+            auto operations = args[1].getObject(rt).getArray(rt);
+            return database->markAsSynced(schema, operations);
         });
         createMethod(rt, adapter, "unsafeExecuteMultiple", 1, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
             auto sqlString = args[0].getString(rt).utf8(rt);
-            database->executeMultiple(sqlString);
-            return jsi::Value::undefined();
+            return database->unsafeExecuteMultiple(sqlString);
+        });
+        createMethod(rt, adapter, "getStatementCacheStats", 0, [database](jsi::Runtime &rt, const jsi::Value *args) {
+            assert(database->initialized_);
+            // Returns { hits, misses, evictions, count, bytes } of the prepared statement cache
+            return database->getStatementCacheStats();
         });
         createMethod(rt, adapter, "unsafeResetDatabase", 2, [database](jsi::Runtime &rt, const jsi::Value *args) {
             assert(database->initialized_);
@@ -34,6 +34,14 @@ std::string_view getSyncJson(int id);
 // Destroys sync json after it's used
 void deleteSyncJson(int id);
 
+// Returns true if functions can be scheduled to be called on the JS thread on this platform
+bool canRunOnJsThread();
+
+// Schedules function to be called on the JS thread (where it's safe to use the JS runtime)
+// Returns false if scheduling failed - the function may then never be called
+// NOTE: Can be called from any thread
+bool runOnJsThread(std::function<void()> function);
+
 // Called when React Native bridge is being torn down
 void onDestroy(std::function<void(void)> callback);
 
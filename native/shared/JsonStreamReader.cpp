@@ -0,0 +1,220 @@
+#include "JsonStreamReader.h"
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+namespace watermelondb {
+
+JsonStreamReader::JsonStreamReader(const std::string &path, size_t windowSize)
+    : file_(std::fopen(path.c_str(), "rb")), window_(windowSize), windowOffset_(0), position_(0), end_(0), size_(0) {
+    if (!file_) {
+        throw std::runtime_error("Failed to open JSON file " + path + " - " + std::strerror(errno));
+    }
+    if (std::fseek(file_, 0, SEEK_END) == 0) {
+        long size = std::ftell(file_);
+        size_ = size > 0 ? (size_t) size : 0;
+    }
+    std::rewind(file_);
+}
+
+JsonStreamReader::~JsonStreamReader() {
+    std::fclose(file_);
+}
+
+bool JsonStreamReader::fill() {
+    if (position_ < end_) {
+        return true;
+    }
+    windowOffset_ += end_;
+    position_ = 0;
+    end_ = std::fread(window_.data(), 1, window_.size(), file_);
+    if (end_ == 0 && std::ferror(file_)) {
+        fail("failed to read file");
+    }
+    return end_ > 0;
+}
+
+char JsonStreamReader::next() {
+    if (!fill()) {
+        fail("unexpected end of file");
+    }
+    return window_[position_++];
+}
+
+char JsonStreamReader::peek() {
+    while (fill()) {
+        char c = window_[position_];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            return c;
+        }
+        position_++;
+    }
+    return '\0';
+}
+
+bool JsonStreamReader::consume(char c) {
+    if (peek() == c) {
+        position_++;
+        return true;
+    }
+    return false;
+}
+
+void JsonStreamReader::expect(char c) {
+    if (!consume(c)) {
+        fail(std::string("expected '") + c + "'");
+    }
+}
+
+std::string JsonStreamReader::readString() {
+    expect('"');
+    std::string value;
+
+    while (true) {
+        if (!fill()) {
+            fail("unexpected end of file");
+        }
+        // Copy everything up to the next quote or escape at once
+        size_t start = position_;
+        while (position_ < end_ && window_[position_] != '"' && window_[position_] != '\\') {
+            position_++;
+        }
+        value.append(window_.data() + start, position_ - start);
+        if (position_ == end_) {
+            continue;
+        }
+
+        if (next() == '"') {
+            return value;
+        }
+
+        char escaped = next();
+        switch (escaped) {
+            case '"': value += '"'; break;
+            case '\\': value += '\\'; break;
+            case '/': value += '/'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                uint32_t codePoint = readHex4();
+                if (codePoint >= 0xd800 && codePoint <= 0xdbff) {
+                    if (next() != '\\' || next() != 'u') {
+                        fail("invalid surrogate pair");
+                    }
+                    uint32_t low = readHex4();
+                    if (low < 0xdc00 || low > 0xdfff) {
+                        fail("invalid surrogate pair");
+                    }
+                    codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+                }
+                appendCodePoint(value, codePoint);
+                break;
+            }
+            default:
+                fail("invalid escape sequence");
+        }
+    }
+}
+
+void JsonStreamReader::readValue(std::string &out) {
+    out.clear();
+    char first = peek();
+    if (first == '\0') {
+        fail("unexpected end of file");
+    }
+
+    // Number or literal - ends at the first delimiter or end of file
+    if (first != '{' && first != '[' && first != '"') {
+        while (fill()) {
+            size_t start = position_;
+            while (position_ < end_ && !std::strchr(",:]} \n\r\t", window_[position_])) {
+                position_++;
+            }
+            out.append(window_.data() + start, position_ - start);
+            if (position_ < end_) {
+                break;
+            }
+        }
+        return;
+    }
+
+    // Object, array or string - ends when we're back at depth 0, outside of a string
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    while (true) {
+        if (!fill()) {
+            fail("unexpected end of file");
+        }
+        size_t start = position_;
+        bool done = false;
+        while (position_ < end_ && !done) {
+            char c = window_[position_++];
+            if (inString) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    inString = false;
+                    done = depth == 0;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                done = --depth == 0;
+            }
+        }
+        out.append(window_.data() + start, position_ - start);
+        if (done) {
+            return;
+        }
+    }
+}
+
+uint32_t JsonStreamReader::readHex4() {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = next();
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            fail("invalid unicode escape");
+        }
+    }
+    return value;
+}
+
+void JsonStreamReader::appendCodePoint(std::string &out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += (char) codePoint;
+    } else if (codePoint < 0x800) {
+        out += (char) (0xc0 | (codePoint >> 6));
+        out += (char) (0x80 | (codePoint & 0x3f));
+    } else if (codePoint < 0x10000) {
+        out += (char) (0xe0 | (codePoint >> 12));
+        out += (char) (0x80 | ((codePoint >> 6) & 0x3f));
+        out += (char) (0x80 | (codePoint & 0x3f));
+    } else {
+        out += (char) (0xf0 | (codePoint >> 18));
+        out += (char) (0x80 | ((codePoint >> 12) & 0x3f));
+        out += (char) (0x80 | ((codePoint >> 6) & 0x3f));
+        out += (char) (0x80 | (codePoint & 0x3f));
+    }
+}
+
+void JsonStreamReader::fail(const std::string &description) {
+    throw std::runtime_error("Malformed JSON file - " + description);
+}
+
+} // namespace watermelondb
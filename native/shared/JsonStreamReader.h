@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace watermelondb {
+
+// Reads a JSON file in small windows, so that arbitrarily large files can be processed in bounded
+// memory. This is not a full JSON parser - it only walks the outer structure of a document, and
+// hands out raw JSON of values to be parsed by simdjson one by one (which needs the whole document
+// in memory, plus a few times as much for its indexes)
+// NOTE: Input is not fully validated by the reader, only values parsed by simdjson are
+class JsonStreamReader {
+public:
+    JsonStreamReader(const std::string &path, size_t windowSize = 64 * 1024);
+    ~JsonStreamReader();
+
+    JsonStreamReader &operator=(const JsonStreamReader &) = delete;
+    JsonStreamReader(const JsonStreamReader &) = delete;
+
+    // Skips whitespace and returns next character without consuming it, or '\0' at end of file
+    char peek();
+    // Consumes next character if it's `c`, and returns whether it did
+    bool consume(char c);
+    // Consumes next character, throws if it's not `c`
+    void expect(char c);
+    // Reads (unescaped) value of a string
+    std::string readString();
+    // Reads raw JSON of the next value, whatever its type, into `out`
+    void readValue(std::string &out);
+
+    // Returns number of bytes read so far
+    size_t bytesRead() const { return windowOffset_ + position_; }
+    // Returns size of the file
+    size_t size() const { return size_; }
+
+private:
+    std::FILE *file_;
+    std::vector<char> window_;
+    size_t windowOffset_; // position of window in file
+    size_t position_;
+    size_t end_;
+    size_t size_;
+
+    bool fill();
+    char next();
+    void appendCodePoint(std::string &out, uint32_t codePoint);
+    uint32_t readHex4();
+    [[noreturn]] void fail(const std::string &description);
+};
+
+} // namespace watermelondb
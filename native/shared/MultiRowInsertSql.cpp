@@ -0,0 +1,79 @@
+#include "MultiRowInsertSql.h"
+#include <algorithm>
+
+namespace watermelondb {
+
+namespace {
+
+// Past this, bigger statements don't make inserts noticeably faster, but they take more memory
+constexpr int maxRowsPerStatement = 256;
+
+constexpr const char *insertPrefix = "insert into ";
+constexpr const char *valuesPrefix = " values (";
+
+}
+
+int MultiRowInsertSql::rowArgsCount(const std::string &sql) {
+    if (sql.compare(0, std::char_traits<char>::length(insertPrefix), insertPrefix) != 0) {
+        return 0;
+    }
+
+    auto valuesPosition = sql.rfind(valuesPrefix);
+    if (valuesPosition == std::string::npos) {
+        return 0;
+    }
+
+    // Expecting exactly `?, ?, ..., ?)` after `values (`
+    int count = 0;
+    size_t i = valuesPosition + std::char_traits<char>::length(valuesPrefix);
+    while (i < sql.length()) {
+        if (sql[i] != '?') {
+            return 0;
+        }
+        count++;
+        i++;
+        if (i < sql.length() && sql[i] == ')') {
+            return i + 1 == sql.length() ? count : 0;
+        }
+        if (sql.compare(i, 2, ", ") != 0) {
+            return 0;
+        }
+        i += 2;
+    }
+    return 0;
+}
+
+int MultiRowInsertSql::rowsPerStatement(size_t rowsLeft, int rowArgsCount, int maxArgsCount) {
+    size_t maxRows = std::min(maxRowsPerStatement, std::max(maxArgsCount / std::max(rowArgsCount, 1), 1));
+    size_t limit = std::min(rowsLeft, maxRows);
+
+    int rows = 1;
+    while ((size_t) rows * 2 <= limit) {
+        rows *= 2;
+    }
+    return rows;
+}
+
+const std::string &MultiRowInsertSql::sqlFor(const std::string &sql, int rowCount) {
+    auto &packedSql = sqls_[sql][rowCount];
+    if (packedSql.empty()) {
+        auto rowPosition = sql.rfind(valuesPrefix) + std::char_traits<char>::length(valuesPrefix) - 1;
+        auto row = sql.substr(rowPosition);
+
+        packedSql.reserve(rowPosition + (row.length() + 2) * rowCount);
+        packedSql.append(sql, 0, rowPosition);
+        for (int i = 0; i < rowCount; i++) {
+            if (i > 0) {
+                packedSql += ", ";
+            }
+            packedSql += row;
+        }
+    }
+    return packedSql;
+}
+
+void MultiRowInsertSql::clear() {
+    sqls_.clear();
+}
+
+} // namespace watermelondb
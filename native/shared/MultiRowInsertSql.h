@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+namespace watermelondb {
+
+// Builds (and caches) SQL of INSERT statements that insert many rows at once, so that creating many
+// records takes far fewer statement executions than inserting them one by one.
+// Only single-row `insert into "table" (...) values (?, ?, ...)` statements (as made by encodeBatch)
+// can be packed. Row counts are powers of two, so a handful of statements per table covers any batch
+class MultiRowInsertSql {
+public:
+    // Returns number of arguments of a single row of `sql`, or 0 if it can't be packed
+    static int rowArgsCount(const std::string &sql);
+
+    // Returns number of rows to insert with the next statement, given number of rows left to insert
+    // and the sqlite limit of arguments (placeholders) per statement
+    static int rowsPerStatement(size_t rowsLeft, int rowArgsCount, int maxArgsCount);
+
+    // Returns `sql` with its values repeated for `rowCount` rows
+    const std::string &sqlFor(const std::string &sql, int rowCount);
+
+    void clear();
+
+private:
+    std::unordered_map<std::string, std::unordered_map<int, std::string>> sqls_;
+};
+
+} // namespace watermelondb
@@ -0,0 +1,78 @@
+#include "PartialUpdateSql.h"
+#include <stdexcept>
+#include <algorithm>
+
+namespace watermelondb {
+
+PartialUpdateSql::Statement PartialUpdateSql::statementFor(std::string_view tableName, const std::vector<std::string_view> &columns) {
+    if (columns.empty()) {
+        throw std::runtime_error("Partial update must set at least one column");
+    }
+
+    if (tableName.find('"') != std::string_view::npos) {
+        throw std::runtime_error("Invalid table name in partial update");
+    }
+
+    auto &tablePtr = tables_[std::string(tableName)];
+    if (!tablePtr) {
+        tablePtr = std::make_unique<Table>();
+    }
+    auto &table = *tablePtr;
+
+    std::vector<size_t> indices;
+    indices.reserve(columns.size());
+    for (auto column : columns) {
+        if (column.find('"') != std::string_view::npos) {
+            throw std::runtime_error("Invalid column name in partial update");
+        }
+        auto columnStr = std::string(column);
+        auto found = table.columnIndices.find(columnStr);
+        if (found == table.columnIndices.end()) {
+            auto index = table.columnNames.size();
+            table.columnIndices.emplace(columnStr, index);
+            table.columnNames.push_back(std::move(columnStr));
+            indices.push_back(index);
+        } else {
+            indices.push_back(found->second);
+        }
+    }
+
+    auto sortedIndices = indices;
+    std::sort(sortedIndices.begin(), sortedIndices.end());
+    if (std::adjacent_find(sortedIndices.begin(), sortedIndices.end()) != sortedIndices.end()) {
+        throw std::runtime_error("Duplicate column in partial update");
+    }
+
+    std::string bitmap(sortedIndices.back() / 8 + 1, '\0');
+    for (auto index : sortedIndices) {
+        bitmap[index / 8] |= (char) (1 << (index % 8));
+    }
+
+    auto &sql = table.sqls[bitmap];
+    if (sql.empty()) {
+        sql = "update \"" + std::string(tableName) + "\" set ";
+        for (size_t i = 0; i < sortedIndices.size(); i++) {
+            if (i > 0) {
+                sql += ", ";
+            }
+            sql += "\"" + table.columnNames[sortedIndices[i]] + "\" = ?";
+        }
+        sql += " where \"id\" is ?";
+    }
+
+    // Columns are set in order of their index, and id goes last
+    Statement statement { &sql, {} };
+    statement.placeholders.reserve(columns.size() + 1);
+    statement.placeholders.push_back((int) columns.size() + 1);
+    for (auto index : indices) {
+        auto position = std::lower_bound(sortedIndices.begin(), sortedIndices.end(), index) - sortedIndices.begin();
+        statement.placeholders.push_back((int) position + 1);
+    }
+    return statement;
+}
+
+void PartialUpdateSql::clear() {
+    tables_.clear();
+}
+
+} // namespace watermelondb
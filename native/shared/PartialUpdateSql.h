@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace watermelondb {
+
+// Builds (and caches) SQL of UPDATE statements that only set given columns of a record, so that
+// changing one field doesn't rewrite the whole row.
+// Statements are keyed by table + bitmap of columns (column indices are assigned as they're seen), so
+// the same set of columns always maps to the same statement, regardless of order.
+// NOTE: Arguments of partial updates are `[id, ...values of columns]`
+class PartialUpdateSql {
+public:
+    struct Statement {
+        const std::string *sql;
+        // Placeholder index (1-based) for each argument, in order of arguments passed
+        std::vector<int> placeholders;
+    };
+
+    Statement statementFor(std::string_view table, const std::vector<std::string_view> &columns);
+
+    void clear();
+
+private:
+    struct Table {
+        std::unordered_map<std::string, size_t> columnIndices;
+        std::vector<std::string> columnNames;
+        std::unordered_map<std::string, std::string> sqls; // bitmap (as bytes) -> SQL
+    };
+    std::unordered_map<std::string, std::unique_ptr<Table>> tables_;
+};
+
+} // namespace watermelondb
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <jsi/jsi.h>
+#include <memory>
+#include <sqlite3.h>
+
+using namespace facebook;
+
+namespace watermelondb {
+
+class Database;
+
+// JS handle to a query that's executed incrementally, so that huge results can be paged through without
+// materializing all of them at once. Exposes:
+//   next(count) -> Array of up to `count` rows (empty when there are no more rows)
+//   close()     -> finalizes the statement early
+// NOTE: The statement is owned by the cursor (not shared with statementCache_), but all access goes
+// through Database, which finalizes any cursors that are still open when it's destroyed. Statements of
+// cursors garbage collected while open are finalized by the next Database call
+// NOTE: The cursor doesn't keep the Database alive - once it's gone, calling the cursor throws
+class QueryCursor : public jsi::HostObject, public std::enable_shared_from_this<QueryCursor> {
+public:
+    QueryCursor(std::weak_ptr<Database> database, std::string tableName, sqlite3_stmt *statement);
+    ~QueryCursor();
+
+    jsi::Value get(jsi::Runtime &rt, const jsi::PropNameID &name) override;
+    std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime &rt) override;
+
+private:
+    friend class Database;
+
+    std::weak_ptr<Database> database_;
+
+    std::shared_ptr<Database> database(jsi::Runtime &rt);
+    std::string tableName_; // empty for raw queries (no record caching)
+    sqlite3_stmt *stmt_; // null once finalized
+};
+
+} // namespace watermelondb
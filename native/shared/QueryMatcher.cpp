@@ -0,0 +1,255 @@
+#include "QueryMatcher.h"
+#include <cstring>
+#include <string_view>
+
+namespace watermelondb {
+
+int QueryMatcher::addColumn(const std::string &name) {
+    for (size_t i = 0; i < columnNames_.size(); i++) {
+        if (columnNames_[i] == name) {
+            return (int) i;
+        }
+    }
+    columnNames_.push_back(name);
+    return (int) columnNames_.size() - 1;
+}
+
+void QueryMatcher::setConditions(std::vector<Condition> conditions) {
+    conditions_ = std::move(conditions);
+}
+
+bool QueryMatcher::operatorFromString(const std::string &name, Operator &op) {
+    static const std::pair<const char *, Operator> operators[] = {
+        { "eq", Operator::eq },         { "notEq", Operator::notEq },     { "gt", Operator::gt },
+        { "gte", Operator::gte },       { "weakGt", Operator::weakGt },   { "lt", Operator::lt },
+        { "lte", Operator::lte },       { "oneOf", Operator::oneOf },     { "notIn", Operator::notIn },
+        { "between", Operator::between }, { "like", Operator::like },     { "notLike", Operator::notLike },
+        { "includes", Operator::includes },
+    };
+    for (auto &entry : operators) {
+        if (name == entry.first) {
+            op = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QueryMatcher::bindColumns(sqlite3_stmt *statement) {
+    int count = sqlite3_column_count(statement);
+    columnIndices_.assign(columnNames_.size(), -1);
+    columnTypes_.assign(columnNames_.size(), SQLITE_NULL);
+
+    for (size_t i = 0; i < columnNames_.size(); i++) {
+        for (int j = 0; j < count; j++) {
+            const char *name = sqlite3_column_name(statement, j);
+            if (name && columnNames_[i] == name) {
+                columnIndices_[i] = j;
+                break;
+            }
+        }
+        if (columnIndices_[i] == -1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool QueryMatcher::matches(sqlite3_stmt *statement) {
+    // NOTE: Types are read upfront, because converting a value to text (for `like`) makes
+    // sqlite3_column_type undefined
+    for (size_t i = 0; i < columnIndices_.size(); i++) {
+        columnTypes_[i] = sqlite3_column_type(statement, columnIndices_[i]);
+    }
+
+    for (auto &condition : conditions_) {
+        if (!matches(statement, condition)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool QueryMatcher::matches(sqlite3_stmt *statement, const Condition &condition) {
+    switch (condition.type) {
+    case Condition::Type::allOf:
+        for (auto &subcondition : condition.conditions) {
+            if (!matches(statement, subcondition)) {
+                return false;
+            }
+        }
+        return true;
+    case Condition::Type::anyOf:
+        for (auto &subcondition : condition.conditions) {
+            if (matches(statement, subcondition)) {
+                return true;
+            }
+        }
+        return false;
+    case Condition::Type::comparison:
+        return compare(statement, condition);
+    }
+    return false;
+}
+
+QueryMatcher::Operand QueryMatcher::column(sqlite3_stmt *statement, int column) {
+    int index = columnIndices_[column];
+    switch (columnTypes_[column]) {
+    case SQLITE_INTEGER:
+    case SQLITE_FLOAT:
+        return { SQLITE_FLOAT, sqlite3_column_double(statement, index), nullptr, 0 };
+    case SQLITE_TEXT: {
+        auto text = (const char *) sqlite3_column_text(statement, index);
+        return { SQLITE_TEXT, 0, text, sqlite3_column_bytes(statement, index) };
+    }
+    case SQLITE_BLOB: {
+        auto blob = (const char *) sqlite3_column_blob(statement, index);
+        return { SQLITE_BLOB, 0, blob, sqlite3_column_bytes(statement, index) };
+    }
+    default:
+        return { SQLITE_NULL, 0, nullptr, 0 };
+    }
+}
+
+QueryMatcher::Operand QueryMatcher::operand(const Value &value) {
+    switch (value.type) {
+    case Value::Type::number:
+        return { SQLITE_FLOAT, value.number, nullptr, 0 };
+    case Value::Type::text:
+        return { SQLITE_TEXT, 0, value.text.c_str(), (int) value.text.length() };
+    default:
+        return { SQLITE_NULL, 0, nullptr, 0 };
+    }
+}
+
+static int typeOrder(int type) {
+    switch (type) {
+    case SQLITE_NULL:
+        return 0;
+    case SQLITE_FLOAT:
+        return 1;
+    case SQLITE_TEXT:
+        return 2;
+    default:
+        return 3;
+    }
+}
+
+// Same as sqlite's comparison of values without type affinity (and with BINARY collation)
+int QueryMatcher::compareOperands(const Operand &left, const Operand &right) {
+    int leftOrder = typeOrder(left.type);
+    int rightOrder = typeOrder(right.type);
+    if (leftOrder != rightOrder) {
+        return leftOrder < rightOrder ? -1 : 1;
+    }
+
+    if (left.type == SQLITE_NULL) {
+        return 0;
+    } else if (left.type == SQLITE_FLOAT) {
+        return left.number < right.number ? -1 : left.number > right.number ? 1 : 0;
+    }
+
+    int bytes = left.bytes < right.bytes ? left.bytes : right.bytes;
+    int result = bytes ? std::memcmp(left.data, right.data, bytes) : 0;
+    return result ? result : left.bytes - right.bytes;
+}
+
+// Returns a column's value converted to text (like sqlite does for `like` and `instr`), or nullptr if
+// it's NULL
+static const char *columnText(sqlite3_stmt *statement, int index, int type, std::string &buffer) {
+    if (type == SQLITE_NULL) {
+        return nullptr;
+    } else if (type == SQLITE_TEXT) {
+        return (const char *) sqlite3_column_text(statement, index);
+    }
+
+    // NOTE: Converting a copy, so that the row's value (and type) is left intact
+    sqlite3_value *copy = sqlite3_value_dup(sqlite3_column_value(statement, index));
+    if (!copy) {
+        return nullptr;
+    }
+    auto text = (const char *) sqlite3_value_text(copy);
+    buffer.assign(text ? text : "", text ? sqlite3_value_bytes(copy) : 0);
+    sqlite3_value_free(copy);
+    return buffer.c_str();
+}
+
+bool QueryMatcher::compare(sqlite3_stmt *statement, const Condition &condition) {
+    auto &values = condition.values;
+
+    if (condition.op == Operator::like || condition.op == Operator::notLike || condition.op == Operator::includes) {
+        auto &pattern = values[0];
+        std::string buffer;
+        int index = columnIndices_[condition.leftColumn];
+        const char *text = columnText(statement, index, columnTypes_[condition.leftColumn], buffer);
+        if (!text || pattern.type != Value::Type::text) {
+            return false;
+        }
+
+        if (condition.op == Operator::includes) {
+            return std::string_view(text).find(pattern.text) != std::string_view::npos;
+        }
+        // NOTE: sqlite3_strlike implements `like` (case-insensitive for ASCII, no escape character)
+        bool isLike = sqlite3_strlike(pattern.text.c_str(), text, 0) == 0;
+        return condition.op == Operator::like ? isLike : !isLike;
+    }
+
+    auto left = column(statement, condition.leftColumn);
+    bool isLeftNull = left.type == SQLITE_NULL;
+
+    if (condition.op == Operator::oneOf || condition.op == Operator::notIn) {
+        if (condition.op == Operator::notIn && values.empty()) {
+            return true;
+        } else if (isLeftNull) {
+            return false;
+        }
+
+        bool hasNull = false;
+        for (auto &value : values) {
+            if (value.type == Value::Type::null) {
+                hasNull = true;
+            } else if (compareOperands(left, operand(value)) == 0) {
+                return condition.op == Operator::oneOf;
+            }
+        }
+        // NOTE: `x not in (..., null)` is NULL (not true) if x isn't in the list
+        return condition.op == Operator::notIn && !hasNull;
+    }
+
+    if (condition.op == Operator::between) {
+        auto lower = operand(values[0]);
+        auto upper = operand(values[1]);
+        if (isLeftNull || lower.type == SQLITE_NULL || upper.type == SQLITE_NULL) {
+            return false;
+        }
+        return compareOperands(left, lower) >= 0 && compareOperands(left, upper) <= 0;
+    }
+
+    auto right = condition.rightColumn == -1 ? operand(values[0]) : column(statement, condition.rightColumn);
+    bool isRightNull = right.type == SQLITE_NULL;
+
+    switch (condition.op) {
+    case Operator::eq:
+        return compareOperands(left, right) == 0;
+    case Operator::notEq:
+        return compareOperands(left, right) != 0;
+    case Operator::weakGt:
+        // (compared with a column, `weakGt` also matches if only the column is NULL)
+        if (condition.rightColumn != -1 && !isLeftNull && isRightNull) {
+            return true;
+        }
+        return !isLeftNull && !isRightNull && compareOperands(left, right) > 0;
+    case Operator::gt:
+        return !isLeftNull && !isRightNull && compareOperands(left, right) > 0;
+    case Operator::gte:
+        return !isLeftNull && !isRightNull && compareOperands(left, right) >= 0;
+    case Operator::lt:
+        return !isLeftNull && !isRightNull && compareOperands(left, right) < 0;
+    case Operator::lte:
+        return !isLeftNull && !isRightNull && compareOperands(left, right) <= 0;
+    default:
+        return false;
+    }
+}
+
+} // namespace watermelondb
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+
+namespace watermelondb {
+
+// Predicate compiled from `where` conditions of a query (QueryDescription), which checks whether a
+// record matches the query without running it - the native counterpart of observation/encodeMatcher.
+// Rows are checked the way sqlite evaluates SQL produced by encodeQuery: columns have no type
+// affinity, so values of different types are never equal, and are ordered NULL < numbers < text < blobs.
+// NOTE: This class knows nothing about JSI - see Database::decodeQueryMatcher
+class QueryMatcher {
+public:
+    enum class Operator : uint8_t { eq, notEq, gt, gte, weakGt, lt, lte, oneOf, notIn, between, like, notLike, includes };
+
+    struct Value {
+        enum class Type : uint8_t { null, number, text };
+        Type type = Type::null;
+        double number = 0;
+        std::string text;
+    };
+
+    struct Condition {
+        enum class Type : uint8_t { allOf, anyOf, comparison };
+        Type type;
+        std::vector<Condition> conditions; // (allOf, anyOf)
+        // (comparison)
+        Operator op;
+        int leftColumn; // see addColumn
+        int rightColumn; // -1 if compared with values
+        std::vector<Value> values;
+    };
+
+    // Returns index of a column, to be used in conditions
+    int addColumn(const std::string &name);
+    // Sets conditions, all of which must match
+    void setConditions(std::vector<Condition> conditions);
+
+    // Looks up columns in results of a statement. Must be called for each statement before its rows
+    // are checked. Returns false if results don't contain all columns needed
+    bool bindColumns(sqlite3_stmt *statement);
+    // Checks whether the current row of the (bound) statement matches
+    bool matches(sqlite3_stmt *statement);
+
+    // Returns false if there's no such operator
+    static bool operatorFromString(const std::string &name, Operator &op);
+
+private:
+    // Value of a column in the current row, or of a condition's value
+    struct Operand {
+        int type; // SQLITE_NULL, SQLITE_FLOAT (any number), SQLITE_TEXT, SQLITE_BLOB
+        double number;
+        const char *data;
+        int bytes;
+    };
+
+    std::vector<Condition> conditions_;
+    std::vector<std::string> columnNames_;
+    std::vector<int> columnIndices_; // column -> index in statement results
+    std::vector<int> columnTypes_; // column -> sqlite type in the current row (before any conversions)
+
+    bool matches(sqlite3_stmt *statement, const Condition &condition);
+    bool compare(sqlite3_stmt *statement, const Condition &condition);
+    Operand column(sqlite3_stmt *statement, int column);
+    static Operand operand(const Value &value);
+    static int compareOperands(const Operand &left, const Operand &right);
+};
+
+} // namespace watermelondb
@@ -0,0 +1,65 @@
+#include "QueryObservers.h"
+#include <algorithm>
+
+namespace watermelondb {
+
+// If more records than this changed, it's cheaper to re-run the query than to check them one by one
+static constexpr size_t maxChangedIds = 1024;
+
+QueryObservers::QueryObservers() : nextObserverId_(1) {
+}
+
+int QueryObservers::add(Observer observer) {
+    int observerId = nextObserverId_++;
+    observers_.emplace(observerId, std::move(observer));
+    return observerId;
+}
+
+void QueryObservers::remove(int observerId) {
+    observers_.erase(observerId);
+}
+
+QueryObservers::Observer *QueryObservers::get(int observerId) {
+    auto observer = observers_.find(observerId);
+    return observer == observers_.end() ? nullptr : &observer->second;
+}
+
+void QueryObservers::recordChanges(const std::string &table, const std::vector<std::string> &ids) {
+    for (auto &entry : observers_) {
+        auto &observer = entry.second;
+        if (observer.isStale) {
+            continue;
+        }
+
+        if (observer.isIncremental && observer.table == table) {
+            if (observer.changedIds.size() + ids.size() > maxChangedIds) {
+                observer.isStale = true;
+                observer.changedIds.clear();
+            } else {
+                observer.changedIds.insert(observer.changedIds.end(), ids.begin(), ids.end());
+            }
+        } else if (!observer.isIncremental &&
+                   std::find(observer.tables.begin(), observer.tables.end(), table) != observer.tables.end()) {
+            observer.isStale = true;
+        }
+    }
+}
+
+void QueryObservers::invalidateTable(const std::string &table) {
+    for (auto &entry : observers_) {
+        auto &observer = entry.second;
+        if (std::find(observer.tables.begin(), observer.tables.end(), table) != observer.tables.end()) {
+            observer.isStale = true;
+            observer.changedIds.clear();
+        }
+    }
+}
+
+void QueryObservers::invalidateAll() {
+    for (auto &entry : observers_) {
+        entry.second.isStale = true;
+        entry.second.changedIds.clear();
+    }
+}
+
+} // namespace watermelondb
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <memory>
+#include "Sqlite.h"
+#include "QueryMatcher.h"
+
+namespace watermelondb {
+
+// Registry of queries observed by JS, which keeps track of which of them could have been affected by
+// writes, so that JS can be told how their results changed without re-running them (see
+// Database::fetchQueryObserverChanges).
+// NOTE: This class knows nothing about JSI, and doesn't run any queries itself
+class QueryObservers {
+public:
+    struct Observer {
+        std::string table;
+        std::string sql;
+        std::vector<SqliteValue> arguments;
+        // Tables the query depends on (its table, and joined tables)
+        std::vector<std::string> tables;
+        // If true, this is a query of a single table whose results are unordered, so results can be
+        // updated by checking which changed records match. Otherwise, the query is re-run
+        bool isIncremental;
+        // (incremental only) Query's conditions, compiled so that changed records can be checked
+        // without running the query. nullptr if they can't be checked natively (e.g. raw SQL)
+        std::unique_ptr<QueryMatcher> matcher;
+        // IDs of records in current results
+        std::vector<std::string> ids; // (in order, non-incremental only)
+        std::unordered_set<std::string> idSet; // (incremental only)
+        // (incremental only) IDs of records (of `table`) changed since results were last fetched, in order
+        // of changes (can contain duplicates)
+        std::vector<std::string> changedIds;
+        // Results need to be fetched again (query must be re-run)
+        bool isStale;
+    };
+
+    QueryObservers();
+
+    QueryObservers &operator=(const QueryObservers &) = delete;
+    QueryObservers(const QueryObservers &) = delete;
+
+    // Returns observer's ID
+    int add(Observer observer);
+    void remove(int observerId);
+    // Returns nullptr if there's no such observer
+    Observer *get(int observerId);
+    bool empty() const { return observers_.empty(); }
+
+    // Notes that records of a table were created, updated, or destroyed
+    void recordChanges(const std::string &table, const std::vector<std::string> &ids);
+    // Notes that any records of a table could have changed (e.g. deleted by raw SQL, with unknown IDs)
+    void invalidateTable(const std::string &table);
+    // Notes that records of any table could have changed (e.g. after a write that wasn't tracked)
+    void invalidateAll();
+
+private:
+    std::unordered_map<int, Observer> observers_;
+    int nextObserverId_;
+};
+
+} // namespace watermelondb
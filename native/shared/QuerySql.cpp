@@ -0,0 +1,265 @@
+#include "QuerySql.h"
+#include <cmath>
+
+namespace watermelondb {
+
+namespace {
+
+// NOTE: Mirrors encodeQuery (in JS) function by function - keep them in sync
+class QueryEncoder {
+public:
+    QueryEncoder(jsi::Runtime &rt, QuerySql &result) : rt_(rt), sql_(result.sql), arguments_(result.arguments) {
+    }
+
+    void encode(jsi::Object &query, bool countMode) {
+        auto table = query.getProperty(rt_, "table").getString(rt_).utf8(rt_);
+        auto description = query.getProperty(rt_, "description").getObject(rt_);
+
+        auto rawSql = description.getProperty(rt_, "sql");
+        if (rawSql.isObject()) {
+            // Q.unsafeSqlQuery
+            auto rawSqlObj = rawSql.getObject(rt_);
+            sql_ = rawSqlObj.getProperty(rt_, "sql").getString(rt_).utf8(rt_);
+            auto values = rawSqlObj.getProperty(rt_, "values").getObject(rt_).getArray(rt_);
+            for (size_t i = 0, len = values.size(rt_); i < len; i++) {
+                addArgument(values.getValueAtIndex(rt_, i));
+            }
+            return;
+        }
+
+        auto associations = query.getProperty(rt_, "associations").getObject(rt_).getArray(rt_);
+        auto where = description.getProperty(rt_, "where").getObject(rt_).getArray(rt_);
+        size_t associationsCount = associations.size(rt_);
+
+        bool hasToManyJoins = false;
+        for (size_t i = 0; i < associationsCount; i++) {
+            auto info = associations.getValueAtIndex(rt_, i).getObject(rt_).getProperty(rt_, "info").getObject(rt_);
+            if (info.getProperty(rt_, "type").getString(rt_).utf8(rt_) == "has_many") {
+                hasToManyJoins = true;
+            }
+        }
+
+        encodeMethod(table, countMode, hasToManyJoins);
+        for (size_t i = 0; i < associationsCount; i++) {
+            auto association = associations.getValueAtIndex(rt_, i).getObject(rt_);
+            encodeAssociation(where, association);
+        }
+        if (where.size(rt_)) {
+            sql_ += " where ";
+            encodeAndOr(" and ", table, where);
+        }
+        auto sortBys = description.getProperty(rt_, "sortBy").getObject(rt_).getArray(rt_);
+        encodeOrderBy(table, sortBys);
+        encodeLimitOffset(description.getProperty(rt_, "take"), description.getProperty(rt_, "skip"));
+    }
+
+private:
+    jsi::Runtime &rt_;
+    std::string &sql_;
+    std::vector<SqliteValue> &arguments_;
+
+    void column(const std::string &table, const std::string &column) {
+        sql_ += "\"" + table + "\".\"" + column + "\"";
+    }
+
+    // Same as encodeValue (in JS), but adds a placeholder and an argument
+    void addArgument(const jsi::Value &value) {
+        if (value.isBool()) {
+            arguments_.push_back({ SqliteValue::Type::number, value.getBool() ? 1.0 : 0.0, "" });
+        } else if (value.isNumber() && !std::isnan(value.getNumber())) {
+            arguments_.push_back({ SqliteValue::Type::number, value.getNumber(), "" });
+        } else if (value.isString()) {
+            arguments_.push_back({ SqliteValue::Type::text, 0, value.getString(rt_).utf8(rt_) });
+        } else if (value.isNull() || value.isUndefined() || value.isNumber()) {
+            arguments_.push_back({ SqliteValue::Type::null, 0, "" });
+        } else {
+            throw jsi::JSError(rt_, "Invalid value to encode into query");
+        }
+    }
+
+    void encodeMethod(const std::string &table, bool countMode, bool needsDistinct) {
+        if (countMode) {
+            if (needsDistinct) {
+                sql_ += "select count(distinct \"" + table + "\".\"id\") as \"count\" from \"" + table + "\"";
+            } else {
+                sql_ += "select count(*) as \"count\" from \"" + table + "\"";
+            }
+        } else {
+            sql_ += needsDistinct ? "select distinct \"" : "select \"";
+            sql_ += table + "\".* from \"" + table + "\"";
+        }
+    }
+
+    void encodeAssociation(jsi::Array &where, jsi::Object &association) {
+        auto mainTable = association.getProperty(rt_, "from").getString(rt_).utf8(rt_);
+        auto joinedTable = association.getProperty(rt_, "to").getString(rt_).utf8(rt_);
+        auto info = association.getProperty(rt_, "info").getObject(rt_);
+
+        // NOTE: See encodeAssociation in JS for why both join styles are used
+        bool usesOldJoinStyle = false;
+        for (size_t i = 0, len = where.size(rt_); i < len; i++) {
+            auto clause = where.getValueAtIndex(rt_, i).getObject(rt_);
+            if (clause.getProperty(rt_, "type").getString(rt_).utf8(rt_) == "on" &&
+                clause.getProperty(rt_, "table").getString(rt_).utf8(rt_) == joinedTable) {
+                usesOldJoinStyle = true;
+                break;
+            }
+        }
+
+        sql_ += usesOldJoinStyle ? " join \"" : " left join \"";
+        sql_ += joinedTable + "\" on \"" + joinedTable + "\".";
+        if (info.getProperty(rt_, "type").getString(rt_).utf8(rt_) == "belongs_to") {
+            auto key = info.getProperty(rt_, "key").getString(rt_).utf8(rt_);
+            sql_ += "\"id\" = \"" + mainTable + "\".\"" + key + "\"";
+        } else {
+            auto foreignKey = info.getProperty(rt_, "foreignKey").getString(rt_).utf8(rt_);
+            sql_ += "\"" + foreignKey + "\" = \"" + mainTable + "\".\"id\"";
+        }
+    }
+
+    void encodeAndOr(const char *op, const std::string &table, jsi::Array &conditions) {
+        for (size_t i = 0, len = conditions.size(rt_); i < len; i++) {
+            if (i) {
+                sql_ += op;
+            }
+            auto where = conditions.getValueAtIndex(rt_, i).getObject(rt_);
+            encodeWhere(table, where);
+        }
+    }
+
+    void encodeWhere(const std::string &table, jsi::Object &where) {
+        auto type = where.getProperty(rt_, "type").getString(rt_).utf8(rt_);
+        if (type == "and" || type == "or") {
+            auto conditions = where.getProperty(rt_, "conditions").getObject(rt_).getArray(rt_);
+            sql_ += "(";
+            encodeAndOr(type == "and" ? " and " : " or ", table, conditions);
+            sql_ += ")";
+        } else if (type == "where") {
+            auto left = where.getProperty(rt_, "left").getString(rt_).utf8(rt_);
+            auto comparison = where.getProperty(rt_, "comparison").getObject(rt_);
+            encodeWhereCondition(table, left, comparison);
+        } else if (type == "on") {
+            auto onTable = where.getProperty(rt_, "table").getString(rt_).utf8(rt_);
+            auto conditions = where.getProperty(rt_, "conditions").getObject(rt_).getArray(rt_);
+            sql_ += "(";
+            encodeAndOr(" and ", onTable, conditions);
+            sql_ += ")";
+        } else if (type == "sql") {
+            sql_ += where.getProperty(rt_, "expr").getString(rt_).utf8(rt_);
+        } else {
+            throw jsi::JSError(rt_, "Unknown clause " + type);
+        }
+    }
+
+    void encodeWhereCondition(const std::string &table, const std::string &left, jsi::Object &comparison) {
+        auto op = comparison.getProperty(rt_, "operator").getString(rt_).utf8(rt_);
+        auto right = comparison.getProperty(rt_, "right").getObject(rt_);
+        auto rightColumn = right.getProperty(rt_, "column");
+
+        if (op == "weakGt" && rightColumn.isString()) {
+            // if right operand is a column, we must check for `not null > null`
+            auto rightColumnName = rightColumn.getString(rt_).utf8(rt_);
+            sql_ += "(";
+            column(table, left);
+            sql_ += " > ";
+            column(table, rightColumnName);
+            sql_ += " or (";
+            column(table, left);
+            sql_ += " is not null and ";
+            column(table, rightColumnName);
+            sql_ += " is null))";
+            return;
+        } else if (op == "includes") {
+            sql_ += "instr(";
+            column(table, left);
+            sql_ += ", ";
+            encodeComparisonRight(table, right);
+            sql_ += ")";
+            return;
+        }
+
+        column(table, left);
+        if (op == "between") {
+            auto values = right.getProperty(rt_, "values");
+            sql_ += " ";
+            if (values.isObject()) {
+                auto valuesArray = values.getObject(rt_).getArray(rt_);
+                sql_ += "between ? and ?";
+                addArgument(valuesArray.getValueAtIndex(rt_, 0));
+                addArgument(valuesArray.getValueAtIndex(rt_, 1));
+            }
+            return;
+        }
+
+        sql_ += " ";
+        sql_ += sqlOperator(op);
+        sql_ += " ";
+        encodeComparisonRight(table, right);
+    }
+
+    void encodeComparisonRight(const std::string &table, jsi::Object &right) {
+        auto values = right.getProperty(rt_, "values");
+        auto rightColumn = right.getProperty(rt_, "column");
+        if (values.isObject()) {
+            auto valuesArray = values.getObject(rt_).getArray(rt_);
+            sql_ += "(";
+            for (size_t i = 0, len = valuesArray.size(rt_); i < len; i++) {
+                sql_ += i ? ", ?" : "?";
+                addArgument(valuesArray.getValueAtIndex(rt_, i));
+            }
+            sql_ += ")";
+        } else if (rightColumn.isString()) {
+            column(table, rightColumn.getString(rt_).utf8(rt_));
+        } else {
+            sql_ += "?";
+            addArgument(right.getProperty(rt_, "value"));
+        }
+    }
+
+    // NOTE: it's necessary to use `is` / `is not` for NULL comparisons to work correctly
+    const char *sqlOperator(const std::string &op) {
+        static const std::pair<const char *, const char *> operators[] = {
+            { "eq", "is" },        { "notEq", "is not" }, { "gt", ">" },       { "gte", ">=" },
+            { "weakGt", ">" },     { "lt", "<" },         { "lte", "<=" },     { "oneOf", "in" },
+            { "notIn", "not in" }, { "like", "like" },    { "notLike", "not like" },
+        };
+        for (auto &entry : operators) {
+            if (op == entry.first) {
+                return entry.second;
+            }
+        }
+        throw jsi::JSError(rt_, "Unknown operator " + op);
+    }
+
+    void encodeOrderBy(const std::string &table, jsi::Array &sortBys) {
+        for (size_t i = 0, len = sortBys.size(rt_); i < len; i++) {
+            auto sortBy = sortBys.getValueAtIndex(rt_, i).getObject(rt_);
+            sql_ += i ? ", " : " order by ";
+            column(table, sortBy.getProperty(rt_, "sortColumn").getString(rt_).utf8(rt_));
+            sql_ += " " + sortBy.getProperty(rt_, "sortOrder").getString(rt_).utf8(rt_);
+        }
+    }
+
+    void encodeLimitOffset(const jsi::Value &limit, const jsi::Value &offset) {
+        // NOTE: Limits are passed as arguments, too, so that e.g. pages of results share a statement
+        if (!limit.isNumber() || !limit.getNumber()) {
+            return;
+        }
+        sql_ += " limit ?";
+        addArgument(limit);
+        if (offset.isNumber() && offset.getNumber()) {
+            sql_ += " offset ?";
+            addArgument(offset);
+        }
+    }
+};
+
+} // namespace
+
+QuerySql encodeQuerySql(jsi::Runtime &rt, jsi::Object &query, bool countMode) {
+    QuerySql result;
+    QueryEncoder(rt, result).encode(query, countMode);
+    return result;
+}
+
+} // namespace watermelondb
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <jsi/jsi.h>
+#include <string>
+#include <vector>
+#include "Sqlite.h"
+
+namespace watermelondb {
+
+using namespace facebook;
+
+struct QuerySql {
+    std::string sql;
+    std::vector<SqliteValue> arguments;
+};
+
+// Encodes a JS SerializedQuery ({ table, description, associations }) into SQL - the native
+// counterpart of adapters/sqlite/encodeQuery, producing the same SQL, except that values aren't
+// inlined, but passed as arguments. This way, queries of the same shape (differing only by values)
+// map to the same SQL, and so, the same cached prepared statement
+QuerySql encodeQuerySql(jsi::Runtime &rt, jsi::Object &query, bool countMode);
+
+} // namespace watermelondb
@@ -0,0 +1,170 @@
+#include "RecordCache.h"
+#include <functional>
+
+namespace watermelondb {
+
+// NOTE: Must be a power of two
+static const size_t initialCapacity = 64;
+
+RecordCache::Table::Table(RecordCache &cache) : cache_(cache), slots_(initialCapacity), size_(0), usedSlots_(0), clearedAt_(0) {
+}
+
+// Returns index of the slot containing id, or slots_.size() if not found
+size_t RecordCache::Table::findSlot(std::string_view id) const {
+    size_t mask = slots_.size() - 1;
+    size_t i = std::hash<std::string_view>{}(id) & mask;
+
+    while (true) {
+        auto &slot = slots_[i];
+        if (slot.state == SlotState::empty) {
+            return slots_.size();
+        } else if (slot.state == SlotState::full && slot.id == id) {
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+void RecordCache::Table::clear() {
+    slots_ = std::vector<Slot>(initialCapacity);
+    size_ = 0;
+    usedSlots_ = 0;
+    clearedAt_ = cache_.recordRemoval();
+}
+
+bool RecordCache::Table::contains(std::string_view id) const {
+    return findSlot(id) != slots_.size();
+}
+
+void RecordCache::Table::insert(std::string_view id) {
+    // keep load factor (including tombstones) under 0.5 so that probe sequences stay short
+    if ((usedSlots_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    size_t mask = slots_.size() - 1;
+    size_t i = std::hash<std::string_view>{}(id) & mask;
+    size_t firstDeleted = slots_.size();
+
+    while (true) {
+        auto &slot = slots_[i];
+        if (slot.state == SlotState::empty) {
+            break;
+        } else if (slot.state == SlotState::full && slot.id == id) {
+            return;
+        } else if (slot.state == SlotState::deleted && firstDeleted == slots_.size()) {
+            firstDeleted = i;
+        }
+        i = (i + 1) & mask;
+    }
+
+    if (firstDeleted != slots_.size()) {
+        i = firstDeleted;
+    } else {
+        usedSlots_++;
+    }
+
+    auto &slot = slots_[i];
+    slot.state = SlotState::full;
+    slot.id.assign(id.data(), id.size());
+    size_++;
+}
+
+void RecordCache::Table::erase(std::string_view id) {
+    // NOTE: Recorded even if not cached, since it could be cached from results read before the removal
+    if (cache_.trackersCount_ > 0) {
+        removals_[std::string(id)] = cache_.recordRemoval();
+    }
+
+    size_t i = findSlot(id);
+    if (i == slots_.size()) {
+        return;
+    }
+
+    auto &slot = slots_[i];
+    slot.state = SlotState::deleted;
+    slot.id.clear();
+    size_--;
+}
+
+void RecordCache::Table::forEach(const std::function<void(const std::string &)> &fn) const {
+    for (auto &slot : slots_) {
+        if (slot.state == SlotState::full) {
+            fn(slot.id);
+        }
+    }
+}
+
+bool RecordCache::Table::wasRemovedSince(std::string_view id, uint64_t removalsMark) const {
+    if (clearedAt_ > removalsMark || cache_.clearedAt_ > removalsMark) {
+        return true;
+    } else if (removals_.empty()) {
+        return false;
+    }
+    auto removal = removals_.find(std::string(id));
+    return removal != removals_.end() && removal->second > removalsMark;
+}
+
+void RecordCache::Table::grow() {
+    // if the table is mostly tombstones, rehashing at the same size is enough
+    size_t newCapacity = size_ * 4 > slots_.size() ? slots_.size() * 2 : slots_.size();
+
+    std::vector<Slot> oldSlots(newCapacity);
+    oldSlots.swap(slots_);
+    usedSlots_ = 0;
+
+    size_t mask = slots_.size() - 1;
+    for (auto &oldSlot : oldSlots) {
+        if (oldSlot.state != SlotState::full) {
+            continue;
+        }
+
+        size_t i = std::hash<std::string_view>{}(oldSlot.id) & mask;
+        while (slots_[i].state != SlotState::empty) {
+            i = (i + 1) & mask;
+        }
+        slots_[i].state = SlotState::full;
+        slots_[i].id = std::move(oldSlot.id);
+        usedSlots_++;
+    }
+}
+
+RecordCache::RecordCache() : removalsCount_(0), clearedAt_(0), trackersCount_(0) {
+}
+
+RecordCache::Table &RecordCache::table(std::string_view tableName) {
+    // NOTE: There's only a handful of tables, and this is called once per query/batch operation,
+    // not per row, so allocating a key here is fine
+    auto &table = tables_[std::string(tableName)];
+    if (!table) {
+        table = std::make_unique<Table>(*this);
+    }
+    return *table;
+}
+
+void RecordCache::clear() {
+    tables_.clear();
+    clearedAt_ = recordRemoval();
+}
+
+uint64_t RecordCache::trackRemovals() {
+    if (trackersCount_ == 0) {
+        for (auto &table : tables_) {
+            table.second->removals_.clear();
+        }
+    }
+    trackersCount_++;
+    return removalsCount_;
+}
+
+void RecordCache::untrackRemovals() {
+    if (trackersCount_ > 0) {
+        trackersCount_--;
+    }
+}
+
+uint64_t RecordCache::recordRemoval() {
+    return ++removalsCount_;
+}
+
+} // namespace watermelondb
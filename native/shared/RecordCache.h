@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace watermelondb {
+
+// Set of record IDs known to JS (i.e. records already sent to JS and held by Collection caches),
+// partitioned by table, so that the hot path (one lookup per fetched row) can be done without
+// building a `table$id` key or allocating.
+class RecordCache {
+public:
+    RecordCache();
+
+    // Open addressing set of IDs in a single table. Lookups take a string_view, so that IDs can
+    // be checked straight from sqlite3_column_text/simdjson buffers
+    class Table {
+    public:
+        Table(RecordCache &cache);
+
+        bool contains(std::string_view id) const;
+        void insert(std::string_view id);
+        void erase(std::string_view id);
+        void clear();
+        size_t size() const { return size_; }
+        // NOTE: The set must not be modified while iterating
+        void forEach(const std::function<void(const std::string &)> &fn) const;
+        // Returns true if `id` was removed (or the table was cleared) after `removalsMark` was taken
+        // (see RecordCache::trackRemovals)
+        bool wasRemovedSince(std::string_view id, uint64_t removalsMark) const;
+
+    private:
+        friend class RecordCache;
+
+        enum class SlotState : uint8_t { empty, full, deleted };
+        struct Slot {
+            SlotState state = SlotState::empty;
+            std::string id;
+        };
+
+        RecordCache &cache_;
+        std::vector<Slot> slots_; // NOTE: size is always a power of two
+        size_t size_;
+        size_t usedSlots_; // full + deleted
+        std::unordered_map<std::string, uint64_t> removals_; // id -> removal number, while tracked
+        uint64_t clearedAt_; // removal number
+
+        size_t findSlot(std::string_view id) const;
+        void grow();
+    };
+
+    // Returns the table's ID set, creating it if needed
+    // NOTE: references stay valid until clear()
+    Table &table(std::string_view tableName);
+    void clear();
+
+    // Starts recording removals of IDs, so that IDs read from an older snapshot of the database (e.g. by
+    // an async query) can be checked with wasRemovedSince() before being added back. Returns the mark
+    // to check against. Must be balanced with untrackRemovals()
+    uint64_t trackRemovals();
+    void untrackRemovals();
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<Table>> tables_;
+    uint64_t removalsCount_;
+    uint64_t clearedAt_; // removal number
+    size_t trackersCount_;
+    // NOTE: Recorded removals are kept after the last tracker is done (so that it can still check them),
+    // and forgotten when tracking starts again
+
+    uint64_t recordRemoval();
+};
+
+} // namespace watermelondb
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace watermelondb {
+
+// Bounded queue for passing work from one producer thread to one consumer thread without locks.
+// Slots are filled and read in place, and reused once consumed, so that buffers they own are only
+// allocated once, not for every item.
+// NOTE: A waiting side yields, and then sleeps briefly in a loop, so this is meant for pipelines where
+// both sides are busy most of the time, not for long-lived, mostly idle threads
+template <typename T>
+class SpscQueue {
+public:
+    SpscQueue(size_t capacity) : slots_(capacity), head_(0), tail_(0), isCancelled_(false) {
+    }
+
+    SpscQueue &operator=(const SpscQueue &) = delete;
+    SpscQueue(const SpscQueue &) = delete;
+
+    // Producer: returns next free slot to fill, waiting for one if queue is full, or nullptr if cancelled
+    T *beginPush() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        for (int attempt = 0; head - tail_.load(std::memory_order_acquire) == slots_.size(); attempt++) {
+            if (!wait(attempt)) {
+                return nullptr;
+            }
+        }
+        return &slots_[head % slots_.size()];
+    }
+
+    // Producer: makes slot returned by beginPush visible to consumer
+    void endPush() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: returns next filled slot, waiting for one if queue is empty, or nullptr if cancelled
+    T *beginPop() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (int attempt = 0; head_.load(std::memory_order_acquire) == tail; attempt++) {
+            if (!wait(attempt)) {
+                return nullptr;
+            }
+        }
+        return &slots_[tail % slots_.size()];
+    }
+
+    // Consumer: returns slot returned by beginPop to producer
+    void endPop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Makes calls to beginPush/beginPop that have to wait (now or later) return nullptr
+    void cancel() {
+        isCancelled_.store(true, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> slots_;
+    // NOTE: Kept on separate cache lines, so that producer and consumer don't invalidate each other's
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+    std::atomic<bool> isCancelled_;
+
+    bool wait(int attempt) {
+        if (isCancelled_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        if (attempt < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return true;
+    }
+};
+
+} // namespace watermelondb
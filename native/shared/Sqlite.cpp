@@ -1,4 +1,5 @@
 #include "Sqlite.h"
+#include "StatementCache.h"
 #include "DatabasePlatform.h"
 #include <cassert>
 
@@ -17,7 +18,7 @@ std::string resolveDatabasePath(std::string path) {
     }
 }
 
-SqliteDb::SqliteDb(std::string path) {
+SqliteDb::SqliteDb(std::string path, bool readOnly) {
     consoleLog("Will open database...");
     platform::initializeSqlite();
     #ifndef ANDROID
@@ -25,7 +26,8 @@ SqliteDb::SqliteDb(std::string path) {
     #endif
 
     auto resolvedPath = resolveDatabasePath(path);
-    int openResult = sqlite3_open(resolvedPath.c_str(), &sqlite);
+    int openFlags = readOnly ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    int openResult = sqlite3_open_v2(resolvedPath.c_str(), &sqlite, openFlags, nullptr);
 
     if (openResult != SQLITE_OK) {
         if (sqlite) {
@@ -76,11 +78,17 @@ SqliteDb::~SqliteDb() {
     destroy();
 }
 
-SqliteStatement::SqliteStatement(sqlite3_stmt *statement) : stmt(statement) {
+SqliteStatement::SqliteStatement(sqlite3_stmt *statement, StatementCache *cache) : stmt(statement), cache_(cache) {
+    if (cache_ && stmt) {
+        cache_->pin(stmt);
+    }
 }
 
 SqliteStatement::~SqliteStatement() {
     reset();
+    if (cache_ && stmt) {
+        cache_->unpin(stmt);
+    }
 }
 
 void SqliteStatement::reset() {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <sqlite3.h>
 
 namespace watermelondb {
@@ -8,7 +9,7 @@ namespace watermelondb {
 // Lightweight wrapper for handling sqlite3 lifetime
 class SqliteDb {
 public:
-    SqliteDb(std::string path);
+    SqliteDb(std::string path, bool readOnly = false);
     ~SqliteDb();
     void destroy();
 
@@ -21,14 +22,40 @@ private:
     bool isDestroyed_;
 };
 
+// Plain (non-JSI) sqlite value, so that query arguments and results can be passed between threads
+struct SqliteValue {
+    enum class Type { null, number, text };
+
+    Type type;
+    double number;
+    std::string text;
+};
+
+using SqliteRow = std::vector<SqliteValue>;
+
+struct SqliteRows {
+    std::vector<std::string> columnNames;
+    std::vector<SqliteRow> rows;
+};
+
+class StatementCache;
+
+// Resets statement when it goes out of scope. If `cache` is passed, the statement is also pinned in
+// it, so that it can't be evicted (and finalized) while in use
 class SqliteStatement {
 public:
-    SqliteStatement(sqlite3_stmt *statement);
+    SqliteStatement(sqlite3_stmt *statement, StatementCache *cache = nullptr);
     ~SqliteStatement();
 
+    SqliteStatement &operator=(const SqliteStatement &) = delete;
+    SqliteStatement(const SqliteStatement &) = delete;
+
     sqlite3_stmt *stmt;
 
     void reset();
+
+private:
+    StatementCache *cache_;
 };
 
 } // namespace watermelondb
@@ -0,0 +1,134 @@
+#include "StatementCache.h"
+
+namespace watermelondb {
+
+StatementCache::StatementCache(size_t capacity, int64_t byteLimit)
+    : capacity_(capacity < 1 ? 1 : capacity),
+      byteLimit_(byteLimit),
+      bytes_(0),
+      hits_(0),
+      misses_(0),
+      evictions_(0) {
+}
+
+StatementCache::~StatementCache() {
+    clear();
+}
+
+sqlite3_stmt *StatementCache::prepare(sqlite3 *db, const std::string &sql, bool &isCached) {
+    size_t hash = std::hash<std::string_view>()(sql);
+
+    auto found = index_.find(Key { sql, hash });
+    if (found != index_.end()) {
+        hits_++;
+        isCached = true;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->statement;
+    }
+
+    misses_++;
+    isCached = false;
+
+    // NOTE: Persistent statements are allocated in a way that avoids lookaside memory, which is better
+    // for statements that are retained for a long time, but wasteful for one-off queries
+    auto evicted = evictedHashSet_.find(hash);
+    bool isHot = evicted != evictedHashSet_.end();
+    unsigned int flags = isHot ? SQLITE_PREPARE_PERSISTENT : 0;
+
+    sqlite3_stmt *statement = nullptr;
+    int resultPrepare = sqlite3_prepare_v3(db, sql.c_str(), -1, flags, &statement, nullptr);
+    if (resultPrepare != SQLITE_OK) {
+        sqlite3_finalize(statement);
+        return nullptr;
+    }
+
+    int64_t bytes = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_MEMUSED, 0);
+    entries_.push_front(Entry { sql, hash, statement, bytes, 0 });
+    index_.emplace(Key { entries_.front().sql, hash }, entries_.begin());
+    statements_.emplace(statement, entries_.begin());
+    bytes_ += bytes;
+
+    evictIfNeeded();
+    return statement;
+}
+
+void StatementCache::pin(sqlite3_stmt *statement) {
+    auto found = statements_.find(statement);
+    if (found != statements_.end()) {
+        found->second->pins++;
+    }
+}
+
+void StatementCache::unpin(sqlite3_stmt *statement) {
+    auto found = statements_.find(statement);
+    if (found != statements_.end() && found->second->pins > 0) {
+        found->second->pins--;
+    }
+}
+
+void StatementCache::onEvict(std::function<void(sqlite3_stmt *)> handler) {
+    onEvict_ = std::move(handler);
+}
+
+void StatementCache::evictIfNeeded() {
+    auto it = entries_.end();
+    while (entries_.size() > capacity_ || bytes_ > byteLimit_) {
+        if (it == entries_.begin()) {
+            break;
+        }
+        --it;
+        // NOTE: never evict the statement that was just added
+        if (it == entries_.begin()) {
+            break;
+        }
+        // NOTE: Statements in use by callers must not be finalized from under them
+        if (it->pins || sqlite3_stmt_busy(it->statement)) {
+            continue;
+        }
+
+        if (onEvict_) {
+            onEvict_(it->statement);
+        }
+        sqlite3_finalize(it->statement);
+        bytes_ -= it->bytes;
+        evictions_++;
+        rememberEvicted(it->hash);
+        index_.erase(Key { it->sql, it->hash });
+        statements_.erase(it->statement);
+        it = entries_.erase(it);
+    }
+}
+
+void StatementCache::rememberEvicted(size_t hash) {
+    evictedHashes_.push_back(hash);
+    evictedHashSet_.insert(hash);
+    if (evictedHashes_.size() > capacity_) {
+        evictedHashSet_.erase(evictedHashSet_.find(evictedHashes_.front()));
+        evictedHashes_.pop_front();
+    }
+}
+
+void StatementCache::clear() {
+    for (auto &entry : entries_) {
+        if (onEvict_) {
+            onEvict_(entry.statement);
+        }
+        sqlite3_finalize(entry.statement);
+    }
+    index_.clear();
+    statements_.clear();
+    entries_.clear();
+    bytes_ = 0;
+}
+
+StatementCache::Stats StatementCache::stats() const {
+    // NOTE: Memory used by a statement can change after it's executed, so we're not relying on the
+    // estimate made when it was prepared
+    int64_t bytes = 0;
+    for (auto const &entry : entries_) {
+        bytes += sqlite3_stmt_status(entry.statement, SQLITE_STMTSTATUS_MEMUSED, 0);
+    }
+    return { hits_, misses_, evictions_, entries_.size(), bytes };
+}
+
+} // namespace watermelondb
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <list>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <sqlite3.h>
+
+namespace watermelondb {
+
+// Bounded LRU cache of prepared statements, keyed by SQL.
+// Statements are evicted (and finalized) when there's more than `capacity` of them, or when they
+// take more than `byteLimit` bytes of memory, so that long-running sessions with many distinct
+// queries (e.g. unsafeSqlQuery, or queries with inlined `IN (...)` lists) don't leak memory.
+// Statements that are pinned (see SqliteStatement) or being stepped through are never evicted, so
+// callers that use a statement while preparing others must keep it pinned.
+class StatementCache {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t count;
+        int64_t bytes;
+    };
+
+    static constexpr size_t defaultCapacity = 256;
+    static constexpr int64_t defaultByteLimit = 16 * 1024 * 1024;
+
+    StatementCache(size_t capacity = defaultCapacity, int64_t byteLimit = defaultByteLimit);
+    ~StatementCache();
+
+    // Returns a cached statement for `sql`, or prepares and caches a new one.
+    // `isCached` is set to whether the statement was already in the cache.
+    // Returns nullptr if sqlite failed to prepare the statement - check sqlite3_errmsg for details
+    sqlite3_stmt *prepare(sqlite3 *db, const std::string &sql, bool &isCached);
+
+    // Pins a statement returned by `prepare`, so that it's not evicted until it's unpinned the same
+    // number of times. Does nothing for statements that aren't cached
+    void pin(sqlite3_stmt *statement);
+    void unpin(sqlite3_stmt *statement);
+
+    // Called with each statement right before it's evicted and finalized
+    void onEvict(std::function<void(sqlite3_stmt *)> handler);
+
+    // Finalizes all statements (including pinned ones - must not be called while statements are in use)
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string sql;
+        size_t hash;
+        sqlite3_stmt *statement;
+        int64_t bytes;
+        int pins;
+    };
+    // NOTE: Keys point to `Entry::sql`, which is stable, since list nodes are never moved
+    struct Key {
+        std::string_view sql;
+        size_t hash;
+        bool operator==(const Key &other) const { return hash == other.hash && sql == other.sql; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const { return key.hash; }
+    };
+
+    size_t capacity_;
+    int64_t byteLimit_;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    std::unordered_map<sqlite3_stmt *, std::list<Entry>::iterator> statements_;
+    int64_t bytes_;
+    std::function<void(sqlite3_stmt *)> onEvict_;
+
+    // Hashes of recently evicted statements - if they're needed again, they're hot, so we prepare them
+    // as persistent
+    std::deque<size_t> evictedHashes_;
+    std::unordered_multiset<size_t> evictedHashSet_;
+
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t evictions_;
+
+    void evictIfNeeded();
+    void rememberEvicted(size_t hash);
+};
+
+} // namespace watermelondb
@@ -0,0 +1,72 @@
+#include "SyncLoadProgress.h"
+#include <stdexcept>
+
+namespace watermelondb {
+
+// Records inserted between checks of the clock
+static constexpr size_t recordsPerClockCheck = 256;
+// Minimum interval between progress reports
+static constexpr std::chrono::milliseconds reportInterval(100);
+
+std::atomic<int> SyncLoadProgress::cancellationCount_(0);
+
+void SyncLoadProgress::cancelAll() {
+    cancellationCount_++;
+}
+
+SyncLoadProgress::SyncLoadProgress(size_t bytesTotal, Callback onProgress)
+    : onProgress_(onProgress),
+      cancellationCountAtStart_(cancellationCount_.load()),
+      bytesParsed_(0),
+      bytesTotal_(bytesTotal),
+      tableRowsInserted_(nullptr),
+      recordsSinceReport_(0),
+      lastReport_(std::chrono::steady_clock::now()) {
+}
+
+void SyncLoadProgress::beginTable(const std::string &table) {
+    for (auto &tableRows : rowsInserted_) {
+        if (tableRows.first == table) {
+            tableRowsInserted_ = &tableRows.second;
+            return;
+        }
+    }
+    rowsInserted_.emplace_back(table, 0);
+    tableRowsInserted_ = &rowsInserted_.back().second;
+}
+
+void SyncLoadProgress::didInsertRecord(size_t bytesParsed) {
+    (*tableRowsInserted_)++;
+    bytesParsed_ = bytesParsed;
+
+    // NOTE: This is checked after every record, so it must be cheap
+    if (cancellationCount_.load(std::memory_order_relaxed) != cancellationCountAtStart_) {
+        throw std::runtime_error("Sync load was cancelled");
+    }
+
+    if (!onProgress_ || ++recordsSinceReport_ < recordsPerClockCheck) {
+        return;
+    }
+    recordsSinceReport_ = 0;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastReport_ >= reportInterval) {
+        lastReport_ = now;
+        report();
+    }
+}
+
+void SyncLoadProgress::finish(size_t bytesParsed) {
+    bytesParsed_ = bytesParsed;
+    if (onProgress_) {
+        report();
+    }
+}
+
+void SyncLoadProgress::report() {
+    if (!onProgress_(*this)) {
+        throw std::runtime_error("Sync load was cancelled");
+    }
+}
+
+} // namespace watermelondb
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace watermelondb {
+
+// Tracks progress of loading a turbo sync, reports it (throttled) to a callback, and checks whether
+// the load was cancelled.
+// NOTE: This class knows nothing about JSI - callback is called on the thread that inserts records
+class SyncLoadProgress {
+public:
+    // Called with progress so far. Returning false cancels the load
+    using Callback = std::function<bool(const SyncLoadProgress &)>;
+
+    // Cancels all sync loads that are in progress. Can be called from any thread
+    static void cancelAll();
+
+    SyncLoadProgress(size_t bytesTotal, Callback onProgress);
+
+    // Called when records of another table are about to be inserted
+    void beginTable(const std::string &table);
+    // Called after a record is inserted. Throws if load was cancelled
+    void didInsertRecord(size_t bytesParsed);
+    // Reports final progress (unthrottled)
+    void finish(size_t bytesParsed);
+
+    size_t bytesParsed() const { return bytesParsed_; }
+    size_t bytesTotal() const { return bytesTotal_; }
+    // (table, number of records inserted) pairs, in order of appearance
+    const std::vector<std::pair<std::string, size_t>> &rowsInserted() const { return rowsInserted_; }
+
+private:
+    static std::atomic<int> cancellationCount_;
+
+    Callback onProgress_;
+    int cancellationCountAtStart_;
+    size_t bytesParsed_;
+    size_t bytesTotal_;
+    std::vector<std::pair<std::string, size_t>> rowsInserted_;
+    size_t *tableRowsInserted_;
+    size_t recordsSinceReport_;
+    std::chrono::steady_clock::time_point lastReport_;
+
+    void report();
+};
+
+} // namespace watermelondb
@@ -0,0 +1,38 @@
+#include "TableSchema.h"
+#include <stdexcept>
+
+namespace watermelondb {
+
+ColumnType columnTypeFromStr(std::string &type) {
+    if (type == "string") {
+        return ColumnType::string;
+    } else if (type == "number") {
+        return ColumnType::number;
+    } else if (type == "boolean") {
+        return ColumnType::boolean;
+    } else {
+        throw std::invalid_argument("invalid column type in schema");
+    }
+}
+
+TableSchemaArray decodeTableSchema(jsi::Runtime &rt, jsi::Object schema) {
+    auto columnArr = schema.getProperty(rt, "columnArray").getObject(rt).getArray(rt);
+
+    TableSchemaArray columnsArray = {};
+
+    for (size_t i = 0, len = columnArr.size(rt); i < len; i++) {
+        auto columnObj = columnArr.getValueAtIndex(rt, i).getObject(rt);
+        auto name = columnObj.getProperty(rt, "name").getString(rt).utf8(rt);
+        auto typeStr = columnObj.getProperty(rt, "type").getString(rt).utf8(rt);
+        ColumnType type = columnTypeFromStr(typeStr);
+        auto isOptionalProp = columnObj.getProperty(rt, "isOptional");
+        bool isOptional = isOptionalProp.isBool() ? isOptionalProp.getBool() : false;
+        ColumnSchema column = { (int) i, name, type, isOptional };
+
+        columnsArray.push_back(column);
+    }
+
+    return columnsArray;
+}
+
+} // namespace watermelondb
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <jsi/jsi.h>
+#include <string>
+#include <vector>
+
+namespace watermelondb {
+
+using namespace facebook;
+
+enum ColumnType { string, number, boolean };
+struct ColumnSchema {
+    int index;
+    std::string name;
+    ColumnType type;
+    bool isOptional;
+};
+
+using TableSchemaArray = std::vector<ColumnSchema>;
+
+// Decodes `columnArray` of a JS TableSchema
+TableSchemaArray decodeTableSchema(jsi::Runtime &rt, jsi::Object schema);
+
+} // namespace watermelondb
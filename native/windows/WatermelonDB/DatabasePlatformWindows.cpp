@@ -64,6 +64,17 @@ void deleteSyncJson(int id) {
     // TODO: Unimplemented
 }
 
+bool canRunOnJsThread() {
+    // TODO: Unimplemented
+    return false;
+}
+
+bool runOnJsThread(std::function<void()> function) {
+    // TODO: Unimplemented
+    consoleError("Unable to run on JS thread - unimplemented on Windows");
+    return false;
+}
+
 void onDestroy(std::function<void(void)> callback) {
     // TODO: Unimplemented
 }
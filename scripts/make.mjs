@@ -48,6 +48,7 @@ const DO_NOT_BUILD_PATHS = [
   /__playground__/,
   /test\.js/,
   /integrationTest/,
+  /benchmark\.js/,
   /__mocks__/,
   /\.DS_Store/,
   /package\.json/,
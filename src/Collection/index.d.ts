@@ -29,6 +29,8 @@ export default class Collection<Record extends Model> {
 
   _cache: RecordCache<Record>
 
+  _pendingFinds: Map<RecordId, ResultCallback<Record>[]>
+
   constructor(database: Database, ModelClass: Record)
 
   get db(): Database
@@ -87,6 +89,8 @@ export default class Collection<Record extends Model> {
   // Fetches exactly one record (See: Collection.find)
   _fetchRecord(id: RecordId, callback: ResultCallback<Record>): void
 
+  _fetchPendingRecords(): void
+
   _applyChangesToCache(operations: CollectionChangeSet<Record>): void
 
   _notify(operations: CollectionChangeSet<Record>): void
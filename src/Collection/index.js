@@ -7,7 +7,7 @@ import {
   // eslint-disable-next-line no-unused-vars
   type ArrayOrSpreadFn,
 } from '../utils/fp'
-import { type ResultCallback, toPromise, mapValue } from '../utils/fp/Result'
+import { type Result, type ResultCallback, toPromise, mapValue } from '../utils/fp/Result'
 import { type Unsubscribe } from '../utils/subscriptions'
 
 import Query from '../Query'
@@ -16,6 +16,7 @@ import type Model, { RecordId } from '../Model'
 import type { Clause } from '../QueryDescription'
 import { type TableName, type TableSchema } from '../Schema'
 import { type DirtyRaw } from '../RawRecord'
+import type { CachedFindResult } from '../adapters/type'
 
 import RecordCache from './RecordCache'
 
@@ -44,6 +45,9 @@ export default class Collection<Record: Model> {
 
   _cache: RecordCache<Record>
 
+  // id -> callbacks of records to fetch from the database (see _fetchRecord)
+  _pendingFinds: Map<RecordId, ResultCallback<Record>[]> = new Map()
+
   constructor(database: Database, ModelClass: Class<Record>): void {
     this.database = database
     this.modelClass = ModelClass
@@ -229,14 +233,47 @@ export default class Collection<Record: Model> {
       return
     }
 
-    this.database.adapter.underlyingAdapter.find(this.table, id, (result) =>
-      callback(
-        mapValue((rawRecord) => {
-          invariant(rawRecord, `Record ${this.table}#${id} not found`)
-          return this._cache.recordFromQueryResult(rawRecord)
-        }, result),
-      ),
-    )
+    // Records requested at the same time (e.g. when resolving relations of a list of records) are
+    // fetched together, in a single adapter call
+    const pendingCallbacks = this._pendingFinds.get(id)
+    if (pendingCallbacks) {
+      pendingCallbacks.push(callback)
+      return
+    }
+    this._pendingFinds.set(id, [callback])
+    if (this._pendingFinds.size === 1) {
+      Promise.resolve().then(() => this._fetchPendingRecords())
+    }
+  }
+
+  _fetchPendingRecords(): void {
+    const pendingFinds = this._pendingFinds
+    this._pendingFinds = new Map()
+
+    const settle = (id: RecordId, result: Result<CachedFindResult>): void => {
+      const recordResult = mapValue((rawRecord) => {
+        invariant(rawRecord, `Record ${this.table}#${id} not found`)
+        return this._cache.recordFromQueryResult(rawRecord)
+      }, result)
+      // $FlowFixMe
+      pendingFinds.get(id).forEach((callback) => callback(recordResult))
+    }
+
+    const { underlyingAdapter } = this.database.adapter
+    const ids = Array.from(pendingFinds.keys())
+    if (ids.length === 1) {
+      underlyingAdapter.find(this.table, ids[0], (result) => settle(ids[0], result))
+      return
+    }
+    underlyingAdapter.findMany(this.table, ids, (result) => {
+      if (result.error) {
+        const { error } = result
+        ids.forEach((id) => settle(id, { error }))
+        return
+      }
+      const rawRecords = result.value
+      ids.forEach((id, i) => settle(id, { value: rawRecords[i] }))
+    })
   }
 
   _applyChangesToCache(operations: CollectionChangeSet<Record>): void {
@@ -82,6 +82,36 @@ describe('finding records', () => {
     expect(collection._cache.map.size).toBe(1)
     expect(adapter.find.mock.calls.length).toBe(1)
   })
+  it('finds records requested at the same time in a single adapter call', async () => {
+    const { tasks: collection, adapter } = mockDatabase()
+
+    adapter.find = jest.fn()
+    adapter.findMany = jest
+      .fn()
+      .mockImplementation((table, ids, callback) =>
+        callback({ value: ids.map((id) => (id === 'nonexisting' ? null : { id })) }),
+      )
+
+    const [m1, m2, m1Again, missing] = await Promise.all([
+      collection.find('m1'),
+      collection.find('m2'),
+      collection.find('m1'),
+      collection.find('nonexisting').catch((error) => error),
+    ])
+    expect(m1.id).toBe('m1')
+    expect(m2.id).toBe('m2')
+    expect(m1Again).toBe(m1)
+    expect(missing).toBeInstanceOf(Error)
+    expect(collection._cache.map.size).toBe(2)
+
+    expect(adapter.find).toHaveBeenCalledTimes(0)
+    expect(adapter.findMany).toHaveBeenCalledTimes(1)
+    expect(adapter.findMany.mock.calls[0]).toEqual([
+      'mock_tasks',
+      ['m1', 'm2', 'nonexisting'],
+      expect.anything(),
+    ])
+  })
   it('rejects promise if record cannot be found', async () => {
     const { tasks: collection, adapter } = mockDatabase()
     const findSpy = jest.spyOn(adapter, 'find')
@@ -125,7 +125,8 @@ export default class Database {
       let changeType
 
       if (preparedState === 'update') {
-        batchOperations.push(['update', table, raw])
+        batchOperations.push(['update', table, raw, record._preparedUpdateColumns])
+        record._preparedUpdateColumns = null
         changeType = 'updated'
       } else if (preparedState === 'create') {
         batchOperations.push(['create', table, raw])
@@ -153,7 +154,20 @@ export default class Database {
       changeNotifications[table].push({ record, type: changeType })
     })
 
-    await this.adapter.batch(batchOperations)
+    try {
+      await this.adapter.batch(batchOperations)
+    } catch (error) {
+      // Updated records keep their new values in memory, even though they weren't saved, so their
+      // next update can't be diffed against them
+      Object.values(changeNotifications).forEach((changeSet: any) => {
+        changeSet.forEach(({ record, type }) => {
+          if (type === 'updated') {
+            record._hasUnsavedUpdate = true
+          }
+        })
+      })
+      throw error
+    }
 
     // Debug info
     if (this.experimentalIsVerbose) {
@@ -205,9 +205,10 @@ describe('Database', () => {
       expect(adapterBatchSpy).toHaveBeenCalledTimes(5)
       expect(adapterBatchSpy).toHaveBeenLastCalledWith([
         ['create', 'mock_comments', m6._raw],
-        ['update', 'mock_tasks', m1._raw],
+        ['update', 'mock_tasks', m1._raw, ['_changed', 'name']],
         ['create', 'mock_tasks', m5._raw],
-        ['update', 'mock_comments', m2._raw],
+        // NOTE: updated_at may or may not have changed, depending on timing
+        ['update', 'mock_comments', m2._raw, expect.arrayContaining(['_changed', 'body'])],
         ['markAsDeleted', 'mock_tasks', m3.id],
         ['destroyPermanently', 'mock_comments', m4.id],
       ])
@@ -346,6 +347,49 @@ describe('Database', () => {
         )
       })
     })
+    it(`writes all columns of a record whose previous update failed`, async () => {
+      const { database, tasks, cloneDatabase } = mockDatabase()
+      const adapterBatchSpy = jest.spyOn(database.adapter, 'batch')
+      const m1 = await database.write(() =>
+        tasks.create((task) => {
+          task.name = 'foo'
+        }),
+      )
+
+      adapterBatchSpy.mockImplementationOnce(() => Promise.reject(new Error('forced failure')))
+      await expectToRejectWithMessage(
+        database.write(() =>
+          m1.update(() => {
+            m1.name = 'bar'
+          }),
+        ),
+        'forced failure',
+      )
+      // changed in memory, but not saved
+      expect(m1.name).toBe('bar')
+
+      // `name` must be saved, too, even though it's not changed by this update
+      await database.write(() =>
+        m1.update(() => {
+          m1.position = 10
+        }),
+      )
+      expect(adapterBatchSpy).toHaveBeenLastCalledWith([['update', 'mock_tasks', m1._raw, null]])
+
+      // once saved, updates can be partial again
+      await database.write(() =>
+        m1.update(() => {
+          m1.position = 20
+        }),
+      )
+      expect(adapterBatchSpy).toHaveBeenLastCalledWith([
+        ['update', 'mock_tasks', m1._raw, ['position']],
+      ])
+
+      const fetchedM1 = await (await cloneDatabase()).get('mock_tasks').find(m1.id)
+      expect(fetchedM1.name).toBe('bar')
+      expect(fetchedM1.position).toBe(20)
+    })
   })
 
   describe('Observation', () => {
@@ -724,7 +768,7 @@ describe('Database', () => {
       expect(adapterBatchSpy).toHaveBeenCalledTimes(2)
       expect(adapterBatchSpy).toHaveBeenLastCalledWith([
         ['create', 'mock_tasks', t2._raw],
-        ['update', 'mock_tasks', t1._raw],
+        ['update', 'mock_tasks', t1._raw, []],
       ])
     })
     it(`ensures that reader/writer interface is not used after block is done`, async () => {
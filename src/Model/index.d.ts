@@ -37,6 +37,10 @@ export default class Model {
 
   _preparedState: null | 'create' | 'update' | 'markAsDeleted' | 'destroyPermanently'
 
+  _preparedUpdateColumns?: ColumnName[]
+
+  _hasUnsavedUpdate: boolean
+
   __changes?: BehaviorSubject<any>
 
   _getChanges(): BehaviorSubject<any>
@@ -14,7 +14,13 @@ import type Collection from '../Collection'
 import type CollectionMap from '../Database/CollectionMap'
 import { type TableName, type ColumnName, columnName } from '../Schema'
 import type { Value } from '../QueryDescription'
-import { type RawRecord, type DirtyRaw, sanitizedRaw, setRawSanitized } from '../RawRecord'
+import {
+  type RawRecord,
+  type DirtyRaw,
+  sanitizedRaw,
+  setRawSanitized,
+  changedColumns,
+} from '../RawRecord'
 import { setRawColumnChange } from '../sync/helpers'
 
 import { createTimestampsFor, fetchDescendants } from './helpers'
@@ -67,6 +73,13 @@ export default class Model {
 
   _preparedState: null | 'create' | 'update' | 'markAsDeleted' | 'destroyPermanently' = null
 
+  // Columns changed by a pending prepareUpdate() - lets adapters write only what changed
+  _preparedUpdateColumns: ?(ColumnName[]) = null
+
+  // Set if a batch that updated this record failed - `_raw` then differs from what's saved, so the
+  // next update must write all columns
+  _hasUnsavedUpdate: boolean = false
+
   __changes: ?BehaviorSubject<$FlowFixMe<this>> = null
 
   _getChanges(): BehaviorSubject<$FlowFixMe<this>> {
@@ -129,6 +142,7 @@ export default class Model {
     )
     this.__ensureNotDisposable(`Model.prepareUpdate()`)
     this._isEditing = true
+    const rawBefore = Object.assign({}, this._raw) // faster than object spread
 
     // Touch updatedAt (if available)
     if ('updatedAt' in this) {
@@ -139,6 +153,10 @@ export default class Model {
     ensureSync(recordUpdater(this))
     this._isEditing = false
     this._preparedState = 'update'
+    this._preparedUpdateColumns = this._hasUnsavedUpdate
+      ? null
+      : changedColumns(rawBefore, this._raw, this.collection.schema)
+    this._hasUnsavedUpdate = false
 
     // TODO: `process.nextTick` doesn't work on React Native
     // We could polyfill with setImmediate, but it doesn't have the same effect — test and enseure
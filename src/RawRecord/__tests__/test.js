@@ -1,7 +1,7 @@
 import { omit } from 'rambdax'
 
 import { tableSchema } from '../../Schema'
-import { setRawSanitized, sanitizedRaw, nullValue } from '../index'
+import { setRawSanitized, sanitizedRaw, nullValue, changedColumns } from '../index'
 import { expectedSanitizations } from './helpers'
 
 const mockTaskSchema = tableSchema({
@@ -197,6 +197,23 @@ describe('setRawSanitized()', () => {
   })
 })
 
+describe('changedColumns()', () => {
+  it('returns columns that changed between two raws, in schema order', () => {
+    const before = sanitizedRaw({ id: 't1', name: 'foo', project_position: 1 }, mockTaskSchema)
+    expect(changedColumns(before, { ...before }, mockTaskSchema)).toEqual([])
+
+    const after = { ...before, _changed: 'is_abandonned,name', is_abandonned: true, name: 'bar' }
+    expect(changedColumns(before, after, mockTaskSchema)).toEqual([
+      '_changed',
+      'name',
+      'is_abandonned',
+    ])
+    expect(
+      changedColumns(before, { ...before, _status: 'updated', ended_at: 5 }, mockTaskSchema),
+    ).toEqual(['_status', 'ended_at'])
+  })
+})
+
 describe('nullValue()', () => {
   it('can return null value for any column schema', () => {
     expect(nullValue({ name: 'foo', type: 'string' })).toBe('')
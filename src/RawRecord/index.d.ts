@@ -32,6 +32,14 @@ export function setRawSanitized(
   columnSchema: ColumnSchema,
 ): void
 
+// Returns names of columns (including `_status` and `_changed`) whose values differ between two raws
+// of the same record, in schema order
+export function changedColumns(
+  rawBefore: RawRecord,
+  rawAfter: RawRecord,
+  tableSchema: TableSchema,
+): ColumnName[]
+
 export type NullValue = null | '' | 0 | false
 
 export function nullValue(columnSchema: ColumnSchema): NullValue
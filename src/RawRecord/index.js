@@ -116,6 +116,35 @@ export function setRawSanitized(
   _setRaw(rawRecord, columnName, value, columnSchema)
 }
 
+// Returns names of columns (including `_status` and `_changed`) whose values differ between two raws
+// of the same record, in schema order
+export function changedColumns(
+  rawBefore: RawRecord,
+  rawAfter: RawRecord,
+  tableSchema: TableSchema,
+): ColumnName[] {
+  const before: Object = rawBefore
+  const after: Object = rawAfter
+  const changed: ColumnName[] = []
+
+  if (before._status !== after._status) {
+    changed.push(('_status': any))
+  }
+  if (before._changed !== after._changed) {
+    changed.push(('_changed': any))
+  }
+
+  const columns = tableSchema.columnArray
+  for (let i = 0, len = columns.length; i < len; i++) {
+    const { name } = columns[i]
+    if (before[name] !== after[name]) {
+      changed.push(name)
+    }
+  }
+
+  return changed
+}
+
 export type NullValue = null | '' | 0 | false
 
 export function nullValue(columnSchema: ColumnSchema): NullValue {
@@ -19,6 +19,7 @@ import {
   taskQuery,
   mockTaskRaw,
   performMatchTest,
+  performObservationMatchTest,
   performJoinTest,
   expectSortedEqual,
   MockTask,
@@ -120,6 +121,30 @@ export default () => {
     // returns null if not found
     expect(await adapter.find('tasks', 's4')).toBe(null)
   })
+  it('can find many records at once', async (_adapter) => {
+    let adapter = _adapter
+
+    // (more records than natively fetched in one statement)
+    const ids = Array.from({ length: 300 }, (_, i) => `s${i}`)
+    const records = ids.map((id, i) => mockTaskRaw({ id, order: i }))
+    await adapter.batch(records.map((record) => ['create', 'tasks', record]))
+    adapter = await adapter.testClone()
+
+    // some records are cached
+    expect(await adapter.find('tasks', 's1')).toEqual(records[1])
+    expect(await adapter.find('tasks', 's299')).toEqual(records[299])
+
+    // returns results in order of ids - raw if not cached, ID if cached, or null if not found
+    const requestedIds = ['s299', 'none1', 's1', 's0', 's0', 'none2'].concat(ids.slice(2, 299))
+    const results = await adapter.findMany('tasks', requestedIds)
+    expect(results.length).toBe(requestedIds.length)
+    expect(results.slice(0, 6)).toEqual(['s299', null, 's1', records[0], 's0', null])
+    expect(results.slice(6)).toEqual(records.slice(2, 299))
+
+    // caches found records
+    expect(await adapter.findMany('tasks', ['s0', 's2', 'none1'])).toEqual(['s0', 's2', null])
+    expect(await adapter.findMany('tasks', [])).toEqual([])
+  })
   it('can cache non-global IDs on find', async (_adapter) => {
     let adapter = _adapter
 
@@ -706,6 +731,199 @@ export default () => {
     await check({ naughty: 'foo{\nbar\0' })
     await check({ _naughty: { '_naughty\n{\0': 'yes' } })
   })
+  it(`can unsafely apply incremental sync JSON`, async (adapter, AdapterClass, extraAdapterOptions, platform) => {
+    if (
+      !(
+        AdapterClass.name === 'SQLiteAdapter' &&
+        adapter.underlyingAdapter._dispatcherType === 'jsi' &&
+        platform !== 'windows'
+      )
+    ) {
+      await expectToRejectWithMessage(
+        adapter.unsafeLoadIncrementalFromSync(0),
+        'unsafeLoadIncrementalFromSync unavailable',
+      )
+      return
+    }
+
+    await adapter.batch([
+      [
+        'create',
+        'tasks',
+        mockTaskRaw({ id: 't1', text1: 'a', text2: 'a', num1: 1, _status: 'synced' }),
+      ],
+      [
+        'create',
+        'tasks',
+        mockTaskRaw({ id: 't2', text1: 'a', text2: 'a', _status: 'updated', _changed: 'text1' }),
+      ],
+      ['create', 'tasks', mockTaskRaw({ id: 't3', _status: 'synced' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't4', text1: 'a', _status: 'deleted' })],
+    ])
+
+    const id = Math.round(Math.random() * 1000 * 1000 * 1000)
+    await adapter.provideSyncJson(
+      id,
+      JSON.stringify({
+        changes: {
+          tasks: {
+            created: [{ id: 't5', text1: 'remote' }],
+            updated: [
+              { id: 't1', text1: 'remote', num1: 'invalid' },
+              { id: 't2', text1: 'remote', text2: 'remote' },
+              { id: 't4', text1: 'remote' },
+            ],
+            deleted: ['t3'],
+          },
+        },
+        timestamp: 2000,
+      }),
+    )
+    const { residualValues, changes } = await adapter.unsafeLoadIncrementalFromSync(id)
+    expect(residualValues).toEqual({ timestamp: 2000 })
+    expect(changes.tasks.updated).toEqual(['t5', 't1', 't2'])
+    expect(changes.tasks.destroyed).toEqual(['t3'])
+
+    const raws = await adapter.unsafeQueryRaw(taskQuery())
+    const rawFor = (recordId) => raws.find((raw) => raw.id === recordId)
+    // remote record is inserted as synced
+    expect(rawFor('t5')).toMatchObject({ text1: 'remote', _status: 'synced', _changed: '' })
+    // remote changes are applied (and sanitized), locally changed columns win
+    // NOTE: Columns missing from the remote record keep local values (same as resolveConflict in JS)
+    expect(rawFor('t1')).toMatchObject({ text1: 'remote', text2: 'a', num1: 0, _status: 'synced' })
+    expect(rawFor('t2')).toMatchObject({
+      text1: 'a',
+      text2: 'remote',
+      _status: 'updated',
+      _changed: 'text1',
+    })
+    // locally deleted records are left alone, remotely deleted records are destroyed
+    expect(rawFor('t4')).toMatchObject({ text1: 'a', _status: 'deleted' })
+    expect(rawFor('t3')).toBe(undefined)
+  })
+  it(`can report progress of loading from sync JSON`, async (adapter, AdapterClass, extraAdapterOptions, platform) => {
+    if (
+      !(
+        AdapterClass.name === 'SQLiteAdapter' &&
+        adapter.underlyingAdapter._dispatcherType === 'jsi' &&
+        platform !== 'windows'
+      )
+    ) {
+      return
+    }
+
+    const loadFromSync = async (json, onProgress) => {
+      const id = Math.round(Math.random() * 1000 * 1000 * 1000)
+      await adapter.provideSyncJson(id, JSON.stringify(json))
+      return adapter.unsafeLoadFromSync(id, onProgress)
+    }
+
+    // final progress is always reported
+    const reports = []
+    let reentrantCallError = null
+    const json = { changes: { tasks: { created: [{ id: 't1' }, { id: 't2' }] } } }
+    await loadFromSync(json, (progress) => {
+      reports.push(progress)
+      // the database is busy with the load, so it can't be used here
+      adapter.underlyingAdapter.getLocal('foo', (result) => {
+        reentrantCallError = result.error
+      })
+    })
+    const lastReport = reports[reports.length - 1]
+    expect(lastReport.bytesParsed).toBe(lastReport.bytesTotal)
+    expect(lastReport.rowsInserted).toEqual({ tasks: 2 })
+    expect(reentrantCallError.message).toMatch('another call to it is in progress')
+
+    // returning false cancels the load
+    await expectToRejectWithMessage(
+      loadFromSync({ changes: { tasks: { created: [{ id: 't3' }] } } }, () => false),
+      'Sync load was cancelled',
+    )
+    expect(await adapter.queryIds(taskQuery())).toEqual(['t1', 't2'])
+  })
+  it(`can fetch local changes as JSON`, async (adapter, AdapterClass) => {
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      expect(await adapter.fetchLocalChangesJSON(['tasks'])).toBe(null)
+      return
+    }
+
+    const t1 = mockTaskRaw({ id: 't1', text1: 'a "quoted"\n\\', num1: 0.1, bool1: true })
+    const t2 = mockTaskRaw({ id: 't2', float1: -1.5e-7, bool2: true })
+    t2._status = 'updated'
+    t2._changed = 'float1,bool2'
+    await adapter.batch([
+      ['create', 'tasks', t1],
+      ['create', 'tasks', t2],
+      ['create', 'tasks', mockTaskRaw({ id: 't3', _status: 'synced' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't4', _status: 'deleted' })],
+    ])
+
+    const { changes, hashes } = JSON.parse(
+      await adapter.fetchLocalChangesJSON(['tasks', 'projects']),
+    )
+    expect(changes).toEqual({
+      tasks: { created: [t1], updated: [t2], deleted: ['t4'] },
+      projects: { created: [], updated: [], deleted: [] },
+    })
+    expect(Object.keys(hashes.tasks).sort()).toEqual(['t1', 't2'])
+    expect(Number.isSafeInteger(hashes.tasks.t1)).toBe(true)
+    expect(hashes.tasks.t1).not.toBe(hashes.tasks.t2)
+    expect(hashes.projects).toEqual({})
+  })
+  it(`can mark records as synced natively`, async (adapter, AdapterClass) => {
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      await expectToRejectWithMessage(adapter.markAsSynced([]), 'markAsSynced unavailable')
+      return
+    }
+
+    await adapter.batch([
+      ['create', 'tasks', mockTaskRaw({ id: 't1', text1: 'a' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't2', text1: 'a' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't3', _status: 'deleted' })],
+    ])
+    const { hashes } = JSON.parse(await adapter.fetchLocalChangesJSON(['tasks']))
+
+    // t2 changes after it was pushed
+    await adapter.batch([['update', 'tasks', mockTaskRaw({ id: 't2', text1: 'b' })]])
+
+    const result = await adapter.markAsSynced([
+      [
+        'tasks',
+        [
+          ['t1', hashes.tasks.t1],
+          ['t2', hashes.tasks.t2],
+        ],
+        ['t3'],
+      ],
+    ])
+    expect(result).toEqual({ tasks: { synced: ['t1'], destroyed: ['t3'] } })
+
+    const raws = await adapter.unsafeQueryRaw(taskQuery())
+    const rawFor = (recordId) => raws.find((raw) => raw.id === recordId)
+    expect(rawFor('t1')).toMatchObject({ text1: 'a', _status: 'synced', _changed: '' })
+    expect(rawFor('t2')).toMatchObject({ text1: 'b', _status: 'created' })
+    expect(rawFor('t3')).toBe(undefined)
+  })
+  it(`fails to unsafely load from a missing sync JSON file`, async (adapter, AdapterClass) => {
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      await expectToRejectWithMessage(
+        adapter.unsafeLoadFromSyncFile('/sync.json'),
+        'unsafeLoadFromSyncFile unavailable',
+      )
+      return
+    }
+
+    await expectToRejectWithMessage(
+      adapter.unsafeLoadFromSyncFile('/watermelondb-missing-dir/sync.json'),
+      'Failed to open JSON file',
+    )
+  })
   it(`destroys provided jsons after being used`, async (adapter, AdapterClass, extraAdapterOptions, platform) => {
     if (
       !(
@@ -823,6 +1041,250 @@ export default () => {
     const record = await adapter.find('tasks', 'rec1')
     expect(record).toMatchObject({ id: 'rec1', text1: 'bar' })
   })
+  it(`reports records changed by unsafe raw commands`, async (adapter, AdapterClass) => {
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      return
+    }
+
+    await adapter.batch([
+      ['create', 'tasks', mockTaskRaw({ id: 't1', text1: 'a' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't2', text1: 'a' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't3', text1: 'a' })],
+    ])
+
+    // NOTE: Unless sqlite reports IDs of deleted rows (see ChangeFeed.h), rows deleted by raw SQL are
+    // only reported if known to JS (these were created by JS)
+    const changes = await adapter.unsafeExecute({
+      sqls: [
+        ['insert into tasks (id, text1) values (?, ?)', ['t4', 'b']],
+        ['update tasks set text1 = ? where id = ?', ['b', 't1']],
+        ['update tasks set text1 = ? where id = ?', ['b', 't4']],
+        ['delete from tasks where text1 = ?', ['a']],
+        ['insert or replace into local_storage (key, value) values (?, ?)', ['k', 'v']],
+      ],
+    })
+    expect(Object.keys(changes)).toEqual(['tasks'])
+    expect(changes.tasks.created).toEqual(['t4'])
+    expect(changes.tasks.updated).toEqual(['t1'])
+    expect(changes.tasks.destroyed.sort()).toEqual(['t2', 't3'])
+
+    expect(
+      await adapter.unsafeExecute({
+        sqlString: `update tasks set text1 = 'c'; insert into tasks (id) values ('t5')`,
+      }),
+    ).toEqual({ tasks: { created: ['t5'], updated: ['t1', 't4'], destroyed: [] } })
+  })
+  it(`reports changes made by raw SQL with async batches`, async (adapter, AdapterClass) => {
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      return
+    }
+
+    adapter = await adapter.testClone({ experimentalAsyncBatches: true })
+    await adapter.batch([['create', 'tasks', mockTaskRaw({ id: 't1', text1: 'a' })]])
+
+    const changes = await adapter.unsafeExecute({
+      sqls: [
+        ['insert into tasks (id, text1) values (?, ?)', ['t2', 'b']],
+        ['update tasks set text1 = ? where id = ?', ['b', 't1']],
+      ],
+    })
+    expect(changes).toEqual({ tasks: { created: ['t2'], updated: ['t1'], destroyed: [] } })
+  })
+  it(`can observe queries natively`, async (adapter, AdapterClass) => {
+    // NOTE: This is only supported with JSI, and only if enabled
+    expect(await adapter.observeQuery(taskQuery())).toBe(null)
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      return
+    }
+
+    adapter = await adapter.testClone({ experimentalNativeQueryObservation: true })
+    await adapter.batch([
+      ['create', 'tasks', mockTaskRaw({ id: 't1', text1: 'a' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't2', text1: 'b' })],
+    ])
+
+    // incrementally updated queries (with conditions checked natively, or using SQL), and a query
+    // that has to be re-run
+    const [simpleId, simpleResults] = await adapter.observeQuery(taskQuery(Q.where('text1', 'a')))
+    const [sqlId, sqlResults] = await adapter.observeQuery(
+      taskQuery(Q.unsafeSqlExpr(`tasks.text1 = 'a'`)),
+    )
+    const [sortedId, sortedResults] = await adapter.observeQuery(
+      taskQuery(Q.sortBy('text1', Q.desc)),
+    )
+    expect(simpleResults).toEqual(['t1'])
+    expect(sqlResults).toEqual(['t1'])
+    expect(sortedResults).toEqual(['t2', 't1'])
+    expect(await adapter.fetchQueryObserverChanges(simpleId)).toBe(null)
+    expect(await adapter.fetchQueryObserverChanges(sqlId)).toBe(null)
+    expect(await adapter.fetchQueryObserverChanges(sortedId)).toBe(null)
+
+    await adapter.batch([
+      ['create', 'tasks', mockTaskRaw({ id: 't3', text1: 'a' })],
+      ['update', 'tasks', mockTaskRaw({ id: 't1', text1: 'c' })],
+    ])
+    expect(await adapter.fetchQueryObserverChanges(simpleId)).toEqual({
+      added: ['t3'],
+      removed: ['t1'],
+    })
+    expect(await adapter.fetchQueryObserverChanges(simpleId)).toBe(null)
+    expect(await adapter.fetchQueryObserverChanges(sqlId)).toEqual({
+      added: ['t3'],
+      removed: ['t1'],
+    })
+    expect(await adapter.fetchQueryObserverChanges(sortedId)).toEqual({
+      records: ['t1', 't2', 't3'],
+    })
+
+    // irrelevant changes
+    await adapter.batch([['update', 'tasks', mockTaskRaw({ id: 't2', text1: 'd' })]])
+    expect(await adapter.fetchQueryObserverChanges(simpleId)).toBe(null)
+    expect(await adapter.fetchQueryObserverChanges(sortedId)).toEqual({
+      records: ['t2', 't1', 't3'],
+    })
+
+    // changes made by raw SQL are observed, too (records unknown to JS are sent in full)
+    await adapter.unsafeExecute({
+      sqls: [['insert into tasks (id, text1) values (?, ?)', ['t4', 'a']]],
+    })
+    const changes = await adapter.fetchQueryObserverChanges(simpleId)
+    expect(changes.added).toMatchObject([{ id: 't4', text1: 'a' }])
+    expect(changes.removed).toEqual([])
+
+    // changes not reported by sqlite (truncating a table) are observed, too
+    await adapter.unsafeExecute({ sqls: [['delete from tasks', []]] })
+    const truncateChanges = await adapter.fetchQueryObserverChanges(simpleId)
+    expect(truncateChanges.added).toEqual([])
+    expect(truncateChanges.removed.sort()).toEqual(['t3', 't4'])
+    expect(await adapter.fetchQueryObserverChanges(sqlId)).toEqual({ added: [], removed: ['t3'] })
+    expect(await adapter.fetchQueryObserverChanges(sortedId)).toEqual({ records: [] })
+    expect(await adapter.fetchQueryObserverChanges(simpleId)).toBe(null)
+
+    await adapter.unobserveQuery(simpleId)
+    await adapter.unobserveQuery(sqlId)
+    await adapter.unobserveQuery(sortedId)
+    await expectToRejectWithMessage(
+      adapter.fetchQueryObserverChanges(simpleId),
+      'does not exist',
+    )
+  })
+  it(`returns new column names with each array query result`, async (adapter, AdapterClass) => {
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      return
+    }
+
+    adapter = await adapter.testClone()
+    await adapter.unsafeExecute({
+      sqls: [['insert into tasks (id, text1) values (?, ?)', ['t1', 'a']]],
+    })
+    const db = adapter.underlyingAdapter._dispatcher._db
+    const sql = 'select id, text1 from tasks'
+    const [header] = db.queryAsArray('tasks', sql, [])
+    expect(header).toEqual(['id', 'text1'])
+
+    // mutating results in JS doesn't affect later results
+    header[0] = 'foo'
+    header.push('bar')
+    const [header2] = db.queryAsArray('tasks', sql, [])
+    expect(header2).toEqual(['id', 'text1'])
+    expect(header2).not.toBe(header)
+  })
+  it(`can page through query results with a cursor`, async (adapter, AdapterClass) => {
+    // NOTE: This is only supported with JSI
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      await expectToRejectWithMessage(adapter.queryCursor(taskQuery()), 'queryCursor unavailable')
+      return
+    }
+
+    await adapter.batch([
+      ['create', 'tasks', mockTaskRaw({ id: 't1' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't2' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't3' })],
+    ])
+    // (not cached in JS)
+    await adapter.unsafeExecute({
+      sqls: [
+        ['insert into tasks (id, text1) values (?, ?)', ['t4', 'a']],
+        ['insert into tasks (id, text1) values (?, ?)', ['t5', 'b']],
+      ],
+    })
+
+    // next
+    const cursor = await adapter.queryCursor(taskQuery(Q.sortBy('id')))
+    expect(await cursor.next(2)).toEqual(['t1', 't2'])
+    const page = await cursor.next(2)
+    expect(page[0]).toBe('t3')
+    expect(page[1]).toMatchObject({ id: 't4', text1: 'a' })
+    expect(await cursor.next(2)).toMatchObject([{ id: 't5', text1: 'b' }])
+    expect(await cursor.next(2)).toEqual([])
+    await cursor.close()
+
+    // close early
+    const closedCursor = await adapter.queryCursor(taskQuery(Q.sortBy('id')))
+    expect(await closedCursor.next(1)).toEqual(['t1'])
+    await closedCursor.close()
+    expect(await closedCursor.next(1)).toEqual([])
+    await closedCursor.close()
+
+    // database can be used with a cursor open, and reset
+    const openCursor = await adapter.queryCursor(taskQuery(Q.sortBy('id')))
+    expect(await openCursor.next(1)).toEqual(['t1'])
+    expect(await adapter.count(taskQuery())).toBe(5)
+    await adapter.unsafeResetDatabase()
+    expect(await openCursor.next(1)).toEqual([])
+    expect(await adapter.count(taskQuery())).toBe(0)
+  })
+  it(`can run multiple read operations at once`, async (adapter, AdapterClass) => {
+    // NOTE: This is only supported with JSI
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      await expectToRejectWithMessage(adapter.multiQuery([]), 'multiQuery unavailable')
+      return
+    }
+
+    await adapter.batch([
+      ['create', 'tasks', mockTaskRaw({ id: 't1', text1: 'a' })],
+      ['create', 'tasks', mockTaskRaw({ id: 't2', text1: 'b' })],
+    ])
+    await adapter.setLocal('key', 'value')
+
+    const results = await adapter.multiQuery([
+      ['find', 'tasks', 't1'],
+      ['find', 'tasks', 'nonexisting'],
+      ['query', taskQuery(Q.where('text1', 'b'))],
+      ['queryIds', taskQuery()],
+      ['count', taskQuery()],
+      ['getLocal', 'key'],
+      ['unsafeQueryRaw', taskQuery(Q.where('text1', 'a'))],
+      ['query', taskQuery(Q.unsafeSqlQuery('select * from nonexisting'))],
+    ])
+    expect(results.length).toBe(8)
+    expect(results[0]).toEqual({ value: 't1' })
+    expect(results[1]).toEqual({ value: null })
+    expect(results[2]).toEqual({ value: ['t2'] })
+    expect(results[3].value.sort()).toEqual(['t1', 't2'])
+    expect(results[4]).toEqual({ value: 2 })
+    expect(results[5]).toEqual({ value: 'value' })
+    expect(results[6].value).toMatchObject([{ id: 't1', text1: 'a' }])
+    // failing operations don't affect others
+    expect(results[7].error.message).toMatch('no such table')
+
+    // transaction is ended, even if an operation failed
+    await adapter.batch([['create', 'tasks', mockTaskRaw({ id: 't3' })]])
+    expect(await adapter.count(taskQuery())).toBe(3)
+    expect(await adapter.multiQuery([])).toEqual([])
+  })
   it('supports LocalStorage', async (adapter) => {
     // non-existent fields return undefined
     expect(await adapter.getLocal('nonexisting')).toBeNull()
@@ -1222,6 +1684,27 @@ export default () => {
       } else {
         await perform()
       }
+
+      // check that native query observation agrees with querying
+      if (
+        AdapterClass.name === 'SQLiteAdapter' &&
+        adapter.underlyingAdapter._dispatcherType === 'jsi' &&
+        !shouldSkip &&
+        !testCase.skipQuery
+      ) {
+        const observingAdapter = await adapter.testClone({ experimentalNativeQueryObservation: true })
+        await performObservationMatchTest(observingAdapter, testCase)
+      }
+
+      // check that queries encoded natively give the same results
+      if (
+        AdapterClass.name === 'SQLiteAdapter' &&
+        adapter.underlyingAdapter._dispatcherType === 'jsi' &&
+        !shouldSkip
+      ) {
+        const encodingAdapter = await adapter.testClone({ experimentalNativeQueryEncoding: true })
+        await performMatchTest(encodingAdapter, testCase)
+      }
     }),
   )
   joinTests.forEach((testCase) =>
@@ -1235,8 +1718,54 @@ export default () => {
       } else {
         await perform()
       }
+
+      // check that queries encoded natively give the same results
+      if (
+        AdapterClass.name === 'SQLiteAdapter' &&
+        adapter.underlyingAdapter._dispatcherType === 'jsi' &&
+        !shouldSkip
+      ) {
+        // (extra records are already inserted)
+        const encodingAdapter = await adapter.testClone({ experimentalNativeQueryEncoding: true })
+        await performMatchTest(encodingAdapter, testCase)
+      }
     }),
   )
+  it(`gives the same results when queries are encoded natively in a single call`, async (adapter, AdapterClass) => {
+    if (
+      !(AdapterClass.name === 'SQLiteAdapter' && adapter.underlyingAdapter._dispatcherType === 'jsi')
+    ) {
+      return
+    }
+
+    const jsAdapter = adapter
+    const nativeAdapter = await adapter.testClone({ experimentalNativeQueryEncoding: true })
+    expect(nativeAdapter.underlyingAdapter._singleCallQueries).toBe(true)
+
+    const sample = 50
+    const raws = []
+    for (let i = 0; i < sample; i++) {
+      raws.push(['create', 'tasks', mockTaskRaw({ id: `t${i}`, num1: i, text1: `${i % 10}` })])
+    }
+    await adapter.batch(raws)
+
+    // (queries of the same shape that differ only by values)
+    const conditions = (i) => [Q.where('num1', Q.gte(i)), Q.where('text1', Q.notEq(`${i % 10}`))]
+    const getIds = (records) => records.map((raw) => (typeof raw === 'string' ? raw : raw.id))
+    const fetchAll = async (queryAdapter) => {
+      const results = []
+      for (let i = 0; i < sample; i++) {
+        const query = taskQuery(...conditions(i), Q.sortBy('num1', Q.desc), Q.take(20))
+        // eslint-disable-next-line no-await-in-loop
+        results.push(getIds(await queryAdapter.query(query)))
+        // eslint-disable-next-line no-await-in-loop
+        results.push(await queryAdapter.count(taskQuery(...conditions(i))))
+      }
+      return results
+    }
+
+    expect(await fetchAll(nativeAdapter)).toEqual(await fetchAll(jsAdapter))
+  })
   it('[shared match test] can match strings from big-list-of-naughty-strings', async (adapter, AdapterClass, extraAdapterOptions, platform) => {
     // eslint-disable-next-line no-restricted-syntax
     for (const testCase of naughtyMatchTests) {
@@ -202,6 +202,35 @@ export const performMatchTest = async (adapter, testCase) => {
   )
 }
 
+// Checks that a natively observed query reports the same records as fetching it
+export const performObservationMatchTest = async (adapter, testCase) => {
+  const { matching, nonMatching, query: conditions } = testCase
+  const [observerId, initialResults] = await adapter.observeQuery(taskQuery(...conditions))
+  expect(initialResults).toEqual([])
+
+  await insertAll(adapter, 'tasks', shuffle(matching))
+  await insertAll(adapter, 'tasks', shuffle(nonMatching))
+
+  // NOTE: Records created in a batch are known to JS, so only their IDs are sent
+  const changes = await adapter.fetchQueryObserverChanges(observerId)
+  const expectedResults = getExpectedResults(matching)
+  const results = changes ? changes.added || changes.records : []
+  expect(sort(results)).toEqual(expectedResults)
+
+  await adapter.batch(
+    [...matching, ...nonMatching].map(({ id }) => ['destroyPermanently', 'tasks', id]),
+  )
+  const changesAfterDestroy = await adapter.fetchQueryObserverChanges(observerId)
+  if (!matching.length) {
+    expect(changesAfterDestroy).toBe(null)
+  } else if (changesAfterDestroy.records) {
+    expect(changesAfterDestroy.records).toEqual([])
+  } else {
+    expect(sort(changesAfterDestroy.removed)).toEqual(expectedResults)
+  }
+  await adapter.unobserveQuery(observerId)
+}
+
 export const performJoinTest = async (adapter, testCase) => {
   const pairs = toPairs(testCase.extraRecords)
   await allPromises(([table, records]) => insertAll(adapter, table, records), pairs)
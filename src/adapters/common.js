@@ -3,7 +3,7 @@
 // don't import the whole utils/ here!
 import invariant from '../utils/common/invariant'
 import logger from '../utils/common/logger'
-import { type Result } from '../utils/fp/Result'
+import { type Result, type ResultCallback } from '../utils/fp/Result'
 import type { RecordId } from '../Model'
 import type { TableSchema, AppSchema, TableName } from '../Schema'
 import type { CachedQueryResult, CachedFindResult, DatabaseAdapter } from './type'
@@ -56,6 +56,31 @@ export function sanitizeFindResult(
     : dirtyRecord
 }
 
+// Fetches records one by one (for adapters that can't fetch many records at once)
+export function findManyUsingFind(
+  adapter: DatabaseAdapter,
+  table: TableName<any>,
+  ids: RecordId[],
+  callback: ResultCallback<CachedFindResult[]>,
+): void {
+  const results = []
+  const findNext = () => {
+    if (results.length === ids.length) {
+      callback({ value: results })
+      return
+    }
+    adapter.find(table, ids[results.length], (result) => {
+      if (result.error) {
+        callback(result)
+        return
+      }
+      results.push(result.value)
+      findNext()
+    })
+  }
+  findNext()
+}
+
 export function sanitizeQueryResult(
   dirtyRecords: DirtyQueryResult,
   tableSchema: TableSchema,
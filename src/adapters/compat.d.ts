@@ -2,6 +2,8 @@ import type { SerializedQuery } from '../Query'
 import type { TableName, AppSchema } from '../Schema'
 import type { SchemaMigrations } from '../Schema/migrations'
 import type { RecordId } from '../Model'
+import type { $Exact } from '../types'
+import type { Result } from '../utils/fp/Result'
 
 import type {
   DatabaseAdapter,
@@ -9,8 +11,19 @@ import type {
   CachedQueryResult,
   BatchOperation,
   UnsafeExecuteOperations,
+  UnsafeExecuteChanges,
+  QueryObserverChanges,
+  MultiQueryOperation,
+  TurboSyncProgressCallback,
+  MarkAsSyncedOperation,
+  MarkAsSyncedResult,
 } from './type'
 
+export type QueryCursorCompat = $Exact<{
+  next: (count: number) => Promise<CachedQueryResult>
+  close: () => Promise<void>
+}>
+
 export default class DatabaseAdapterCompat {
   underlyingAdapter: DatabaseAdapter
 
@@ -24,12 +37,24 @@ export default class DatabaseAdapterCompat {
 
   find(table: TableName<any>, id: RecordId): Promise<CachedFindResult>
 
+  findMany(table: TableName<any>, ids: RecordId[]): Promise<CachedFindResult[]>
+
   query(query: SerializedQuery): Promise<CachedQueryResult>
 
   queryIds(query: SerializedQuery): Promise<RecordId[]>
 
+  observeQuery(query: SerializedQuery): Promise<[number, CachedQueryResult] | null>
+
+  fetchQueryObserverChanges(observerId: number): Promise<QueryObserverChanges | null>
+
+  unobserveQuery(observerId: number): Promise<void>
+
   unsafeQueryRaw(query: SerializedQuery): Promise<any[]>
 
+  queryCursor(query: SerializedQuery): Promise<QueryCursorCompat>
+
+  multiQuery(operations: MultiQueryOperation[]): Promise<Result<any>[]>
+
   count(query: SerializedQuery): Promise<number>
 
   batch(operations: BatchOperation[]): Promise<void>
@@ -38,13 +63,21 @@ export default class DatabaseAdapterCompat {
 
   destroyDeletedRecords(tableName: TableName<any>, recordIds: RecordId[]): Promise<void>
 
-  unsafeLoadFromSync(jsonId: number): Promise<any>
+  unsafeLoadFromSync(jsonId: number, onProgress?: TurboSyncProgressCallback): Promise<any>
+
+  unsafeLoadFromSyncFile(path: string, onProgress?: TurboSyncProgressCallback): Promise<any>
+
+  unsafeLoadIncrementalFromSync(jsonId: number): Promise<any>
+
+  fetchLocalChangesJSON(tables: TableName<any>[]): Promise<string | null>
+
+  markAsSynced(operations: MarkAsSyncedOperation[]): Promise<MarkAsSyncedResult>
 
   provideSyncJson(id: number, syncPullResultJson: string): Promise<void>
 
   unsafeResetDatabase(): Promise<void>
 
-  unsafeExecute(work: UnsafeExecuteOperations): Promise<void>
+  unsafeExecute(work: UnsafeExecuteOperations): Promise<UnsafeExecuteChanges | null>
 
   getLocal(key: string): Promise<string | undefined>
 
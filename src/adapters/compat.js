@@ -4,7 +4,7 @@ import type { SerializedQuery } from '../Query'
 import type { TableName, AppSchema } from '../Schema'
 import type { SchemaMigrations } from '../Schema/migrations'
 import type { RecordId } from '../Model'
-import { toPromise } from '../utils/fp/Result'
+import { type Result, toPromise } from '../utils/fp/Result'
 
 import type {
   DatabaseAdapter,
@@ -12,8 +12,25 @@ import type {
   CachedQueryResult,
   BatchOperation,
   UnsafeExecuteOperations,
+  UnsafeExecuteChanges,
+  QueryObserverChanges,
+  QueryCursor,
+  MultiQueryOperation,
+  TurboSyncProgressCallback,
+  MarkAsSyncedOperation,
+  MarkAsSyncedResult,
 } from './type'
 
+export type QueryCursorCompat = $Exact<{
+  next: (count: number) => Promise<CachedQueryResult>,
+  close: () => Promise<void>,
+}>
+
+const cursorCompat = (cursor: QueryCursor): QueryCursorCompat => ({
+  next: (count) => toPromise((callback) => cursor.next(count, callback)),
+  close: () => toPromise((callback) => cursor.close(callback)),
+})
+
 export default class DatabaseAdapterCompat {
   underlyingAdapter: DatabaseAdapter
 
@@ -37,6 +54,10 @@ export default class DatabaseAdapterCompat {
     return toPromise((callback) => this.underlyingAdapter.find(table, id, callback))
   }
 
+  findMany(table: TableName<any>, ids: RecordId[]): Promise<CachedFindResult[]> {
+    return toPromise((callback) => this.underlyingAdapter.findMany(table, ids, callback))
+  }
+
   query(query: SerializedQuery): Promise<CachedQueryResult> {
     return toPromise((callback) => this.underlyingAdapter.query(query, callback))
   }
@@ -45,10 +66,35 @@ export default class DatabaseAdapterCompat {
     return toPromise((callback) => this.underlyingAdapter.queryIds(query, callback))
   }
 
+  observeQuery(query: SerializedQuery): Promise<?[number, CachedQueryResult]> {
+    return toPromise((callback) => this.underlyingAdapter.observeQuery(query, callback))
+  }
+
+  fetchQueryObserverChanges(observerId: number): Promise<?QueryObserverChanges> {
+    return toPromise((callback) =>
+      this.underlyingAdapter.fetchQueryObserverChanges(observerId, callback),
+    )
+  }
+
+  unobserveQuery(observerId: number): Promise<void> {
+    return toPromise((callback) => this.underlyingAdapter.unobserveQuery(observerId, callback))
+  }
+
   unsafeQueryRaw(query: SerializedQuery): Promise<any[]> {
     return toPromise((callback) => this.underlyingAdapter.unsafeQueryRaw(query, callback))
   }
 
+  async queryCursor(query: SerializedQuery): Promise<QueryCursorCompat> {
+    const cursor = await toPromise((callback) =>
+      this.underlyingAdapter.queryCursor(query, callback),
+    )
+    return cursorCompat(cursor)
+  }
+
+  multiQuery(operations: MultiQueryOperation[]): Promise<Result<any>[]> {
+    return toPromise((callback) => this.underlyingAdapter.multiQuery(operations, callback))
+  }
+
   count(query: SerializedQuery): Promise<number> {
     return toPromise((callback) => this.underlyingAdapter.count(query, callback))
   }
@@ -67,8 +113,30 @@ export default class DatabaseAdapterCompat {
     )
   }
 
-  unsafeLoadFromSync(jsonId: number): Promise<any> {
-    return toPromise((callback) => this.underlyingAdapter.unsafeLoadFromSync(jsonId, callback))
+  unsafeLoadFromSync(jsonId: number, onProgress?: ?TurboSyncProgressCallback): Promise<any> {
+    return toPromise((callback) =>
+      this.underlyingAdapter.unsafeLoadFromSync(jsonId, onProgress, callback),
+    )
+  }
+
+  unsafeLoadFromSyncFile(path: string, onProgress?: ?TurboSyncProgressCallback): Promise<any> {
+    return toPromise((callback) =>
+      this.underlyingAdapter.unsafeLoadFromSyncFile(path, onProgress, callback),
+    )
+  }
+
+  unsafeLoadIncrementalFromSync(jsonId: number): Promise<any> {
+    return toPromise((callback) =>
+      this.underlyingAdapter.unsafeLoadIncrementalFromSync(jsonId, callback),
+    )
+  }
+
+  fetchLocalChangesJSON(tables: TableName<any>[]): Promise<?string> {
+    return toPromise((callback) => this.underlyingAdapter.fetchLocalChangesJSON(tables, callback))
+  }
+
+  markAsSynced(operations: MarkAsSyncedOperation[]): Promise<MarkAsSyncedResult> {
+    return toPromise((callback) => this.underlyingAdapter.markAsSynced(operations, callback))
   }
 
   provideSyncJson(id: number, syncPullResultJson: string): Promise<void> {
@@ -81,7 +149,7 @@ export default class DatabaseAdapterCompat {
     return toPromise((callback) => this.underlyingAdapter.unsafeResetDatabase(callback))
   }
 
-  unsafeExecute(work: UnsafeExecuteOperations): Promise<void> {
+  unsafeExecute(work: UnsafeExecuteOperations): Promise<?UnsafeExecuteChanges> {
     return toPromise((callback) => this.underlyingAdapter.unsafeExecute(work, callback))
   }
 
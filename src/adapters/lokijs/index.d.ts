@@ -1,5 +1,5 @@
 import type { LokiMemoryAdapter } from './type'
-import type { ResultCallback } from '../../utils/fp/Result'
+import type { Result, ResultCallback } from '../../utils/fp/Result'
 
 import type { RecordId } from '../../Model'
 import type { TableName, AppSchema } from '../../Schema'
@@ -12,6 +12,13 @@ import type {
   CachedFindResult,
   BatchOperation,
   UnsafeExecuteOperations,
+  UnsafeExecuteChanges,
+  QueryObserverChanges,
+  QueryCursor,
+  MultiQueryOperation,
+  TurboSyncProgressCallback,
+  MarkAsSyncedOperation,
+  MarkAsSyncedResult,
 } from '../type'
 
 import LokiDispatcher from './dispatcher'
@@ -90,12 +97,34 @@ export default class LokiJSAdapter implements DatabaseAdapter {
 
   find(table: TableName<any>, id: RecordId, callback: ResultCallback<CachedFindResult>): void
 
+  findMany(
+    table: TableName<any>,
+    ids: RecordId[],
+    callback: ResultCallback<CachedFindResult[]>,
+  ): void
+
   query(query: SerializedQuery, callback: ResultCallback<CachedQueryResult>): void
 
   queryIds(query: SerializedQuery, callback: ResultCallback<RecordId[]>): void
 
+  observeQuery(
+    query: SerializedQuery,
+    callback: ResultCallback<[number, CachedQueryResult] | null>,
+  ): void
+
+  fetchQueryObserverChanges(
+    observerId: number,
+    callback: ResultCallback<QueryObserverChanges | null>,
+  ): void
+
+  unobserveQuery(observerId: number, callback: ResultCallback<void>): void
+
   unsafeQueryRaw(query: SerializedQuery, callback: ResultCallback<any[]>): void
 
+  queryCursor(query: SerializedQuery, callback: ResultCallback<QueryCursor>): void
+
+  multiQuery(operations: MultiQueryOperation[], callback: ResultCallback<Result<any>[]>): void
+
   count(query: SerializedQuery, callback: ResultCallback<number>): void
 
   batch(operations: BatchOperation[], callback: ResultCallback<void>): void
@@ -108,13 +137,38 @@ export default class LokiJSAdapter implements DatabaseAdapter {
     callback: ResultCallback<void>,
   ): void
 
-  unsafeLoadFromSync(jsonId: number, callback: ResultCallback<any>): void
+  unsafeLoadFromSync(
+    jsonId: number,
+    onProgress: TurboSyncProgressCallback | null | undefined,
+    callback: ResultCallback<any>,
+  ): void
+
+  unsafeLoadFromSyncFile(
+    path: string,
+    onProgress: TurboSyncProgressCallback | null | undefined,
+    callback: ResultCallback<any>,
+  ): void
+
+  unsafeLoadIncrementalFromSync(jsonId: number, callback: ResultCallback<any>): void
+
+  fetchLocalChangesJSON(
+    tables: TableName<any>[],
+    callback: ResultCallback<string | null>,
+  ): void
+
+  markAsSynced(
+    operations: MarkAsSyncedOperation[],
+    callback: ResultCallback<MarkAsSyncedResult>,
+  ): void
 
   provideSyncJson(id: number, syncPullResultJson: string, callback: ResultCallback<void>): void
 
   unsafeResetDatabase(callback: ResultCallback<void>): void
 
-  unsafeExecute(operations: UnsafeExecuteOperations, callback: ResultCallback<void>): void
+  unsafeExecute(
+    operations: UnsafeExecuteOperations,
+    callback: ResultCallback<UnsafeExecuteChanges | null>,
+  ): void
 
   getLocal(key: string, callback: ResultCallback<string | undefined>): void
 
@@ -4,7 +4,7 @@
 import type { LokiMemoryAdapter } from './type'
 import invariant from '../../utils/common/invariant'
 import logger from '../../utils/common/logger'
-import type { ResultCallback, Result } from '../../utils/fp/Result'
+import { type ResultCallback, type Result, mapValue } from '../../utils/fp/Result'
 
 import type { RecordId } from '../../Model'
 import type { TableName, AppSchema } from '../../Schema'
@@ -17,8 +17,15 @@ import type {
   CachedFindResult,
   BatchOperation,
   UnsafeExecuteOperations,
+  UnsafeExecuteChanges,
+  QueryObserverChanges,
+  QueryCursor,
+  MultiQueryOperation,
+  TurboSyncProgressCallback,
+  MarkAsSyncedOperation,
+  MarkAsSyncedResult,
 } from '../type'
-import { devSetupCallback, validateAdapter, validateTable } from '../common'
+import { devSetupCallback, validateAdapter, validateTable, findManyUsingFind } from '../common'
 
 import LokiDispatcher from './dispatcher'
 
@@ -144,6 +151,15 @@ export default class LokiJSAdapter implements DatabaseAdapter {
     this._dispatcher.call('find', [table, id], callback)
   }
 
+  findMany(
+    table: TableName<any>,
+    ids: RecordId[],
+    callback: ResultCallback<CachedFindResult[]>,
+  ): void {
+    validateTable(table, this.schema)
+    findManyUsingFind(this, table, ids, callback)
+  }
+
   query(query: SerializedQuery, callback: ResultCallback<CachedQueryResult>): void {
     validateTable(query.table, this.schema)
     this._dispatcher.call('query', [query], callback)
@@ -154,11 +170,38 @@ export default class LokiJSAdapter implements DatabaseAdapter {
     this._dispatcher.call('queryIds', [query], callback)
   }
 
+  observeQuery(
+    query: SerializedQuery,
+    callback: ResultCallback<?[number, CachedQueryResult]>,
+  ): void {
+    // (queries are observed in JS)
+    callback({ value: null })
+  }
+
+  fetchQueryObserverChanges(
+    observerId: number,
+    callback: ResultCallback<?QueryObserverChanges>,
+  ): void {
+    callback({ error: new Error('fetchQueryObserverChanges unavailable in LokiJS') })
+  }
+
+  unobserveQuery(observerId: number, callback: ResultCallback<void>): void {
+    callback({ error: new Error('unobserveQuery unavailable in LokiJS') })
+  }
+
   unsafeQueryRaw(query: SerializedQuery, callback: ResultCallback<any[]>): void {
     validateTable(query.table, this.schema)
     this._dispatcher.call('unsafeQueryRaw', [query], callback)
   }
 
+  queryCursor(query: SerializedQuery, callback: ResultCallback<QueryCursor>): void {
+    callback({ error: new Error('queryCursor unavailable in LokiJS') })
+  }
+
+  multiQuery(operations: MultiQueryOperation[], callback: ResultCallback<Result<any>[]>): void {
+    callback({ error: new Error('multiQuery unavailable in LokiJS') })
+  }
+
   count(query: SerializedQuery, callback: ResultCallback<number>): void {
     validateTable(query.table, this.schema)
     this._dispatcher.call('count', [query], callback)
@@ -190,10 +233,37 @@ export default class LokiJSAdapter implements DatabaseAdapter {
     )
   }
 
-  unsafeLoadFromSync(jsonId: number, callback: ResultCallback<any>): void {
+  unsafeLoadFromSync(
+    jsonId: number,
+    onProgress: ?TurboSyncProgressCallback,
+    callback: ResultCallback<any>,
+  ): void {
     callback({ error: new Error('unsafeLoadFromSync unavailable in LokiJS') })
   }
 
+  unsafeLoadFromSyncFile(
+    path: string,
+    onProgress: ?TurboSyncProgressCallback,
+    callback: ResultCallback<any>,
+  ): void {
+    callback({ error: new Error('unsafeLoadFromSyncFile unavailable in LokiJS') })
+  }
+
+  unsafeLoadIncrementalFromSync(jsonId: number, callback: ResultCallback<any>): void {
+    callback({ error: new Error('unsafeLoadIncrementalFromSync unavailable in LokiJS') })
+  }
+
+  fetchLocalChangesJSON(tables: TableName<any>[], callback: ResultCallback<?string>): void {
+    callback({ value: null })
+  }
+
+  markAsSynced(
+    operations: MarkAsSyncedOperation[],
+    callback: ResultCallback<MarkAsSyncedResult>,
+  ): void {
+    callback({ error: new Error('markAsSynced unavailable in LokiJS') })
+  }
+
   provideSyncJson(id: number, syncPullResultJson: string, callback: ResultCallback<void>): void {
     callback({ error: new Error('provideSyncJson unavailable in LokiJS') })
   }
@@ -202,8 +272,13 @@ export default class LokiJSAdapter implements DatabaseAdapter {
     this._dispatcher.call('unsafeResetDatabase', [], callback)
   }
 
-  unsafeExecute(operations: UnsafeExecuteOperations, callback: ResultCallback<void>): void {
-    this._dispatcher.call('unsafeExecute', [operations], callback)
+  unsafeExecute(
+    operations: UnsafeExecuteOperations,
+    callback: ResultCallback<?UnsafeExecuteChanges>,
+  ): void {
+    this._dispatcher.call('unsafeExecute', [operations], (result) =>
+      callback(mapValue(() => null, result)),
+    )
   }
 
   getLocal(key: string, callback: ResultCallback<?string>): void {
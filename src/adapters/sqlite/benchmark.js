@@ -0,0 +1,113 @@
+/* eslint-disable no-console */
+/* eslint-disable no-await-in-loop */
+
+import SQLiteAdapter from './index'
+import { testSchema, taskQuery, mockTaskRaw } from '../__tests__/helpers'
+import * as Q from '../../QueryDescription'
+import DatabaseAdapterCompat from '../compat'
+
+// NOTE: Benchmarks of the JSI SQLiteAdapter. They need a device (or simulator), so they're not part
+// of the test suite - to run them, set runBenchmarks=true in index.integrationTests.native.js and
+// run the native Tester project. Results are logged to the console
+
+const makeAdapter = async (options = {}) => {
+  const adapter = new SQLiteAdapter({
+    schema: testSchema,
+    dbName: `file:benchmarkdb${Math.random()}?mode=memory&cache=shared`,
+    jsi: true,
+    ...options,
+  })
+  await adapter.initializingPromise
+  return new DatabaseAdapterCompat(adapter)
+}
+
+// Logs how long each run of `block` took. `prepare` (not measured) is called before each run,
+// and its result is passed to `block`
+const measure = async (name, runs, block, prepare = async () => {}) => {
+  const times = []
+  for (let i = 0; i < runs; i++) {
+    const prepared = await prepare()
+    const start = Date.now()
+    await block(prepared)
+    times.push(Date.now() - start)
+  }
+  console.log(`${name}: ${times.join('ms, ')}ms`)
+}
+
+// Queries of the same shape that differ only by values, with queries encoded in JS vs natively in
+// a single call (experimentalNativeQueryEncoding)
+async function queryEncoding() {
+  const sample = 500
+  const jsAdapter = await makeAdapter()
+  const nativeAdapter = await jsAdapter.testClone({ experimentalNativeQueryEncoding: true })
+
+  const raws = []
+  for (let i = 0; i < sample; i++) {
+    raws.push(['create', 'tasks', mockTaskRaw({ id: `t${i}`, num1: i, text1: `${i % 10}` })])
+  }
+  await jsAdapter.batch(raws)
+
+  const conditions = (i) => [Q.where('num1', Q.gte(i)), Q.where('text1', Q.notEq(`${i % 10}`))]
+  const queries = []
+  for (let i = 0; i < sample; i++) {
+    queries.push([
+      taskQuery(...conditions(i), Q.sortBy('num1', Q.desc), Q.take(20)),
+      taskQuery(...conditions(i)),
+    ])
+  }
+  const fetchAll = (adapter) => async () => {
+    // eslint-disable-next-line no-restricted-syntax
+    for (const [query, countQuery] of queries) {
+      await adapter.query(query)
+      await adapter.count(countQuery)
+    }
+  }
+
+  await measure(`Query + count x${sample}, encoded in JS`, 5, fetchAll(jsAdapter))
+  await measure(`Query + count x${sample}, encoded natively`, 5, fetchAll(nativeAdapter))
+}
+
+// Turbo sync (unsafeLoadFromSync) of a big initial pull, into an empty database each run
+// NOTE: 1M records is ~300MB of JSON, so lower recordCount on devices without much memory
+async function turboSync(recordCount = 1000 * 1000) {
+  const records = new Array(recordCount)
+  for (let i = 0; i < recordCount; i++) {
+    records[i] = JSON.stringify({
+      id: `task${i}`,
+      project_id: `project${i % 100}`,
+      num1: i,
+      num2: i % 7,
+      num3: -i,
+      float1: i / 3,
+      float2: 0.5,
+      text1: `Task number ${i}`,
+      text2: i % 2 ? 'zażółć gęślą jaźń' : '',
+      bool1: i % 2 === 0,
+      bool2: false,
+      order: i * 10,
+      from: 'benchmark',
+      unknown_field: 'ignored',
+    })
+  }
+  const json = `{"changes":{"tasks":{"created":[${records.join(',')}],"updated":[],"deleted":[]}}}`
+  records.length = 0
+
+  let jsonId = 0
+  await measure(
+    `Turbo sync of ${recordCount} records`,
+    3,
+    ({ adapter, id }) => adapter.unsafeLoadFromSync(id),
+    async () => {
+      const adapter = await makeAdapter()
+      jsonId += 1
+      await adapter.provideSyncJson(jsonId, json)
+      return { adapter, id: jsonId }
+    },
+  )
+}
+
+export default async function runSQLiteBenchmarks() {
+  await queryEncoding()
+  await turboSync()
+  console.log('Benchmarks done')
+}
@@ -1,7 +1,7 @@
 // @flow
 /* eslint-disable import/no-import-module-exports */
 import type { RecordId } from '../../../Model'
-import type { TableName, TableSchema, AppSchema } from '../../../Schema'
+import type { TableName, ColumnName, TableSchema, AppSchema } from '../../../Schema'
 import type { RawRecord } from '../../../RawRecord'
 import type { BatchOperation } from '../../type'
 import { validateTable } from '../../common'
@@ -54,9 +54,22 @@ function encodeUpdateArgs(tableSchema: TableSchema, raw: RawRecord): SQLiteArg[]
   return args
 }
 
+function encodePartialUpdateArgs(raw: RawRecord, columns: ColumnName[]): SQLiteArg[] {
+  const len = columns.length
+
+  const args = Array(len + 1)
+  args[0] = raw.id
+  for (let i = 0; i < len; i++) {
+    args[i + 1] = (raw: any)[columns[i]]
+  }
+
+  return args
+}
+
 type GroupedBatchOperation =
   | ['create', TableName<any>, RawRecord[]]
   | ['update', TableName<any>, RawRecord[]]
+  | ['update', TableName<any>, RawRecord[], ColumnName[]]
   | ['markAsDeleted', TableName<any>, RecordId[]]
   | ['destroyPermanently', TableName<any>, RecordId[]]
 
@@ -64,21 +77,30 @@ const REMOVE_FROM_CACHE = -1
 const IGNORE_CACHE = 0
 const ADD_TO_CACHE = 1
 
-function groupOperations(operations: BatchOperation[]): GroupedBatchOperation[] {
+// NOTE: With `partialUpdates`, updates are only grouped together if they change the same columns
+function groupOperations(
+  operations: BatchOperation[],
+  partialUpdates: boolean = false,
+): GroupedBatchOperation[] {
   const grouppedOperations: GroupedBatchOperation[] = []
   let previousType: ?string = null
   let previousTable: ?TableName<any> = null
+  let previousColumnsKey: ?string = null
   let currentOperation: ?GroupedBatchOperation = null
   operations.forEach((operation) => {
     const [type, table, rawOrId] = operation
-    if (type !== previousType || table !== previousTable) {
+    // $FlowFixMe
+    const columns: ?(ColumnName[]) = partialUpdates && type === 'update' ? operation[3] : null
+    const columnsKey = columns ? columns.join(',') : null
+    if (type !== previousType || table !== previousTable || columnsKey !== previousColumnsKey) {
       if (currentOperation) {
         grouppedOperations.push(currentOperation)
       }
       previousType = type
       previousTable = table
+      previousColumnsKey = columnsKey
       // $FlowFixMe
-      currentOperation = [type, table, []]
+      currentOperation = columns ? [type, table, [], columns] : [type, table, []]
     }
 
     // $FlowFixMe
@@ -105,44 +127,69 @@ function withRecreatedIndices(
   return operations
 }
 
+function encodeOperation(
+  type: string,
+  table: TableName<any>,
+  recordsOrIds: any[],
+  schema: AppSchema,
+): NativeBridgeBatchOperation {
+  switch (type) {
+    case 'create':
+      return [
+        ADD_TO_CACHE,
+        table,
+        encodeInsertSql(schema.tables[table]),
+        recordsOrIds.map((raw) => encodeInsertArgs(schema.tables[table], (raw: any))),
+      ]
+    case 'update':
+      return [
+        IGNORE_CACHE,
+        null,
+        encodeUpdateSql(schema.tables[table]),
+        recordsOrIds.map((raw) => encodeUpdateArgs(schema.tables[table], (raw: any))),
+      ]
+    case 'markAsDeleted':
+      return [
+        REMOVE_FROM_CACHE,
+        table,
+        `update "${table}" set "_status" = 'deleted' where "id" == ?`,
+        recordsOrIds.map((id) => [(id: any)]),
+      ]
+    case 'destroyPermanently':
+      return [
+        REMOVE_FROM_CACHE,
+        table,
+        `delete from "${table}" where "id" == ?`,
+        recordsOrIds.map((id) => [(id: any)]),
+      ]
+    default:
+      throw new Error('unknown batch operation type')
+  }
+}
+
+// NOTE: With `partialUpdates`, updates that carry a list of changed columns are encoded as
+// `[0, table, columns, [[id, ...values]]]`, and SQL is generated natively (JSI only)
 export default function encodeBatch(
   operations: BatchOperation[],
   schema: AppSchema,
+  partialUpdates: boolean = false,
 ): NativeBridgeBatchOperation[] {
-  const nativeOperations = groupOperations(operations).map(([type, table, recordsOrIds]) => {
+  const nativeOperations: NativeBridgeBatchOperation[] = []
+  groupOperations(operations, partialUpdates).forEach(([type, table, recordsOrIds, columns]) => {
     validateTable(table, schema)
 
-    switch (type) {
-      case 'create':
-        return [
-          ADD_TO_CACHE,
-          table,
-          encodeInsertSql(schema.tables[table]),
-          recordsOrIds.map((raw) => encodeInsertArgs(schema.tables[table], (raw: any))),
-        ]
-      case 'update':
-        return [
+    if (type === 'update' && columns) {
+      // (no columns changed = nothing to write)
+      if (columns.length) {
+        nativeOperations.push([
           IGNORE_CACHE,
-          null,
-          encodeUpdateSql(schema.tables[table]),
-          recordsOrIds.map((raw) => encodeUpdateArgs(schema.tables[table], (raw: any))),
-        ]
-      case 'markAsDeleted':
-        return [
-          REMOVE_FROM_CACHE,
           table,
-          `update "${table}" set "_status" = 'deleted' where "id" == ?`,
-          recordsOrIds.map((id) => [(id: any)]),
-        ]
-      case 'destroyPermanently':
-        return [
-          REMOVE_FROM_CACHE,
-          table,
-          `delete from "${table}" where "id" == ?`,
-          recordsOrIds.map((id) => [(id: any)]),
-        ]
-      default:
-        throw new Error('unknown batch operation type')
+          columns,
+          recordsOrIds.map((raw) => encodePartialUpdateArgs((raw: any), columns)),
+        ])
+      }
+    } else {
+      nativeOperations.push(encodeOperation(type, table, recordsOrIds, schema))
     }
   })
 
@@ -159,5 +206,6 @@ if (process.env.NODE_ENV === 'test') {
   module['exports'].encodeInsertArgs = encodeInsertArgs
   module['exports'].encodeUpdateSql = encodeUpdateSql
   module['exports'].encodeUpdateArgs = encodeUpdateArgs
+  module['exports'].encodePartialUpdateArgs = encodePartialUpdateArgs
   module['exports'].groupOperations = groupOperations
 }
@@ -124,6 +124,20 @@ describe('groupOperations', () => {
       ['update', 't1', [31, 32]],
     ])
   })
+  it(`can group partial updates by changed columns`, () => {
+    const operations = [
+      ['update', 't1', 31, ['a']],
+      ['update', 't1', 32, ['a']],
+      ['update', 't1', 33, ['a', 'b']],
+      ['update', 't1', 34, ['a']],
+    ]
+    expect(groupOperations(operations)).toEqual([['update', 't1', [31, 32, 33, 34]]])
+    expect(groupOperations(operations, true)).toEqual([
+      ['update', 't1', [31, 32], ['a']],
+      ['update', 't1', [33], ['a', 'b']],
+      ['update', 't1', [34], ['a']],
+    ])
+  })
 })
 
 describe('encodeBatch', () => {
@@ -156,6 +170,36 @@ describe('encodeBatch', () => {
       [-1, 'tasks', `delete from "tasks" where "id" == ?`, [['bar'], ['baz']]],
     ])
   })
+  it(`can encode partial updates`, () => {
+    const t1 = sanitize({ id: 't1', order: 5, is_followed: true })
+    const t2 = sanitize({ id: 't2', order: 6 })
+    const t3 = sanitize({ id: 't3' })
+    const operations = [
+      ['update', 'tasks', t1, ['order', 'is_followed']],
+      ['update', 'tasks', t2, ['order', 'is_followed']],
+      ['update', 'tasks', t3, []],
+    ]
+    expect(encodeBatch(operations, testSchema, true)).toEqual([
+      [
+        0,
+        'tasks',
+        ['order', 'is_followed'],
+        [
+          ['t1', 5, true],
+          ['t2', 6, false],
+        ],
+      ],
+    ])
+    // partial updates are opt-in
+    expect(encodeBatch(operations, testSchema)).toEqual([
+      [
+        0,
+        null,
+        encodeUpdateSql(tasks),
+        [t1, t2, t3].map((raw) => encodeUpdateArgs(tasks, raw)),
+      ],
+    ])
+  })
   it(`can recreate indices for large batches`, () => {
     expect(encodeBatch(Array(1000).fill(['markAsDeleted', 'tasks', 'foo']), testSchema)).toEqual([
       [0, null, 'drop index if exists "tasks_author_id"', [[]]],
@@ -1,5 +1,5 @@
 import type { ConnectionTag } from '../../utils/common'
-import type { ResultCallback } from '../../utils/fp/Result'
+import type { Result, ResultCallback } from '../../utils/fp/Result'
 
 import type { RecordId } from '../../Model'
 import type { SerializedQuery } from '../../Query'
@@ -11,6 +11,13 @@ import type {
   CachedFindResult,
   BatchOperation,
   UnsafeExecuteOperations,
+  UnsafeExecuteChanges,
+  QueryObserverChanges,
+  QueryCursor,
+  MultiQueryOperation,
+  TurboSyncProgressCallback,
+  MarkAsSyncedOperation,
+  MarkAsSyncedResult,
 } from '../type'
 import type {
   DispatcherType,
@@ -43,6 +50,16 @@ export default class SQLiteAdapter implements DatabaseAdapter {
 
   _dispatcher: SqliteDispatcher
 
+  _partialUpdates: boolean
+
+  _nativeQueryObservation: boolean
+
+  _nativeQueryEncoding: boolean
+
+  _singleCallQueries: boolean
+
+  _observedQueryTables: Map<number, TableName<any>>
+
   _initPromise: Promise<void>
 
   constructor(options: SQLiteAdapterOptions)
@@ -61,12 +78,41 @@ export default class SQLiteAdapter implements DatabaseAdapter {
 
   find(table: TableName<any>, id: RecordId, callback: ResultCallback<CachedFindResult>): void
 
+  findMany(
+    table: TableName<any>,
+    ids: RecordId[],
+    callback: ResultCallback<CachedFindResult[]>,
+  ): void
+
+  _encodeQuery(
+    query: SerializedQuery,
+    countMode: boolean,
+    callback: ResultCallback<any>,
+    onEncoded: (encoded: [SQL, SQLiteArg[]]) => void,
+  ): void
+
   query(query: SerializedQuery, callback: ResultCallback<CachedQueryResult>): void
 
   queryIds(query: SerializedQuery, callback: ResultCallback<RecordId[]>): void
 
+  observeQuery(
+    query: SerializedQuery,
+    callback: ResultCallback<[number, CachedQueryResult] | null>,
+  ): void
+
+  fetchQueryObserverChanges(
+    observerId: number,
+    callback: ResultCallback<QueryObserverChanges | null>,
+  ): void
+
+  unobserveQuery(observerId: number, callback: ResultCallback<void>): void
+
   unsafeQueryRaw(query: SerializedQuery, callback: ResultCallback<any[]>): void
 
+  queryCursor(query: SerializedQuery, callback: ResultCallback<QueryCursor>): void
+
+  multiQuery(operations: MultiQueryOperation[], callback: ResultCallback<Result<any>[]>): void
+
   count(query: SerializedQuery, callback: ResultCallback<number>): void
 
   batch(operations: BatchOperation[], callback: ResultCallback<void>): void
@@ -79,13 +125,38 @@ export default class SQLiteAdapter implements DatabaseAdapter {
     callback: ResultCallback<void>,
   ): void
 
-  unsafeLoadFromSync(jsonId: number, callback: ResultCallback<any>): void
+  unsafeLoadFromSync(
+    jsonId: number,
+    onProgress: TurboSyncProgressCallback | null | undefined,
+    callback: ResultCallback<any>,
+  ): void
+
+  unsafeLoadFromSyncFile(
+    path: string,
+    onProgress: TurboSyncProgressCallback | null | undefined,
+    callback: ResultCallback<any>,
+  ): void
+
+  unsafeLoadIncrementalFromSync(jsonId: number, callback: ResultCallback<any>): void
+
+  fetchLocalChangesJSON(
+    tables: TableName<any>[],
+    callback: ResultCallback<string | null>,
+  ): void
+
+  markAsSynced(
+    operations: MarkAsSyncedOperation[],
+    callback: ResultCallback<MarkAsSyncedResult>,
+  ): void
 
   provideSyncJson(id: number, syncPullResultJson: string, callback: ResultCallback<void>): void
 
   unsafeResetDatabase(callback: ResultCallback<void>): void
 
-  unsafeExecute(operations: UnsafeExecuteOperations, callback: ResultCallback<void>): void
+  unsafeExecute(
+    operations: UnsafeExecuteOperations,
+    callback: ResultCallback<UnsafeExecuteChanges | null>,
+  ): void
 
   getLocal(key: string, callback: ResultCallback<string | undefined>): void
 
@@ -2,12 +2,12 @@
 /* eslint-disable global-require */
 
 import { connectionTag, type ConnectionTag, logger, invariant } from '../../utils/common'
-import { type ResultCallback, mapValue, toPromise } from '../../utils/fp/Result'
+import { type Result, type ResultCallback, mapValue, toPromise } from '../../utils/fp/Result'
 import { mapObj } from '../../utils/fp'
 
 import type { RecordId } from '../../Model'
 import type { SerializedQuery } from '../../Query'
-import type { TableName, AppSchema, SchemaVersion } from '../../Schema'
+import type { TableName, TableSchema, AppSchema, SchemaVersion } from '../../Schema'
 import type { SchemaMigrations, MigrationStep } from '../../Schema/migrations'
 import type {
   DatabaseAdapter,
@@ -15,10 +15,18 @@ import type {
   CachedFindResult,
   BatchOperation,
   UnsafeExecuteOperations,
+  UnsafeExecuteChanges,
+  QueryObserverChanges,
+  QueryCursor,
+  MultiQueryOperation,
+  TurboSyncProgressCallback,
+  MarkAsSyncedOperation,
+  MarkAsSyncedResult,
 } from '../type'
 import {
   sanitizeFindResult,
   sanitizeQueryResult,
+  findManyUsingFind,
   devSetupCallback,
   validateAdapter,
   validateTable,
@@ -39,6 +47,31 @@ import { makeDispatcher, getDispatcherType } from './makeDispatcher'
 
 export type { SQL, SQLiteArg, SQLiteQuery }
 
+// Wraps a cursor returned by native (JSI) queryCursor
+const makeQueryCursor = (nativeCursor: any, tableSchema: TableSchema): QueryCursor => {
+  const callCursor = (work: () => any, callback: ResultCallback<any>) => {
+    try {
+      const result = work()
+      // On Android, errors are returned, not thrown - see DatabaseBridge.cpp
+      if (result instanceof Error) {
+        throw result
+      }
+      callback({ value: result })
+    } catch (error) {
+      callback({ error })
+    }
+  }
+  return {
+    next: (count, callback) =>
+      callCursor(
+        () => nativeCursor.next(count),
+        (result) =>
+          callback(mapValue((rawRecords) => sanitizeQueryResult(rawRecords, tableSchema), result)),
+      ),
+    close: (callback) => callCursor(() => nativeCursor.close(), callback),
+  }
+}
+
 if (process.env.NODE_ENV !== 'production') {
   require('./devtools')
 }
@@ -62,6 +95,17 @@ export default class SQLiteAdapter implements DatabaseAdapter {
 
   _dispatcher: SqliteDispatcher
 
+  _partialUpdates: boolean
+
+  _nativeQueryObservation: boolean
+
+  _nativeQueryEncoding: boolean
+
+  _singleCallQueries: boolean
+
+  // observer ID -> table of observed query (needed to sanitize its results)
+  _observedQueryTables: Map<number, TableName<any>> = new Map()
+
   _initPromise: Promise<void>
 
   constructor(options: SQLiteAdapterOptions): void {
@@ -73,17 +117,36 @@ export default class SQLiteAdapter implements DatabaseAdapter {
       migrationEvents,
       usesExclusiveLocking = false,
       experimentalUnsafeNativeReuse = false,
+      experimentalColumnarQueries = false,
+      experimentalAsyncQueries = false,
+      experimentalAsyncReaderConnections = 2,
+      experimentalBinaryBatches = false,
+      experimentalAsyncBatches = false,
+      experimentalPartialUpdates = false,
+      experimentalNativeQueryObservation = false,
+      experimentalNativeQueryEncoding = false,
     } = options
     this.schema = schema
     this.migrations = migrations
     this._migrationEvents = migrationEvents
     this.dbName = this._getName(dbName)
     this._dispatcherType = getDispatcherType(options)
+    this._partialUpdates = experimentalPartialUpdates && this._dispatcherType === 'jsi'
+    this._nativeQueryObservation =
+      experimentalNativeQueryObservation && this._dispatcherType === 'jsi'
+    this._nativeQueryEncoding = experimentalNativeQueryEncoding && this._dispatcherType === 'jsi'
+    // NOTE: queryEncoded/countEncoded are synchronous, so async queries are encoded first instead
+    this._singleCallQueries = this._nativeQueryEncoding && !experimentalAsyncQueries
     // Hacky-ish way to create an object with NativeModule-like shape, but that can dispatch method
     // calls to async, synch NativeModule, or JSI implementation w/ type safety in rest of the impl
     this._dispatcher = makeDispatcher(this._dispatcherType, this._tag, this.dbName, {
       usesExclusiveLocking,
       experimentalUnsafeNativeReuse,
+      experimentalColumnarQueries,
+      experimentalAsyncQueries,
+      experimentalAsyncReaderConnections,
+      experimentalBinaryBatches,
+      experimentalAsyncBatches,
     })
 
     if (process.env.NODE_ENV !== 'production') {
@@ -219,54 +282,235 @@ export default class SQLiteAdapter implements DatabaseAdapter {
     )
   }
 
+  findMany(
+    table: TableName<any>,
+    ids: RecordId[],
+    callback: ResultCallback<CachedFindResult[]>,
+  ): void {
+    validateTable(table, this.schema)
+    if (this._dispatcherType !== 'jsi') {
+      findManyUsingFind(this, table, ids, callback)
+      return
+    }
+    const tableSchema = this.schema.tables[table]
+    this._dispatcher.call('findMany', [table, ids], (result) =>
+      callback(
+        mapValue(
+          (rawRecords) => rawRecords.map((rawRecord) => sanitizeFindResult(rawRecord, tableSchema)),
+          result,
+        ),
+      ),
+    )
+  }
+
+  // Encodes query into [sql, args] (natively, if `experimentalNativeQueryEncoding` is enabled), and
+  // passes it to `onEncoded`. If encoding fails, `callback` is called with the error
+  _encodeQuery(
+    query: SerializedQuery,
+    countMode: boolean,
+    callback: ResultCallback<any>,
+    onEncoded: ([SQL, SQLiteArg[]]) => void,
+  ): void {
+    if (!this._nativeQueryEncoding) {
+      onEncoded(encodeQuery(query, countMode))
+      return
+    }
+    this._dispatcher.call('encodeQuery', [query, countMode], (result) => {
+      if (result.error) {
+        callback(result)
+      } else {
+        onEncoded(result.value)
+      }
+    })
+  }
+
   query(query: SerializedQuery, callback: ResultCallback<CachedQueryResult>): void {
     validateTable(query.table, this.schema)
     const { table } = query
-    const [sql, args] = encodeQuery(query)
-    this._dispatcher.call('query', [table, sql, args], (result) =>
+    const sanitizingCallback = (result) =>
       callback(
         mapValue(
           (rawRecords) => sanitizeQueryResult(rawRecords, this.schema.tables[table]),
           result,
         ),
-      ),
+      )
+    if (this._singleCallQueries) {
+      this._dispatcher.call('queryEncoded', [query], sanitizingCallback)
+      return
+    }
+    this._encodeQuery(query, false, callback, ([sql, args]) =>
+      this._dispatcher.call('query', [table, sql, args], sanitizingCallback),
     )
   }
 
   queryIds(query: SerializedQuery, callback: ResultCallback<RecordId[]>): void {
     validateTable(query.table, this.schema)
-    this._dispatcher.call(
-      'queryIds',
+    this._encodeQuery(query, false, callback, (encoded) =>
       // $FlowFixMe
-      encodeQuery(query),
-      callback,
+      this._dispatcher.call('queryIds', encoded, callback),
     )
   }
 
+  observeQuery(
+    query: SerializedQuery,
+    callback: ResultCallback<?[number, CachedQueryResult]>,
+  ): void {
+    if (!this._nativeQueryObservation) {
+      callback({ value: null })
+      return
+    }
+    validateTable(query.table, this.schema)
+    const { table, description, associations } = query
+    const tables = [table].concat(associations.map(({ to }) => to))
+    // Results of queries of a single table, without sorting or limits, can be updated natively by
+    // checking which of the changed records match (conditions are compiled to a native matcher if
+    // possible). Other queries are re-run when tables change
+    const isIncremental =
+      !associations.length &&
+      !description.sortBy.length &&
+      !description.take &&
+      !description.skip &&
+      !description.sql
+    const conditions = isIncremental ? description.where : null
+    this._encodeQuery(query, false, callback, ([sql, args]) =>
+      this._dispatcher.call(
+        'observeQuery',
+        [table, sql, args, tables, isIncremental, conditions],
+        (result) =>
+          callback(
+            mapValue(
+              ([observerId, rawRecords]) => {
+                this._observedQueryTables.set(observerId, table)
+                return [observerId, sanitizeQueryResult(rawRecords, this.schema.tables[table])]
+              },
+              result,
+            ),
+          ),
+      ),
+    )
+  }
+
+  fetchQueryObserverChanges(
+    observerId: number,
+    callback: ResultCallback<?QueryObserverChanges>,
+  ): void {
+    const table = this._observedQueryTables.get(observerId)
+    if (!table) {
+      callback({ error: new Error(`Query observer ${observerId} does not exist`) })
+      return
+    }
+    const tableSchema = this.schema.tables[table]
+    this._dispatcher.call('fetchQueryObserverChanges', [observerId], (result) =>
+      callback(
+        mapValue((changes) => {
+          if (!changes) {
+            return null
+          } else if (changes.records) {
+            return { records: sanitizeQueryResult(changes.records, tableSchema) }
+          }
+          return {
+            added: sanitizeQueryResult(changes.added, tableSchema),
+            removed: changes.removed,
+          }
+        }, result),
+      ),
+    )
+  }
+
+  unobserveQuery(observerId: number, callback: ResultCallback<void>): void {
+    this._observedQueryTables.delete(observerId)
+    this._dispatcher.call('unobserveQuery', [observerId], callback)
+  }
+
   unsafeQueryRaw(query: SerializedQuery, callback: ResultCallback<any[]>): void {
     validateTable(query.table, this.schema)
-    this._dispatcher.call(
-      'unsafeQueryRaw',
+    this._encodeQuery(query, false, callback, (encoded) =>
       // $FlowFixMe
-      encodeQuery(query),
-      callback,
+      this._dispatcher.call('unsafeQueryRaw', encoded, callback),
+    )
+  }
+
+  queryCursor(query: SerializedQuery, callback: ResultCallback<QueryCursor>): void {
+    if (this._dispatcherType !== 'jsi') {
+      callback({ error: new Error('queryCursor unavailable. Use JSI mode to enable.') })
+      return
+    }
+    validateTable(query.table, this.schema)
+    const { table } = query
+    const tableSchema = this.schema.tables[table]
+    this._encodeQuery(query, false, callback, ([sql, args]) =>
+      this._dispatcher.call('queryCursor', [table, sql, args], (result) =>
+        callback(mapValue((nativeCursor) => makeQueryCursor(nativeCursor, tableSchema), result)),
+      ),
+    )
+  }
+
+  multiQuery(operations: MultiQueryOperation[], callback: ResultCallback<Result<any>[]>): void {
+    if (this._dispatcherType !== 'jsi') {
+      callback({ error: new Error('multiQuery unavailable. Use JSI mode to enable.') })
+      return
+    }
+    const { schema } = this
+    let nativeOperations
+    try {
+      // NOTE: Queries are always encoded in JS here, to pass all operations in a single native call
+      nativeOperations = operations.map((operation: any) => {
+        const [type] = operation
+        if (type === 'find') {
+          validateTable(operation[1], schema)
+          return operation
+        } else if (type === 'getLocal') {
+          return operation
+        }
+        const query: SerializedQuery = operation[1]
+        validateTable(query.table, schema)
+        const [sql, args] = encodeQuery(query, type === 'count')
+        return type === 'query' ? [type, query.table, sql, args] : [type, sql, args]
+      })
+    } catch (error) {
+      callback({ error })
+      return
+    }
+
+    this._dispatcher.call('multiQuery', [nativeOperations], (result) =>
+      callback(
+        mapValue(
+          (results) =>
+            results.map((value, i) => {
+              // Failed operations have errors returned, not thrown
+              if (value instanceof Error) {
+                return { error: value }
+              }
+              const [type, tableOrQuery]: any = operations[i]
+              if (type === 'find') {
+                return { value: sanitizeFindResult(value, schema.tables[tableOrQuery]) }
+              } else if (type === 'query') {
+                return { value: sanitizeQueryResult(value, schema.tables[tableOrQuery.table]) }
+              }
+              return { value }
+            }),
+          result,
+        ),
+      ),
     )
   }
 
   count(query: SerializedQuery, callback: ResultCallback<number>): void {
     validateTable(query.table, this.schema)
-    this._dispatcher.call(
-      'count',
+    if (this._singleCallQueries) {
+      this._dispatcher.call('countEncoded', [query], callback)
+      return
+    }
+    this._encodeQuery(query, true, callback, (encoded) =>
       // $FlowFixMe
-      encodeQuery(query, true),
-      callback,
+      this._dispatcher.call('count', encoded, callback),
     )
   }
 
   batch(operations: BatchOperation[], callback: ResultCallback<void>): void {
     this._dispatcher.call(
       'batch',
-      [require('./encodeBatch').default(operations, this.schema)],
+      [require('./encodeBatch').default(operations, this.schema, this._partialUpdates)],
       callback,
     )
   }
@@ -295,17 +539,44 @@ export default class SQLiteAdapter implements DatabaseAdapter {
     this._dispatcher.call('batch', [[operation]], callback)
   }
 
-  unsafeLoadFromSync(jsonId: number, callback: ResultCallback<any>): void {
+  unsafeLoadFromSync(
+    jsonId: number,
+    onProgress: ?TurboSyncProgressCallback,
+    callback: ResultCallback<any>,
+  ): void {
+    this._unsafeLoadFromSync('unsafeLoadFromSync', jsonId, onProgress, callback)
+  }
+
+  unsafeLoadFromSyncFile(
+    path: string,
+    onProgress: ?TurboSyncProgressCallback,
+    callback: ResultCallback<any>,
+  ): void {
+    this._unsafeLoadFromSync('unsafeLoadFromSyncFile', path, onProgress, callback)
+  }
+
+  _unsafeLoadFromSync(
+    methodName: 'unsafeLoadFromSync' | 'unsafeLoadFromSyncFile',
+    jsonIdOrPath: number | string,
+    onProgress: ?TurboSyncProgressCallback,
+    callback: ResultCallback<any>,
+  ): void {
     if (this._dispatcherType !== 'jsi') {
-      callback({ error: new Error('unsafeLoadFromSync unavailable. Use JSI mode to enable.') })
+      callback({ error: new Error(`${methodName} unavailable. Use JSI mode to enable.`) })
       return
     }
 
     const { encodeDropIndices, encodeCreateIndices } = require('./encodeSchema')
     const { schema } = this
     this._dispatcher.call(
-      'unsafeLoadFromSync',
-      [jsonId, schema, encodeDropIndices(schema), encodeCreateIndices(schema)],
+      methodName,
+      [
+        jsonIdOrPath,
+        schema,
+        encodeDropIndices(schema),
+        encodeCreateIndices(schema),
+        onProgress || null,
+      ],
       (result) =>
         callback(
           mapValue(
@@ -317,6 +588,49 @@ export default class SQLiteAdapter implements DatabaseAdapter {
     )
   }
 
+  unsafeLoadIncrementalFromSync(jsonId: number, callback: ResultCallback<any>): void {
+    if (this._dispatcherType !== 'jsi') {
+      callback({
+        error: new Error('unsafeLoadIncrementalFromSync unavailable. Use JSI mode to enable.'),
+      })
+      return
+    }
+
+    this._dispatcher.call('unsafeLoadIncrementalFromSync', [jsonId, this.schema], (result) =>
+      callback(
+        mapValue(
+          ({ residualValues, changes }) => ({
+            // { key: JSON.stringify(value) } -> { key: value }
+            residualValues: mapObj((values) => JSON.parse(values), residualValues),
+            changes,
+          }),
+          result,
+        ),
+      ),
+    )
+  }
+
+  fetchLocalChangesJSON(tables: TableName<any>[], callback: ResultCallback<?string>): void {
+    if (this._dispatcherType !== 'jsi') {
+      callback({ value: null })
+      return
+    }
+
+    this._dispatcher.call('fetchLocalChangesJSON', [this.schema, tables], callback)
+  }
+
+  markAsSynced(
+    operations: MarkAsSyncedOperation[],
+    callback: ResultCallback<MarkAsSyncedResult>,
+  ): void {
+    if (this._dispatcherType !== 'jsi') {
+      callback({ error: new Error('markAsSynced unavailable. Use JSI mode to enable.') })
+      return
+    }
+
+    this._dispatcher.call('markAsSynced', [this.schema, operations], callback)
+  }
+
   provideSyncJson(id: number, syncPullResultJson: string, callback: ResultCallback<void>): void {
     if (this._dispatcherType !== 'jsi') {
       callback({ error: new Error('provideSyncJson unavailable. Use JSI mode to enable.') })
@@ -339,7 +653,10 @@ export default class SQLiteAdapter implements DatabaseAdapter {
     )
   }
 
-  unsafeExecute(operations: UnsafeExecuteOperations, callback: ResultCallback<void>): void {
+  unsafeExecute(
+    operations: UnsafeExecuteOperations,
+    callback: ResultCallback<?UnsafeExecuteChanges>,
+  ): void {
     if (process.env.NODE_ENV !== 'production') {
       invariant(
         operations &&
@@ -349,12 +666,15 @@ export default class SQLiteAdapter implements DatabaseAdapter {
         "unsafeExecute expects an { sqls: [ [sql, [args..]], ... ] } or { sqlString: 'foo; bar' } object",
       )
     }
+    // NOTE: Only JSI tracks changed records (using sqlite's update hook)
+    const callbackWithChanges = (result) =>
+      callback(mapValue((changes) => (this._dispatcherType === 'jsi' ? changes : null), result))
     if (operations.sqls) {
       const queries: SQLiteQuery[] = (operations: any).sqls
       const batchOperations = queries.map(([sql, args]) => [IGNORE_CACHE, null, sql, [args]])
-      this._dispatcher.call('batch', [batchOperations], callback)
+      this._dispatcher.call('batch', [batchOperations], callbackWithChanges)
     } else if (operations.sqlString) {
-      this._dispatcher.call('unsafeExecuteMultiple', [operations.sqlString], callback)
+      this._dispatcher.call('unsafeExecuteMultiple', [operations.sqlString], callbackWithChanges)
     }
   }
 
@@ -0,0 +1,83 @@
+// @flow
+
+// Columnar query results are a single ArrayBuffer with this layout (see Database::queryColumnar):
+//   u32 rowCount, u32 columnCount, u32 blobLength, u32 numberCount, u32 stringCount, u32 (reserved)
+//   f64[numberCount] number values
+//   u32[stringCount] string starts, u32[stringCount] string lengths
+//     (in UTF-16 code units of decoded blob)
+//   u32[columns] column name starts, u32[columns] column name lengths
+//   u32[columns] index of column's first number, u32[columns] index of column's first string
+//   u8[rows] 1 if row is a cached record (only its id is filled in)
+//   u8[rows * columns] cell types - 0: null, 1: number, 2: string (index = column * rowCount + row)
+//   u8[blobLength] UTF-8 blob of all strings
+// where numbers and strings are stored column by column, only for cells of that type, and the first
+// column is `id`
+// NOTE: The blob is decoded with a single TextDecoder call, and then sliced. Columnar queries
+// aren't used if TextDecoder is unavailable (see makeDispatcher), as decoding in JS is much slower
+
+const NUMBER = 1
+const STRING = 2
+
+let textDecoder: ?TextDecoder = null
+
+export default function decodeColumnarQueryResult(buffer: ArrayBuffer): any[] {
+  const [rowCount, columnCount, blobLength, numberCount, stringCount] = new Uint32Array(
+    buffer,
+    0,
+    5,
+  )
+
+  const numbersOffset = 24
+  const stringStartsOffset = numbersOffset + numberCount * 8
+  const stringLengthsOffset = stringStartsOffset + stringCount * 4
+  const nameStartsOffset = stringLengthsOffset + stringCount * 4
+  const nameLengthsOffset = nameStartsOffset + columnCount * 4
+  const firstNumbersOffset = nameLengthsOffset + columnCount * 4
+  const firstStringsOffset = firstNumbersOffset + columnCount * 4
+  const cachedOffset = firstStringsOffset + columnCount * 4
+  const typesOffset = cachedOffset + rowCount
+  const blobOffset = typesOffset + rowCount * columnCount
+
+  const numbers = new Float64Array(buffer, numbersOffset, numberCount)
+  const stringStarts = new Uint32Array(buffer, stringStartsOffset, stringCount)
+  const stringLengths = new Uint32Array(buffer, stringLengthsOffset, stringCount)
+  const nameStarts = new Uint32Array(buffer, nameStartsOffset, columnCount)
+  const nameLengths = new Uint32Array(buffer, nameLengthsOffset, columnCount)
+  // NOTE: Copied, because these are used as cursors - index of column's next number/string
+  const nextNumbers = Uint32Array.from(new Uint32Array(buffer, firstNumbersOffset, columnCount))
+  const nextStrings = Uint32Array.from(new Uint32Array(buffer, firstStringsOffset, columnCount))
+  const cached = new Uint8Array(buffer, cachedOffset, rowCount)
+  const types = new Uint8Array(buffer, typesOffset, rowCount * columnCount)
+  if (!textDecoder) {
+    textDecoder = new TextDecoder()
+  }
+  const strings = textDecoder.decode(new Uint8Array(buffer, blobOffset, blobLength))
+
+  const columnNames = new Array(columnCount)
+  for (let j = 0; j < columnCount; j++) {
+    columnNames[j] = strings.substr(nameStarts[j], nameLengths[j])
+  }
+
+  const rawRecords = new Array(rowCount)
+  for (let i = 0; i < rowCount; i++) {
+    if (cached[i]) {
+      const string = nextStrings[0]++
+      rawRecords[i] = strings.substr(stringStarts[string], stringLengths[string])
+    } else {
+      const rawRecord = ({}: { [any]: any })
+      for (let j = 0; j < columnCount; j++) {
+        const type = types[j * rowCount + i]
+        if (type === NUMBER) {
+          rawRecord[columnNames[j]] = numbers[nextNumbers[j]++]
+        } else if (type === STRING) {
+          const string = nextStrings[j]++
+          rawRecord[columnNames[j]] = strings.substr(stringStarts[string], stringLengths[string])
+        } else {
+          rawRecord[columnNames[j]] = null
+        }
+      }
+      rawRecords[i] = rawRecord
+    }
+  }
+  return rawRecords
+}
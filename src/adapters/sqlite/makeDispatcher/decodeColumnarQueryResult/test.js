@@ -0,0 +1,89 @@
+import decodeColumnarQueryResult from './index'
+
+// Mirrors Database::queryColumnar, for testing only
+function encode(columnNames, rows) {
+  const encoder = new TextEncoder()
+  const rowCount = rows.length
+  const columnCount = rowCount ? columnNames.length : 0
+
+  let strings = ''
+  const addString = (string) => {
+    const start = strings.length
+    strings += string
+    return [start, string.length]
+  }
+
+  const nameRanges = columnNames.slice(0, columnCount).map(addString)
+  const columns = nameRanges.map(() => ({ numbers: [], stringRanges: [] }))
+  const types = new Uint8Array(rowCount * columnCount)
+  const cached = new Uint8Array(rowCount)
+
+  rows.forEach((row, i) => {
+    const isCached = typeof row === 'string'
+    cached[i] = isCached ? 1 : 0
+    const values = isCached ? [row] : row
+    values.forEach((value, j) => {
+      const cell = j * rowCount + i
+      if (typeof value === 'number') {
+        columns[j].numbers.push(value)
+        types[cell] = 1
+      } else if (typeof value === 'string') {
+        columns[j].stringRanges.push(addString(value))
+        types[cell] = 2
+      }
+    })
+  })
+
+  const firstNumbers = []
+  const firstStrings = []
+  columns.forEach((column, j) => {
+    firstNumbers[j] = j ? firstNumbers[j - 1] + columns[j - 1].numbers.length : 0
+    firstStrings[j] = j ? firstStrings[j - 1] + columns[j - 1].stringRanges.length : 0
+  })
+  const numbers = new Float64Array(columns.flatMap((column) => column.numbers))
+  const stringRanges = columns.flatMap((column) => column.stringRanges)
+
+  const blob = encoder.encode(strings)
+  const parts = [
+    new Uint32Array([rowCount, columnCount, blob.length, numbers.length, stringRanges.length, 0]),
+    numbers,
+    new Uint32Array(stringRanges.map(([start]) => start)),
+    new Uint32Array(stringRanges.map(([, length]) => length)),
+    new Uint32Array(nameRanges.map(([start]) => start)),
+    new Uint32Array(nameRanges.map(([, length]) => length)),
+    new Uint32Array(firstNumbers),
+    new Uint32Array(firstStrings),
+    cached,
+    types,
+    blob,
+  ]
+  const byteLength = parts.reduce((acc, part) => acc + part.byteLength, 0)
+  const result = new Uint8Array(byteLength)
+  let offset = 0
+  parts.forEach((part) => {
+    result.set(new Uint8Array(part.buffer, part.byteOffset, part.byteLength), offset)
+    offset += part.byteLength
+  })
+  return result.buffer
+}
+
+describe('decodeColumnarQueryResult', () => {
+  it(`decodes empty query result`, () => {
+    expect(decodeColumnarQueryResult(encode([], []))).toEqual([])
+  })
+  it(`decodes query result`, () => {
+    expect(
+      decodeColumnarQueryResult(
+        encode(
+          ['id', 'a', 'b', 'c'],
+          [['foo', 1, 'bar', null], 'baz', ['zażółć', 2.5, '😀 gęślą', null], ['x', 0, '', '🎉']],
+        ),
+      ),
+    ).toEqual([
+      { id: 'foo', a: 1, b: 'bar', c: null },
+      'baz',
+      { id: 'zażółć', a: 2.5, b: '😀 gęślą', c: null },
+      { id: 'x', a: 0, b: '', c: '🎉' },
+    ])
+  })
+})
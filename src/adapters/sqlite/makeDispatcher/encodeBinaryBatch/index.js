@@ -0,0 +1,184 @@
+// @flow
+
+import type { NativeBridgeBatchOperation } from '../../type'
+
+// Binary batches are a single ArrayBuffer with this layout (see Database::batchBinary):
+//   u32 stringCount, u32 operationCount
+//   for each string (deduplicated table names, SQL, and column names): u32 byteLength, UTF-8 bytes
+//   for each operation:
+//     i8 cacheBehavior, u32 table string index (0xffffffff if none), u32 SQL string index,
+//     (or 0xffffffff for partial updates, followed by u32 columnCount, u32[columnCount] column string indices)
+//     u32 argsBatchCount, and for each args batch:
+//       u32 argCount, and for each arg: u8 type, followed by:
+//         0 (null), 3 (true), 4 (false): nothing
+//         1 (number): f64
+//         2 (string): u32 byteLength, UTF-8 bytes
+// All values are little-endian and unaligned. The buffer may have unused bytes at the end
+
+const NULL = 0
+const NUMBER = 1
+const STRING = 2
+const TRUE = 3
+const FALSE = 4
+
+const NO_TABLE = 0xffffffff
+const PARTIAL_UPDATE = 0xffffffff
+
+const textEncoder = typeof TextEncoder !== 'undefined' ? new TextEncoder() : null
+
+function encodeUtf8Into(string: string, bytes: Uint8Array, start: number): number {
+  let offset = start
+  for (let i = 0, len = string.length; i < len; i++) {
+    let codePoint = string.charCodeAt(i)
+    if (codePoint >= 0xd800 && codePoint <= 0xdfff) {
+      const next = i + 1 < len ? string.charCodeAt(i + 1) : 0
+      if (codePoint <= 0xdbff && next >= 0xdc00 && next <= 0xdfff) {
+        codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (next - 0xdc00)
+        i += 1
+      } else {
+        // lone surrogate
+        codePoint = 0xfffd
+      }
+    }
+
+    if (codePoint < 0x80) {
+      bytes[offset++] = codePoint
+    } else if (codePoint < 0x800) {
+      bytes[offset++] = 0xc0 | (codePoint >> 6)
+      bytes[offset++] = 0x80 | (codePoint & 0x3f)
+    } else if (codePoint < 0x10000) {
+      bytes[offset++] = 0xe0 | (codePoint >> 12)
+      bytes[offset++] = 0x80 | ((codePoint >> 6) & 0x3f)
+      bytes[offset++] = 0x80 | (codePoint & 0x3f)
+    } else {
+      bytes[offset++] = 0xf0 | (codePoint >> 18)
+      bytes[offset++] = 0x80 | ((codePoint >> 12) & 0x3f)
+      bytes[offset++] = 0x80 | ((codePoint >> 6) & 0x3f)
+      bytes[offset++] = 0x80 | (codePoint & 0x3f)
+    }
+  }
+  return offset - start
+}
+
+class BinaryWriter {
+  bytes: Uint8Array
+
+  view: DataView
+
+  offset: number = 0
+
+  constructor(capacity: number): void {
+    this.bytes = new Uint8Array(capacity)
+    this.view = new DataView(this.bytes.buffer)
+  }
+
+  reserve(count: number): void {
+    const needed = this.offset + count
+    if (needed <= this.bytes.length) {
+      return
+    }
+    let capacity = this.bytes.length * 2
+    while (capacity < needed) {
+      capacity *= 2
+    }
+    const bytes = new Uint8Array(capacity)
+    bytes.set(this.bytes)
+    this.bytes = bytes
+    this.view = new DataView(bytes.buffer)
+  }
+
+  u8(value: number): void {
+    this.reserve(1)
+    this.bytes[this.offset] = value
+    this.offset += 1
+  }
+
+  u32(value: number): void {
+    this.reserve(4)
+    this.view.setUint32(this.offset, value, true)
+    this.offset += 4
+  }
+
+  f64(value: number): void {
+    this.reserve(8)
+    this.view.setFloat64(this.offset, value, true)
+    this.offset += 8
+  }
+
+  string(value: string): void {
+    // NOTE: UTF-8 takes at most 3 bytes per UTF-16 code unit
+    this.reserve(4 + value.length * 3)
+    const start = this.offset + 4
+    let length
+    if (textEncoder) {
+      // $FlowFixMe
+      length = textEncoder.encodeInto(value, this.bytes.subarray(start)).written
+    } else {
+      length = encodeUtf8Into(value, this.bytes, start)
+    }
+    this.view.setUint32(this.offset, length, true)
+    this.offset = start + length
+  }
+}
+
+export default function encodeBinaryBatch(operations: NativeBridgeBatchOperation[]): ArrayBuffer {
+  const strings: string[] = []
+  const stringIndices: Map<string, number> = new Map()
+  const stringIndex = (string: string): number => {
+    let index = stringIndices.get(string)
+    if (index === undefined) {
+      index = strings.length
+      strings.push(string)
+      stringIndices.set(string, index)
+    }
+    return index
+  }
+
+  const tableIndices = operations.map(([, table]) => (table ? stringIndex(table) : NO_TABLE))
+  const sqlIndices = operations.map(([, , sql]) =>
+    Array.isArray(sql) ? sql.map(stringIndex) : stringIndex(sql),
+  )
+
+  const writer = new BinaryWriter(1024)
+  writer.u32(strings.length)
+  writer.u32(operations.length)
+  strings.forEach((string) => writer.string(string))
+
+  operations.forEach(([cacheBehavior, , , argsBatches], i) => {
+    writer.u8(cacheBehavior & 0xff)
+    writer.u32(tableIndices[i])
+    const sqlIndex = sqlIndices[i]
+    if (Array.isArray(sqlIndex)) {
+      writer.u32(PARTIAL_UPDATE)
+      writer.u32(sqlIndex.length)
+      sqlIndex.forEach((columnIndex) => writer.u32(columnIndex))
+    } else {
+      writer.u32(sqlIndex)
+    }
+    writer.u32(argsBatches.length)
+    for (let j = 0; j < argsBatches.length; j++) {
+      const args = argsBatches[j]
+      writer.u32(args.length)
+      for (let k = 0; k < args.length; k++) {
+        const arg = args[k]
+        if (typeof arg === 'string') {
+          writer.u8(STRING)
+          writer.string(arg)
+        } else if (typeof arg === 'number') {
+          writer.u8(NUMBER)
+          writer.f64(arg)
+        } else if (arg === true) {
+          writer.u8(TRUE)
+        } else if (arg === false) {
+          writer.u8(FALSE)
+        } else if (arg === null || arg === undefined) {
+          writer.u8(NULL)
+        } else {
+          throw new Error(`Invalid argument type for query (${typeof arg})`)
+        }
+      }
+    }
+  })
+
+  return writer.bytes.buffer
+}
@@ -0,0 +1,109 @@
+import encodeBinaryBatch from './index'
+
+// Mirrors Database::batchBinary, for testing only
+function decode(buffer) {
+  const decoder = new TextDecoder()
+  const view = new DataView(buffer)
+  let offset = 0
+  const u8 = () => {
+    offset += 1
+    return view.getInt8(offset - 1)
+  }
+  const u32 = () => {
+    offset += 4
+    return view.getUint32(offset - 4, true)
+  }
+  const string = () => {
+    const length = u32()
+    offset += length
+    return decoder.decode(new Uint8Array(buffer, offset - length, length))
+  }
+
+  const strings = []
+  const stringCount = u32()
+  const operationCount = u32()
+  for (let i = 0; i < stringCount; i++) {
+    strings.push(string())
+  }
+
+  const operations = []
+  for (let i = 0; i < operationCount; i++) {
+    const cacheBehavior = u8()
+    const tableIndex = u32()
+    const sqlIndex = u32()
+    let sql
+    if (sqlIndex === 0xffffffff) {
+      sql = []
+      const columnCount = u32()
+      for (let j = 0; j < columnCount; j++) {
+        sql.push(strings[u32()])
+      }
+    } else {
+      sql = strings[sqlIndex]
+    }
+    const argsBatches = []
+    const argsBatchCount = u32()
+    for (let j = 0; j < argsBatchCount; j++) {
+      const args = []
+      const argCount = u32()
+      for (let k = 0; k < argCount; k++) {
+        const type = u8()
+        if (type === 1) {
+          offset += 8
+          args.push(view.getFloat64(offset - 8, true))
+        } else if (type === 2) {
+          args.push(string())
+        } else {
+          args.push([null, null, null, true, false][type])
+        }
+      }
+      argsBatches.push(args)
+    }
+    operations.push([
+      cacheBehavior,
+      tableIndex === 0xffffffff ? null : strings[tableIndex],
+      sql,
+      argsBatches,
+    ])
+  }
+  return { strings, operations }
+}
+
+describe('encodeBinaryBatch', () => {
+  it(`encodes empty batch`, () => {
+    expect(decode(encodeBinaryBatch([]))).toEqual({ strings: [], operations: [] })
+  })
+  it(`encodes batch`, () => {
+    const operations = [
+      [1, 'tasks', 'insert into "tasks" ("id", "a", "b") values (?, ?, ?)', [['t1', 1.5, true]]],
+      [0, null, 'update "tasks" set "a" = ? where "id" is ?', [[null, 't1'], [false, 't2']]],
+      [-1, 'tasks', 'delete from "tasks" where "id" == ?', [['zażółć 👍'], ['']]],
+      [1, 'tasks', 'insert into "tasks" ("id", "a", "b") values (?, ?, ?)', [['t3', -2, 'x']]],
+    ]
+    const { strings, operations: decoded } = decode(encodeBinaryBatch(operations))
+    expect(decoded).toEqual(operations)
+    // table names and SQL are deduplicated
+    expect(strings.length).toBe(4)
+  })
+  it(`encodes partial updates`, () => {
+    const operations = [
+      [0, 'tasks', ['_changed', 'name'], [['t1', 'name', 'foo']]],
+      [0, 'tasks', ['name'], [['t2', 'bar'], ['t3', 'baz']]],
+    ]
+    const { strings, operations: decoded } = decode(encodeBinaryBatch(operations))
+    expect(decoded).toEqual(operations)
+    expect(strings).toEqual(['tasks', '_changed', 'name'])
+  })
+  it(`encodes large batches`, () => {
+    const argsBatches = Array(5000)
+      .fill()
+      .map((_, i) => [`id${i}`, i, `${'x'.repeat(i % 100)}`, i % 2 === 0])
+    const operations = [[1, 'tasks', 'insert into "tasks" values (?, ?, ?, ?)', argsBatches]]
+    expect(decode(encodeBinaryBatch(operations)).operations).toEqual(operations)
+  })
+  it(`throws on invalid arguments`, () => {
+    expect(() => encodeBinaryBatch([[0, null, 'select ?', [[{}]]]])).toThrow(
+      'Invalid argument type',
+    )
+  })
+})
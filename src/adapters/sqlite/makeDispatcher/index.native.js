@@ -57,12 +57,37 @@ class SqliteNativeModulesDispatcher implements SqliteDispatcher {
   }
 }
 
+const asyncQueryMethods = ['query', 'queryIds', 'unsafeQueryRaw', 'count']
+
 class SqliteJsiDispatcher implements SqliteDispatcher {
   _db: any
+  _columnarQueries: boolean
+  _asyncQueries: boolean
+  _binaryBatches: boolean
+  _asyncBatches: boolean
   _unsafeErrorListener: (Error) => void // debug hook for NT use
 
-  constructor(dbName: string, { usesExclusiveLocking }: SqliteDispatcherOptions): void {
-    this._db = global.nativeWatermelonCreateAdapter(dbName, usesExclusiveLocking)
+  constructor(
+    dbName: string,
+    {
+      usesExclusiveLocking,
+      experimentalColumnarQueries,
+      experimentalAsyncQueries,
+      experimentalAsyncReaderConnections,
+      experimentalBinaryBatches,
+      experimentalAsyncBatches,
+    }: SqliteDispatcherOptions,
+  ): void {
+    this._db = global.nativeWatermelonCreateAdapter(
+      dbName,
+      usesExclusiveLocking,
+      experimentalAsyncReaderConnections,
+    )
+    // NOTE: Without TextDecoder (e.g. older Hermes), decoding columnar results is too slow to be useful
+    this._columnarQueries = experimentalColumnarQueries && typeof TextDecoder !== 'undefined'
+    this._asyncQueries = experimentalAsyncQueries && Platform.OS !== 'windows'
+    this._binaryBatches = experimentalBinaryBatches && Platform.OS !== 'windows'
+    this._asyncBatches = experimentalAsyncBatches && Platform.OS !== 'windows'
     this._unsafeErrorListener = () => {}
   }
 
@@ -70,16 +95,28 @@ class SqliteJsiDispatcher implements SqliteDispatcher {
     let methodName: string = name
     let args = _args
 
-    if (methodName === 'query' && !global.HermesInternal) {
+    if (this._asyncQueries && asyncQueryMethods.includes(methodName)) {
+      methodName = `${methodName}Async`
+    } else if (methodName === 'query' && this._columnarQueries) {
+      methodName = 'queryColumnar'
+    } else if (methodName === 'query' && !global.HermesInternal) {
       // NOTE: compressing results of a query into a compact array makes querying 15-30% faster on JSC
       // but actually 9% slower on Hermes (presumably because Hermes has faster C++ JSI and slower JS execution)
       methodName = 'queryAsArray'
+    } else if (methodName === 'batch' && this._asyncBatches) {
+      methodName = 'batchJSONAsync'
+      args = [JSON.stringify(args[0])]
+    } else if (methodName === 'batch' && this._binaryBatches) {
+      methodName = 'batchBinary'
+      args = [require('./encodeBinaryBatch').default(args[0])]
     } else if (methodName === 'batch') {
       methodName = 'batchJSON'
       args = [JSON.stringify(args[0])]
     } else if (
       Platform.OS === 'windows' &&
-      (methodName === 'provideSyncJson' || methodName === 'unsafeLoadFromSync')
+      (methodName === 'provideSyncJson' ||
+        methodName === 'unsafeLoadFromSync' ||
+        methodName === 'unsafeLoadIncrementalFromSync')
     ) {
       callback({ error: new Error(`${methodName} unavailable on Windows. Please contribute.`) })
     } else if (methodName === 'provideSyncJson') {
@@ -100,9 +137,19 @@ class SqliteJsiDispatcher implements SqliteDispatcher {
       // On Android, errors are returned, not thrown - see DatabaseBridge.cpp
       if (result instanceof Error) {
         throw result
+      } else if (result instanceof Promise) {
+        result.then(
+          (value) => callback({ value }),
+          (error) => {
+            this._unsafeErrorListener(error)
+            callback({ error })
+          },
+        )
       } else {
         if (methodName === 'queryAsArray') {
           result = require('./decodeQueryResult').default(result)
+        } else if (methodName === 'queryColumnar') {
+          result = require('./decodeColumnarQueryResult').default(result)
         }
         callback({ value: result })
       }
@@ -28,6 +28,37 @@ export type SQLiteAdapterOptions = $Exact<{
   // Sets exclusive file locking mode in sqlite. Use this ONLY if you need to - e.g. seems to fix
   // mysterious "database is malformed" issues on JSI+Android when using Headless JS
   usesExclusiveLocking?: boolean
+  // (JSI only) If `true`, query results are passed from native code as a single binary buffer instead of
+  // JS objects. Can be faster for large results of numeric-heavy tables
+  experimentalColumnarQueries?: boolean
+  // (JSI only, not on Windows) If `true`, queries are executed on a separate read-only connection on a
+  // native background thread, so that slow queries don't block the JS thread.
+  // NOTE: Results may reflect changes that were made after the query was issued, and in-memory
+  // databases, or databases with `usesExclusiveLocking` will still be queried synchronously
+  experimentalAsyncQueries?: boolean
+  // (JSI only) Number of read-only connections (and background threads) used for
+  // `experimentalAsyncQueries`. More connections allow more queries to run in parallel, at the cost of
+  // memory (each connection has its own page and statement cache). Defaults to 2
+  experimentalAsyncReaderConnections?: number
+  // (JSI only, not on Windows) If `true`, batches are passed to native code as a compact binary buffer
+  // instead of a JSON string. Can be faster for large batches (e.g. big sync writes)
+  experimentalBinaryBatches?: boolean
+  // (JSI only, not on Windows) If `true`, batches are written on a separate connection on a native
+  // background thread, so that the JS thread doesn't wait for commits. Batches made in quick succession
+  // are committed together in a single transaction (but a failing batch doesn't affect others).
+  // NOTE: In-memory databases, or databases with `usesExclusiveLocking` will still be written to synchronously
+  experimentalAsyncBatches?: boolean
+  // (JSI only) If `true`, updated records only write columns that changed, instead of the whole row.
+  // This reduces write amplification for tables with many columns
+  experimentalPartialUpdates?: boolean
+  // (JSI only) If `true`, observed queries are kept track of in native code, which tells JS how their
+  // results changed after a write instead of JS re-running them (or checking each changed record)
+  experimentalNativeQueryObservation?: boolean
+  // (JSI only) If `true`, queries are encoded into SQL in native code. Values are then passed as
+  // arguments instead of being inlined into SQL, so that queries that only differ by values reuse the
+  // same prepared statement. Queries and counts are encoded and run in a single native call (unless
+  // `experimentalAsyncQueries` is enabled)
+  experimentalNativeQueryEncoding?: boolean
 }>
 
 export type DispatcherType = 'asynchronous' | 'jsi'
@@ -37,16 +68,29 @@ export type SqliteDispatcherMethod =
   | 'setUpWithSchema'
   | 'setUpWithMigrations'
   | 'find'
+  | 'findMany'
   | 'query'
   | 'queryIds'
   | 'unsafeQueryRaw'
   | 'count'
   | 'batch'
   | 'unsafeLoadFromSync'
+  | 'unsafeLoadFromSyncFile'
+  | 'unsafeLoadIncrementalFromSync'
+  | 'fetchLocalChangesJSON'
+  | 'markAsSynced'
   | 'provideSyncJson'
   | 'unsafeResetDatabase'
   | 'getLocal'
   | 'unsafeExecuteMultiple'
+  | 'observeQuery'
+  | 'fetchQueryObserverChanges'
+  | 'unobserveQuery'
+  | 'encodeQuery'
+  | 'queryEncoded'
+  | 'countEncoded'
+  | 'queryCursor'
+  | 'multiQuery'
 
 export interface SqliteDispatcher {
   call(methodName: SqliteDispatcherMethod, args: any[], callback: ResultCallback<any>): void
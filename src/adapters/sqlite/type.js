@@ -2,7 +2,7 @@
 
 import { type ResultCallback } from '../../utils/fp/Result'
 
-import type { AppSchema, TableName, SchemaVersion } from '../../Schema'
+import type { AppSchema, TableName, ColumnName, SchemaVersion } from '../../Schema'
 import type { SchemaMigrations } from '../../Schema/migrations'
 
 export type SQL = string
@@ -35,6 +35,38 @@ export type SQLiteAdapterOptions = $Exact<{
   //   import com.nozbe.watermelondb.*
   //   Database.getInstance(dbName, context) // use the same dbName as in JS
   experimentalUnsafeNativeReuse?: boolean,
+  // (JSI only) If `true`, query results are passed from native code as a single binary buffer instead of
+  // JS objects. Can be faster for large results of numeric-heavy tables.
+  // NOTE: Ignored if the JS engine doesn't support TextDecoder
+  experimentalColumnarQueries?: boolean,
+  // (JSI only, not on Windows) If `true`, queries are executed on a separate read-only connection on a
+  // native background thread, so that slow queries don't block the JS thread.
+  // NOTE: Results may reflect changes that were made after the query was issued, and in-memory
+  // databases, or databases with `usesExclusiveLocking` will still be queried synchronously
+  experimentalAsyncQueries?: boolean,
+  // (JSI only) Number of read-only connections (and background threads) used for
+  // `experimentalAsyncQueries`. More connections allow more queries to run in parallel, at the cost of
+  // memory (each connection has its own page and statement cache). Defaults to 2
+  experimentalAsyncReaderConnections?: number,
+  // (JSI only, not on Windows) If `true`, batches are passed to native code as a compact binary buffer
+  // instead of a JSON string. Can be faster for large batches (e.g. big sync writes)
+  experimentalBinaryBatches?: boolean,
+  // (JSI only, not on Windows) If `true`, batches are written on a separate connection on a native
+  // background thread, so that the JS thread doesn't wait for commits. Batches made in quick succession
+  // are committed together in a single transaction (but a failing batch doesn't affect others).
+  // NOTE: In-memory databases, or databases with `usesExclusiveLocking` will still be written to synchronously
+  experimentalAsyncBatches?: boolean,
+  // (JSI only) If `true`, updated records only write columns that changed, instead of the whole row.
+  // This reduces write amplification for tables with many columns
+  experimentalPartialUpdates?: boolean,
+  // (JSI only) If `true`, observed queries are kept track of in native code, which tells JS how their
+  // results changed after a write instead of JS re-running them (or checking each changed record)
+  experimentalNativeQueryObservation?: boolean,
+  // (JSI only) If `true`, queries are encoded into SQL in native code. Values are then passed as
+  // arguments instead of being inlined into SQL, so that queries that only differ by values reuse the
+  // same prepared statement. Queries and counts are encoded and run in a single native call (unless
+  // `experimentalAsyncQueries` is enabled)
+  experimentalNativeQueryEncoding?: boolean,
 }>
 
 export type DispatcherType = 'asynchronous' | 'jsi'
@@ -44,14 +76,16 @@ export type DispatcherType = 'asynchronous' | 'jsi'
 // adding a record:  [1, 'table', 'insert into...', [['id', 'created', ...]]]
 // updating a record [0, null, 'update...', [['id', 'created', ...]]]
 // removing a record [-1, table, 'delete...', [['id', 'created', ...]]]
+// updating only some columns of a record (JSI only - SQL is generated natively):
+//                   [0, table, ['col1', 'col2'], [['id', 'val1', 'val2']]]
 type NativeBridgeBatchOperationCacheBehavior =
   | -1 // remove from cache
   | 0 // ignore
   | 1 // add to cache
 export type NativeBridgeBatchOperation = [
   NativeBridgeBatchOperationCacheBehavior,
-  ?TableName<any>, // table to add/remove from cache
-  SQL,
+  ?TableName<any>, // table to add/remove from cache (or to update partially)
+  SQL | ColumnName[],
   Array<SQLiteArg[]>, // id must be at [0] if cacheBehavior != 0
 ]
 
@@ -66,6 +100,11 @@ export type SyncReturn<T> =
 export type SqliteDispatcherOptions = $Exact<{
   usesExclusiveLocking: boolean,
   experimentalUnsafeNativeReuse: boolean,
+  experimentalColumnarQueries: boolean,
+  experimentalAsyncQueries: boolean,
+  experimentalAsyncReaderConnections: number,
+  experimentalBinaryBatches: boolean,
+  experimentalAsyncBatches: boolean,
 }>
 
 export type SqliteDispatcherMethod =
@@ -73,16 +112,29 @@ export type SqliteDispatcherMethod =
   | 'setUpWithSchema'
   | 'setUpWithMigrations'
   | 'find'
+  | 'findMany'
   | 'query'
   | 'queryIds'
   | 'unsafeQueryRaw'
   | 'count'
   | 'batch'
   | 'unsafeLoadFromSync'
+  | 'unsafeLoadFromSyncFile'
+  | 'unsafeLoadIncrementalFromSync'
+  | 'fetchLocalChangesJSON'
+  | 'markAsSynced'
   | 'provideSyncJson'
   | 'unsafeResetDatabase'
   | 'getLocal'
   | 'unsafeExecuteMultiple'
+  | 'observeQuery'
+  | 'fetchQueryObserverChanges'
+  | 'unobserveQuery'
+  | 'encodeQuery'
+  | 'queryEncoded'
+  | 'countEncoded'
+  | 'queryCursor'
+  | 'multiQuery'
 
 export interface SqliteDispatcher {
   call(methodName: SqliteDispatcherMethod, args: any[], callback: ResultCallback<any>): void;
@@ -1,9 +1,9 @@
 import type { SerializedQuery } from '../Query'
-import type { TableName, AppSchema } from '../Schema'
+import type { TableName, ColumnName, AppSchema } from '../Schema'
 import type { SchemaMigrations } from '../Schema/migrations'
 import type { RecordId } from '../Model'
 import type { RawRecord } from '../RawRecord'
-import type { ResultCallback } from '../utils/fp/Result'
+import type { Result, ResultCallback } from '../utils/fp/Result'
 
 import type { SQLiteQuery, SQL } from './sqlite/type'
 import type { Loki } from './lokijs/type'
@@ -15,6 +15,7 @@ export type BatchOperationType = 'create' | 'update' | 'markAsDeleted' | 'destro
 export type BatchOperation =
   | ['create', TableName<any>, RawRecord]
   | ['update', TableName<any>, RawRecord]
+  | ['update', TableName<any>, RawRecord, ColumnName[] | null | undefined] // with columns changed since last write
   | ['markAsDeleted', TableName<any>, RecordId]
   | ['destroyPermanently', TableName<any>, RecordId]
 
@@ -23,6 +24,50 @@ export type UnsafeExecuteOperations =
   | $Exact<{ sqlString: SQL }> // JSI-only
   | $Exact<{ loki: (_: Loki) => void }>
 
+// IDs of records changed by unsafeExecute (including by raw SQL), by table
+export type UnsafeExecuteChanges = {
+  [table: string]: $Exact<{ created: RecordId[]; updated: RecordId[]; destroyed: RecordId[] }>
+}
+
+// [table, [[id, hash of pushed record contents], ...], [id of pushed deleted record, ...]]
+export type MarkAsSyncedOperation = [TableName<any>, Array<[RecordId, number]>, RecordId[]]
+export type MarkAsSyncedResult = {
+  [table: string]: $Exact<{ synced: RecordId[]; destroyed: RecordId[] }>
+}
+
+// Changes to results of a natively observed query since they were last fetched (see observeQuery):
+// records added to and removed from results (unordered queries), or all results (other queries)
+export type QueryObserverChanges =
+  | $Exact<{ added: CachedQueryResult; removed: RecordId[] }>
+  | $Exact<{ records: CachedQueryResult }>
+
+// Cursor over results of a query (see queryCursor). Records are fetched only when requested, so
+// that huge results can be processed without loading all of them at once
+export interface QueryCursor {
+  // Fetches up to `count` next records (records like in query). Empty once all were fetched
+  next(count: number, callback: ResultCallback<CachedQueryResult>): void
+
+  // Stops fetching results early
+  close(callback: ResultCallback<void>): void
+}
+
+// Read operation of multiQuery. Results are like results of the adapter method of the same name
+export type MultiQueryOperation =
+  | ['find', TableName<any>, RecordId]
+  | ['query' | 'queryIds' | 'unsafeQueryRaw' | 'count', SerializedQuery]
+  | ['getLocal', string]
+
+// Progress of loading a turbo sync: bytes of sync JSON parsed (out of total), and number of records
+// inserted so far, by table
+export type TurboSyncProgress = $Exact<{
+  bytesParsed: number
+  bytesTotal: number
+  rowsInserted: { [table: string]: number }
+}>
+
+// Called (throttled) while loading a turbo sync. Returning `false` cancels the load
+export type TurboSyncProgressCallback = (progress: TurboSyncProgress) => boolean | void
+
 export interface DatabaseAdapter {
   schema: AppSchema
 
@@ -33,15 +78,46 @@ export interface DatabaseAdapter {
   // Fetches given (one) record or null. Should not send raw object if already cached in JS
   find(table: TableName<any>, id: RecordId, callback: ResultCallback<CachedFindResult>): void
 
+  // Fetches given records. Calls back with results in the same order as ids (like in find, i.e.
+  // null if record doesn't exist)
+  findMany(
+    table: TableName<any>,
+    ids: RecordId[],
+    callback: ResultCallback<CachedFindResult[]>,
+  ): void
+
   // Fetches matching records. Should not send raw object if already cached in JS
   query(query: SerializedQuery, callback: ResultCallback<CachedQueryResult>): void
 
+  // Starts observing a query natively, and calls back with [observerId, matching records] (records
+  // like in query), or null if not supported by this adapter
+  observeQuery(
+    query: SerializedQuery,
+    callback: ResultCallback<[number, CachedQueryResult] | null>,
+  ): void
+
+  // Fetches changes to results of an observed query since last fetched (or null if unchanged)
+  fetchQueryObserverChanges(
+    observerId: number,
+    callback: ResultCallback<QueryObserverChanges | null>,
+  ): void
+
+  // Stops observing a query
+  unobserveQuery(observerId: number, callback: ResultCallback<void>): void
+
   // Fetches IDs of matching records
   queryIds(query: SerializedQuery, callback: ResultCallback<RecordId[]>): void
 
   // Fetches unsafe, unsanitized objects according to query. You must not mutate these objects.
   unsafeQueryRaw(query: SerializedQuery, callback: ResultCallback<any[]>): void
 
+  // Starts executing a query, and calls back with a cursor for fetching its results in pages
+  queryCursor(query: SerializedQuery, callback: ResultCallback<QueryCursor>): void
+
+  // Executes multiple read operations at once, seeing the same snapshot of the database. Calls back
+  // with results (or errors) of each operation, in order
+  multiQuery(operations: MultiQueryOperation[], callback: ResultCallback<Result<any>[]>): void
+
   // Counts matching records
   count(query: SerializedQuery, callback: ResultCallback<number>): void
 
@@ -59,7 +135,40 @@ export interface DatabaseAdapter {
   ): void
 
   // Unsafely adds records from a serialized (json) SyncPullResult provided earlier via native API
-  unsafeLoadFromSync(jsonId: number, callback: ResultCallback<any>): void
+  unsafeLoadFromSync(
+    jsonId: number,
+    onProgress: TurboSyncProgressCallback | null | undefined,
+    callback: ResultCallback<any>,
+  ): void
+
+  // Unsafely adds records from a serialized (json) SyncPullResult saved to a file at `path`. Unlike
+  // unsafeLoadFromSync, the file is processed in chunks, and never loaded into memory as a whole
+  unsafeLoadFromSyncFile(
+    path: string,
+    onProgress: TurboSyncProgressCallback | null | undefined,
+    callback: ResultCallback<any>,
+  ): void
+
+  // Unsafely applies a serialized (json) SyncPullResult provided earlier via native API on top of
+  // existing records (like applyRemoteChanges with default conflict resolution). Returns
+  // `{ residualValues, changes }`, where `changes` are ids of affected records and fresh raws of
+  // affected records that were cached, by table
+  unsafeLoadIncrementalFromSync(jsonId: number, callback: ResultCallback<any>): void
+
+  // Fetches local changes (records that aren't synced) of given tables natively, and returns them
+  // serialized as JSON of `{ changes: SyncDatabaseChangeSet, hashes }`, where `hashes` are hashes
+  // of contents of created/updated records, by table and id. Returns null if not supported by this adapter
+  fetchLocalChangesJSON(
+    tables: TableName<any>[],
+    callback: ResultCallback<string | null>,
+  ): void
+
+  // Marks pushed records (fetched with fetchLocalChangesJSON) as synced, unless their contents changed
+  // since (hash doesn't match), and destroys pushed deleted records. Returns ids of affected records
+  markAsSynced(
+    operations: MarkAsSyncedOperation[],
+    callback: ResultCallback<MarkAsSyncedResult>,
+  ): void
 
   // Provides JSON for use by unsafeLoadFromSync
   provideSyncJson(id: number, syncPullResultJson: string, callback: ResultCallback<void>): void
@@ -68,7 +177,11 @@ export interface DatabaseAdapter {
   unsafeResetDatabase(callback: ResultCallback<void>): void
 
   // Performs work on the underlying database - see concrete DatabaseAdapter implementation for more details
-  unsafeExecute(work: UnsafeExecuteOperations, callback: ResultCallback<void>): void
+  // Calls back with IDs of changed records if the adapter can tell (null otherwise)
+  unsafeExecute(
+    work: UnsafeExecuteOperations,
+    callback: ResultCallback<UnsafeExecuteChanges | null>,
+  ): void
 
   // Fetches string value from local storage
   getLocal(key: string, callback: ResultCallback<string | undefined>): void
@@ -13,8 +13,16 @@ if (typeof global.self === 'undefined') {
 // NOTE: Set to `true` to run src/__playground__/index.js
 // WARN: DO NOT commit this change!
 const openPlayground = false
+// NOTE: Set to `true` to run benchmarks in src/adapters/sqlite/benchmark.js instead of tests
+// WARN: DO NOT commit this change!
+const runBenchmarks = false
 
-if (openPlayground) {
+if (runBenchmarks) {
+  // eslint-disable-next-line react/function-component-definition
+  const BenchmarkPlaceholder = () => <Text style={{ paddingTop: 100 }}>Running benchmarks</Text>
+  AppRegistry.registerComponent('watermelonTest', () => BenchmarkPlaceholder)
+  require('./adapters/sqlite/benchmark').default()
+} else if (openPlayground) {
   // eslint-disable-next-line react/function-component-definition
   const PlaygroundPlaceholder = () => <Text style={{ paddingTop: 100 }}>Playground is running</Text>
   AppRegistry.registerComponent('watermelonTest', () => PlaygroundPlaceholder)
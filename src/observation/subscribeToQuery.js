@@ -7,9 +7,10 @@ import type Model from '../Model'
 
 import subscribeToQueryReloading from './subscribeToQueryReloading'
 import subscribeToSimpleQuery from './subscribeToSimpleQuery'
+import subscribeToQueryNatively from './subscribeToQueryNatively'
 import canEncodeMatcher from './encodeMatcher/canEncode'
 
-export default function subscribeToQuery<Record: Model>(
+function subscribeToQueryInJS<Record: Model>(
   query: Query<Record>,
   subscriber: (Record[]) => void,
 ): Unsubscribe {
@@ -17,3 +18,10 @@ export default function subscribeToQuery<Record: Model>(
     ? subscribeToSimpleQuery(query, subscriber)
     : subscribeToQueryReloading(query, subscriber)
 }
+
+export default function subscribeToQuery<Record: Model>(
+  query: Query<Record>,
+  subscriber: (Record[]) => void,
+): Unsubscribe {
+  return subscribeToQueryNatively(query, subscriber, subscribeToQueryInJS)
+}
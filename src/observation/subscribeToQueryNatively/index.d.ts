@@ -0,0 +1,16 @@
+/* eslint-disable import/no-named-as-default-member */
+/* eslint-disable import/no-named-as-default */
+import type { Unsubscribe } from '../../utils/subscriptions'
+
+import type Query from '../../Query'
+import type Model from '../../Model'
+
+// Produces an observable version of a query by having the adapter keep track of which records
+// match the query (natively), and asking it how results changed when any relevant table changes.
+// This way, the query doesn't have to be re-run (nor changed records checked) in JS.
+// If the adapter can't observe queries (see `experimentalNativeQueryObservation`), uses `fallback`
+export default function subscribeToQueryNatively<Record extends Model>(
+  query: Query<Record>,
+  subscriber: (records: Record[]) => void,
+  fallback: (query: Query<Record>, subscriber: (records: Record[]) => void) => Unsubscribe,
+): Unsubscribe
@@ -0,0 +1,97 @@
+// @flow
+
+import { logError } from '../../utils/common'
+import { type Unsubscribe } from '../../utils/subscriptions'
+
+import type Query from '../../Query'
+import type Model from '../../Model'
+
+// Produces an observable version of a query by having the adapter keep track of which records
+// match the query (natively), and asking it how results changed when any relevant table changes.
+// This way, the query doesn't have to be re-run (nor changed records checked) in JS.
+// If the adapter can't observe queries (see `experimentalNativeQueryObservation`), uses `fallback`
+
+export default function subscribeToQueryNatively<Record: Model>(
+  query: Query<Record>,
+  subscriber: (Record[]) => void,
+  fallback: (Query<Record>, (Record[]) => void) => Unsubscribe,
+): Unsubscribe {
+  const { collection } = query
+  const adapter = collection.database.adapter.underlyingAdapter
+  let unsubscribed = false
+  let unsubscribe: ?Unsubscribe = null
+
+  const unobserve = (observerId: number): void =>
+    adapter.unobserveQuery(observerId, (result) => {
+      result.error && logError(result.error.toString())
+    })
+
+  adapter.observeQuery(query.serialize(), (result) => {
+    if (result.error) {
+      logError(result.error.toString())
+      return
+    }
+
+    if (!result.value) {
+      if (!unsubscribed) {
+        unsubscribe = fallback(query, subscriber)
+      }
+      return
+    }
+
+    const [observerId, initialResult] = result.value
+    if (unsubscribed) {
+      unobserve(observerId)
+      return
+    }
+
+    let matchingRecords: Record[] = collection._cache.recordsFromQueryResult(initialResult)
+    const emitCopy = () => !unsubscribed && subscriber(matchingRecords.slice(0))
+    emitCopy()
+
+    // Check if emitCopy haven't completed source observable to avoid memory leaks
+    if (unsubscribed) {
+      unobserve(observerId)
+      return
+    }
+
+    function fetchObserverChanges(): void {
+      adapter.fetchQueryObserverChanges(observerId, (changesResult) => {
+        if (changesResult.error) {
+          logError(changesResult.error.toString())
+          return
+        }
+
+        const changes = changesResult.value
+        if (unsubscribed || !changes) {
+          return
+        }
+
+        if (changes.records) {
+          matchingRecords = collection._cache.recordsFromQueryResult(changes.records)
+        } else if (changes.added && changes.removed) {
+          const removedIds = new Set(changes.removed)
+          matchingRecords = matchingRecords
+            .filter((record) => !removedIds.has(record.id))
+            .concat(collection._cache.recordsFromQueryResult(changes.added))
+        }
+        emitCopy()
+      })
+    }
+
+    const unsubscribeFromTables = collection.database.experimentalSubscribe(
+      query.allTables,
+      fetchObserverChanges,
+      { name: 'subscribeToQueryNatively observation', query, subscriber },
+    )
+    unsubscribe = () => {
+      unsubscribeFromTables()
+      unobserve(observerId)
+    }
+  })
+
+  return () => {
+    unsubscribed = true
+    unsubscribe && unsubscribe()
+  }
+}
@@ -0,0 +1,98 @@
+import { mockDatabase } from '../../__tests__/testModels'
+
+import Query from '../../Query'
+import * as Q from '../../QueryDescription'
+
+import subscribeToQueryNatively from './index'
+import subscribeToSimpleQuery from '../subscribeToSimpleQuery'
+
+const makeMock = (db, name) =>
+  db.write(() =>
+    db.get('mock_tasks').create((mock) => {
+      mock.name = name
+    }),
+  )
+
+describe('subscribeToQueryNatively', () => {
+  it('falls back if adapter cannot observe queries', async () => {
+    const { db } = mockDatabase()
+    const m1 = await makeMock(db, 'foo')
+
+    const query = new Query(db.collections.get('mock_tasks'), [Q.where('name', 'foo')])
+    const observer = jest.fn()
+    const fallback = jest.fn(subscribeToSimpleQuery)
+    const unsubscribe = subscribeToQueryNatively(query, observer, fallback)
+
+    await new Promise(process.nextTick) // give time to propagate
+    expect(fallback).toHaveBeenCalledTimes(1)
+    expect(fallback).toHaveBeenCalledWith(query, observer)
+    expect(observer).toHaveBeenLastCalledWith([m1])
+
+    const m2 = await makeMock(db, 'foo')
+    expect(observer).toHaveBeenLastCalledWith([m1, m2])
+
+    unsubscribe()
+  })
+  it('applies changes fetched from adapter', async () => {
+    const { db, adapter: adapterMock } = mockDatabase()
+    const m1 = await makeMock(db, 'foo')
+    const m2 = await makeMock(db, 'foo')
+    const m3 = await makeMock(db, 'bar')
+
+    adapterMock.observeQuery = jest.fn((query, callback) =>
+      callback({ value: [5, [m1.id, m2.id]] }),
+    )
+    adapterMock.unobserveQuery = jest.fn((observerId, callback) => callback({ value: undefined }))
+    const changes = [
+      null,
+      { added: [m3.id], removed: [m1.id] },
+      { records: [m3.id, m2.id] },
+      { added: [], removed: [m2.id, m3.id] },
+    ]
+    adapterMock.fetchQueryObserverChanges = jest.fn((observerId, callback) =>
+      callback({ value: changes.shift() }),
+    )
+
+    const query = new Query(db.collections.get('mock_tasks'), [Q.where('name', 'foo')])
+    const observer = jest.fn()
+    const fallback = jest.fn()
+    const unsubscribe = subscribeToQueryNatively(query, observer, fallback)
+
+    expect(fallback).toHaveBeenCalledTimes(0)
+    expect(adapterMock.observeQuery).toHaveBeenCalledWith(query.serialize(), expect.any(Function))
+    expect(observer).toHaveBeenCalledTimes(1)
+    expect(observer).toHaveBeenLastCalledWith([m1, m2])
+
+    const change = () =>
+      db.write(() =>
+        m3.update((mock) => {
+          mock.name = 'changed'
+        }),
+      )
+
+    // no changes (no emission)
+    await change()
+    expect(adapterMock.fetchQueryObserverChanges).toHaveBeenLastCalledWith(5, expect.any(Function))
+    expect(observer).toHaveBeenCalledTimes(1)
+
+    // added/removed records
+    await change()
+    expect(observer).toHaveBeenCalledTimes(2)
+    expect(observer).toHaveBeenLastCalledWith([m2, m3])
+
+    // new results
+    await change()
+    expect(observer).toHaveBeenCalledTimes(3)
+    expect(observer).toHaveBeenLastCalledWith([m3, m2])
+
+    await change()
+    expect(observer).toHaveBeenCalledTimes(4)
+    expect(observer).toHaveBeenLastCalledWith([])
+
+    // unsubscribe
+    unsubscribe()
+    expect(adapterMock.unobserveQuery).toHaveBeenCalledWith(5, expect.any(Function))
+    await change()
+    expect(adapterMock.fetchQueryObserverChanges).toHaveBeenCalledTimes(4)
+  })
+})
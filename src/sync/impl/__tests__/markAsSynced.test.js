@@ -55,6 +55,29 @@ describe('markLocalChangesAsSynced', () => {
     // no objects marked as deleted
     expect(await allDeletedRecords([projects, tasks, comments])).toEqual([])
   })
+  it('marks local changes fetched natively (without records) as synced', async () => {
+    const { database, projects, tasks } = makeDatabase()
+
+    const { tCreated } = await makeLocalChanges(database)
+    const { changes } = await fetchLocalChanges(database)
+
+    // simulate user making changes while sync push request is in progress
+    await database.write(async () => {
+      await tCreated.update(() => {
+        tCreated.name = 'local2'
+      })
+    })
+
+    await markLocalChangesAsSynced(database, { changes, affectedRecords: null })
+
+    const localChanges2 = await fetchLocalChanges(database)
+    expect(localChanges2.changes).toEqual(
+      makeChangeSet({ mock_tasks: { created: [tCreated._raw] } }),
+    )
+    const projectList = await projects.query().fetch()
+    expect(projectList.every((record) => record.syncStatus === 'synced')).toBe(true)
+    expect((await tasks.find('tUpdated')).syncStatus).toBe('synced')
+  })
   it(`doesn't modify updated_at timestamps`, async () => {
     const { database, comments } = makeDatabase()
 
@@ -25,8 +25,21 @@ describe('synchronize - turbo', () => {
 
     await synchronize({ database, pullChanges: emptyPull() })
     await expectToRejectWithMessage(
-      synchronize({ database, pullChanges: () => ({ syncJson: '{} ' }), unsafeTurbo: true }),
-      'unsafeTurbo can only be used as the first sync',
+      synchronize({
+        database,
+        pullChanges: () => ({ syncJsonFilePath: '/tmp/sync.json' }),
+        unsafeTurbo: true,
+      }),
+      'unsafeTurbo with syncJsonFilePath can only be used as the first sync',
+    )
+    await expectToRejectWithMessage(
+      synchronize({
+        database,
+        pullChanges: () => ({ syncJson: '{}' }),
+        unsafeTurbo: true,
+        conflictResolver: (table, local, remote, resolved) => resolved,
+      }),
+      'unsafeTurbo must not be used with conflictResolver in incremental syncs',
     )
   })
   it(`can pull with turbo login`, async () => {
@@ -37,7 +50,9 @@ describe('synchronize - turbo', () => {
       .mockImplementationOnce((id, json, callback) => callback({ value: true }))
     adapter.unsafeLoadFromSync = jest
       .fn()
-      .mockImplementationOnce((id, callback) => callback({ value: { timestamp: 1011 } }))
+      .mockImplementationOnce((id, onProgress, callback) =>
+        callback({ value: { timestamp: 1011 } }),
+      )
 
     const json = '{ hello! }'
     const log = {}
@@ -60,7 +75,9 @@ describe('synchronize - turbo', () => {
     adapter.provideSyncJson = jest.fn()
     adapter.unsafeLoadFromSync = jest
       .fn()
-      .mockImplementationOnce((id, callback) => callback({ value: { timestamp: 1012 } }))
+      .mockImplementationOnce((id, onProgress, callback) =>
+        callback({ value: { timestamp: 1012 } }),
+      )
 
     const log = {}
     await synchronize({
@@ -78,6 +95,122 @@ describe('synchronize - turbo', () => {
     expect(adapter.unsafeLoadFromSync.mock.calls.length).toBe(1)
     expect(adapter.unsafeLoadFromSync.mock.calls[0][0]).toBe(2137)
   })
+  it(`can pull with turbo login (using a file)`, async () => {
+    const { database, adapter } = makeDatabase()
+    // FIXME: Test on real native db instead of mocking
+    adapter.provideSyncJson = jest.fn()
+    adapter.unsafeLoadFromSync = jest.fn()
+    adapter.unsafeLoadFromSyncFile = jest
+      .fn()
+      .mockImplementationOnce((path, onProgress, callback) =>
+        callback({ value: { timestamp: 1013 } }),
+      )
+
+    const log = {}
+    await synchronize({
+      database,
+      pullChanges: () => ({ syncJsonFilePath: '/tmp/sync.json' }),
+      unsafeTurbo: true,
+      log,
+    })
+
+    expect(await getLastPulledAt(database)).toBe(1013)
+    expect(log.newLastPulledAt).toBe(1013)
+
+    expect(adapter.provideSyncJson.mock.calls.length).toBe(0)
+    expect(adapter.unsafeLoadFromSync.mock.calls.length).toBe(0)
+    expect(adapter.unsafeLoadFromSyncFile.mock.calls.length).toBe(1)
+    expect(adapter.unsafeLoadFromSyncFile.mock.calls[0][0]).toBe('/tmp/sync.json')
+  })
+  it(`passes turbo progress callback to native loader`, async () => {
+    const { database, adapter } = makeDatabase()
+    // FIXME: Test on real native db instead of mocking
+    adapter.provideSyncJson = jest.fn()
+    adapter.unsafeLoadFromSync = jest
+      .fn()
+      .mockImplementationOnce((id, onProgress, callback) => {
+        onProgress({ bytesParsed: 10, bytesTotal: 20, rowsInserted: { mock_tasks: 1 } })
+        callback({ value: { timestamp: 1014 } })
+      })
+
+    const onTurboProgress = jest.fn()
+    await synchronize({
+      database,
+      pullChanges: () => ({ syncJsonId: 2137 }),
+      unsafeTurbo: true,
+      onTurboProgress,
+    })
+
+    expect(await getLastPulledAt(database)).toBe(1014)
+    expect(adapter.unsafeLoadFromSync.mock.calls[0][1]).toBe(onTurboProgress)
+    expect(onTurboProgress).toHaveBeenCalledWith({
+      bytesParsed: 10,
+      bytesTotal: 20,
+      rowsInserted: { mock_tasks: 1 },
+    })
+  })
+  it(`can pull incremental changes with turbo`, async () => {
+    const { database, adapter, tasks } = makeDatabase()
+    await synchronize({ database, pullChanges: emptyPull(1000) })
+
+    await database.write(() =>
+      database.batch(
+        tasks.prepareCreateFromDirtyRaw({ id: 't1', name: 'before' }),
+        tasks.prepareCreateFromDirtyRaw({ id: 't2' }),
+      ),
+    )
+    const t1 = await tasks.find('t1')
+    const t2 = await tasks.find('t2')
+
+    // FIXME: Test on real native db instead of mocking
+    adapter.provideSyncJson = jest
+      .fn()
+      .mockImplementationOnce((id, json, callback) => callback({ value: true }))
+    adapter.unsafeLoadFromSync = jest.fn()
+    adapter.unsafeLoadIncrementalFromSync = jest.fn().mockImplementationOnce((id, callback) =>
+      callback({
+        value: {
+          residualValues: { timestamp: 1500, hello: 'hi' },
+          changes: {
+            mock_tasks: {
+              updated: ['t1', 't3'],
+              destroyed: ['t2'],
+              cachedRecords: [{ ...t1._raw, name: 'after' }],
+            },
+          },
+        },
+      }),
+    )
+
+    const changeSets = []
+    tasks.changes.subscribe((changeSet) => changeSets.push(changeSet))
+    const onDidPullChanges = jest.fn()
+    const json = '{ hello! }'
+    await synchronize({
+      database,
+      pullChanges: () => ({ syncJson: json }),
+      unsafeTurbo: true,
+      onDidPullChanges,
+    })
+
+    expect(await getLastPulledAt(database)).toBe(1500)
+    expect(onDidPullChanges).toHaveBeenCalledWith({ timestamp: 1500, hello: 'hi' })
+    expect(adapter.unsafeLoadFromSync).toHaveBeenCalledTimes(0)
+    expect(adapter.provideSyncJson.mock.calls[0][1]).toBe(json)
+    expect(adapter.unsafeLoadIncrementalFromSync.mock.calls[0][0]).toBe(
+      adapter.provideSyncJson.mock.calls[0][0],
+    )
+
+    // cached records are updated in place, destroyed ones are removed from cache
+    expect(t1.name).toBe('after')
+    expect(tasks._cache.get('t2')).toBe(undefined)
+    expect(changeSets).toEqual([
+      [
+        { record: t1, type: 'updated' },
+        { record: t2, type: 'destroyed' },
+      ],
+    ])
+  })
   describe('onDidPullChanges', () => {
     it(`calls onDidPullChanges`, async () => {
       const { database } = makeDatabase()
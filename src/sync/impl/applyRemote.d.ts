@@ -1,4 +1,5 @@
-import type { Database } from '../..'
+import { $Exact } from '../../types'
+import type { Database, RecordId, TableName, RawRecord } from '../..'
 
 import type { SyncDatabaseChangeSet, SyncLog, SyncConflictResolver } from '../index'
 
@@ -12,3 +13,16 @@ export default function applyRemoteChanges(
     _unsafeBatchPerCollection?: boolean
   },
 ): Promise<void>
+
+export type IncrementalTurboChanges = {
+  [tableName: TableName<any>]: $Exact<{
+    updated: RecordId[]
+    destroyed: RecordId[]
+    cachedRecords: RawRecord[]
+  }>
+}
+
+export function applyIncrementalTurboChangesToCache(
+  db: Database,
+  turboChanges: IncrementalTurboChanges,
+): Promise<void>
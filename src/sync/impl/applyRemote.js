@@ -400,3 +400,64 @@ export default async function applyRemoteChanges(
       : applyAllRemoteChanges(recordsToApply, context),
   ])
 }
+
+export type IncrementalTurboChanges = {
+  [TableName<any>]: $Exact<{
+    updated: RecordId[],
+    destroyed: RecordId[],
+    cachedRecords: RawRecord[],
+  }>,
+}
+
+// Changes applied natively in turbo mode bypass JS, so we need to bring Collection caches up to date
+// and notify observers ourselves
+export async function applyIncrementalTurboChangesToCache(
+  db: Database,
+  turboChanges: IncrementalTurboChanges,
+): Promise<void> {
+  const changes = []
+  await Promise.all(
+    toPairs(turboChanges).map(async ([tableName, { updated, destroyed, cachedRecords }]) => {
+      const collection = db.get((tableName: any))
+      if (!collection) {
+        return
+      }
+
+      const changeSet = []
+      const cachedRecordIds = new Set()
+      cachedRecords.forEach((raw) => {
+        const record = collection._cache.get(raw.id)
+        if (record) {
+          record._raw = raw
+          cachedRecordIds.add(raw.id)
+          changeSet.push({ record, type: 'updated' })
+        }
+      })
+
+      // Models for other records don't exist yet - only make them if someone observes the collection
+      // (e.g. a simple query observer needs them to check if new records match)
+      const uncachedIds = updated.filter((id) => !cachedRecordIds.has(id))
+      if (uncachedIds.length && (collection._subscribers.length || collection.changes.observed)) {
+        const records = await collection
+          .query(Q.where(columnName('id'), Q.oneOf(uncachedIds)))
+          .fetch()
+        records.forEach((record) => {
+          changeSet.push({ record, type: 'updated' })
+        })
+      }
+
+      destroyed.forEach((id) => {
+        const record = collection._cache.get(id)
+        if (record) {
+          collection._cache.delete(record)
+          changeSet.push({ record, type: 'destroyed' })
+        }
+      })
+
+      if (changeSet.length || updated.length || destroyed.length) {
+        changes.push([tableName, changeSet])
+      }
+    }),
+  )
+  db._notify((changes: any))
+}
@@ -51,6 +51,13 @@ async function fetchLocalChangesForCollection<T: Model>(
 
 export default function fetchLocalChanges(db: Database): Promise<SyncLocalChanges> {
   return db.read(async () => {
+    // Fast path - changes are fetched and serialized by native code, without creating Model objects
+    const changesJson = await db.adapter.fetchLocalChangesJSON(Object.keys(db.collections.map))
+    if (changesJson) {
+      const { changes, hashes } = JSON.parse(changesJson)
+      return { changes, affectedRecords: null, recordHashes: hashes }
+    }
+
     const changes = await allPromisesObj(mapObj(fetchLocalChangesForCollection, db.collections.map))
     // TODO: deep-freeze changes object (in dev mode only) to detect mutations (user bug)
     return {
@@ -5,7 +5,7 @@ import type { Timestamp, SyncLog } from '../index'
 import type { SchemaVersion } from '../../Schema'
 import type { MigrationSyncChanges } from '../../Schema/migrations/getSyncChanges'
 
-export { default as applyRemoteChanges } from './applyRemote'
+export { default as applyRemoteChanges, applyIncrementalTurboChangesToCache } from './applyRemote'
 export { default as fetchLocalChanges, hasUnsyncedChanges } from './fetchLocal'
 export { default as markLocalChangesAsSynced } from './markAsSynced'
 
@@ -2,13 +2,35 @@
 
 import areRecordsEqual from '../../utils/fp/areRecordsEqual'
 import { logError } from '../../utils/common'
+import { unnest, mapObj } from '../../utils/fp'
 import type { Database, Model, TableName } from '../..'
+import * as Q from '../../QueryDescription'
+import { columnName } from '../../Schema'
 
 import { prepareMarkAsSynced } from './helpers'
+import { applyIncrementalTurboChangesToCache } from './applyRemote'
 import type { SyncLocalChanges, SyncRejectedIds } from '../index'
 
+// Local changes fetched natively come without records, so pushed records are fetched now
+const fetchAffectedRecords = async (
+  db: Database,
+  { changes }: SyncLocalChanges,
+): Promise<Model[]> => {
+  const records = await Promise.all(
+    Object.keys(changes).map((table) => {
+      const { created, updated } = changes[(table: any)]
+      const ids = created.concat(updated).map((raw) => raw.id)
+      return ids.length
+        ? db.get(table).query(Q.where(columnName('id'), Q.oneOf(ids))).fetch()
+        : Promise.resolve([])
+    }),
+  )
+  return unnest(records)
+}
+
 const recordsToMarkAsSynced = (
-  { changes, affectedRecords }: SyncLocalChanges,
+  { changes }: SyncLocalChanges,
+  affectedRecords: Model[],
   allRejectedIds: SyncRejectedIds,
 ): Model[] => {
   const syncedRecords = []
@@ -47,16 +69,70 @@ const destroyDeletedRecords = (
     return deleted.length ? db.adapter.destroyDeletedRecords(tableName, deleted) : Promise.resolve()
   })
 
+// Changes fetched natively are marked as synced natively, too. Records whose contents changed since
+// they were fetched (hash doesn't match) are left alone, just like in markLocalChangesAsSynced
+async function markLocalChangesAsSyncedNatively(
+  db: Database,
+  { changes, recordHashes }: SyncLocalChanges,
+  allRejectedIds: SyncRejectedIds,
+): Promise<void> {
+  const operations = Object.keys(changes).map((table) => {
+    const { created, updated, deleted } = changes[(table: any)]
+    const hashes = (recordHashes && recordHashes[(table: any)]) || {}
+    const rejectedIds = new Set(allRejectedIds[(table: any)])
+
+    const records = []
+    const addRecord = ({ id }) => {
+      if (!rejectedIds.has(id) && hashes[id] !== undefined) {
+        records.push([id, hashes[id]])
+      }
+    }
+    created.forEach(addRecord)
+    updated.forEach(addRecord)
+
+    return [table, records, deleted.filter((id) => !rejectedIds.has(id))]
+  })
+
+  const result = await db.adapter.markAsSynced((operations: any))
+
+  // Bring Collection caches up to date and notify observers
+  await applyIncrementalTurboChangesToCache(
+    db,
+    mapObj(({ synced, destroyed }, table) => {
+      const collection = db.get(table)
+      const cachedRecords = []
+      synced.forEach((id) => {
+        const record = collection._cache.get(id)
+        if (record) {
+          // $FlowFixMe
+          cachedRecords.push(Object.assign({}, record._raw, { _status: 'synced', _changed: '' }))
+        }
+      })
+      return { updated: synced, destroyed, cachedRecords }
+    }, result),
+  )
+}
+
 export default function markLocalChangesAsSynced(
   db: Database,
   syncedLocalChanges: SyncLocalChanges,
   rejectedIds?: ?SyncRejectedIds,
 ): Promise<void> {
   return db.write(async () => {
+    if (syncedLocalChanges.recordHashes) {
+      await markLocalChangesAsSyncedNatively(db, syncedLocalChanges, rejectedIds || {})
+      return
+    }
+
+    const affectedRecords =
+      syncedLocalChanges.affectedRecords || (await fetchAffectedRecords(db, syncedLocalChanges))
+
     // update and destroy records concurrently
     await Promise.all([
       db.batch(
-        recordsToMarkAsSynced(syncedLocalChanges, rejectedIds || {}).map(prepareMarkAsSynced),
+        recordsToMarkAsSynced(syncedLocalChanges, affectedRecords, rejectedIds || {}).map(
+          prepareMarkAsSynced,
+        ),
       ),
       ...destroyDeletedRecords(db, syncedLocalChanges, rejectedIds || {}),
     ])
@@ -4,6 +4,7 @@ import { invariant } from '../../utils/common'
 
 import {
   applyRemoteChanges,
+  applyIncrementalTurboChangesToCache,
   fetchLocalChanges,
   markLocalChangesAsSynced,
   getLastPulledAt,
@@ -26,6 +27,7 @@ export default async function synchronize({
   conflictResolver,
   _unsafeBatchPerCollection,
   unsafeTurbo,
+  onTurboProgress,
 }: SyncArgs): Promise<void> {
   const resetCount = database._resetCount
   log && (log.startedAt = new Date())
@@ -73,18 +75,41 @@ export default async function synchronize({
         'unsafeTurbo must not be used with _unsafeBatchPerCollection',
       )
       invariant(
-        'syncJson' in pullResult || 'syncJsonId' in pullResult,
-        'missing syncJson/syncJsonId',
+        'syncJson' in pullResult || 'syncJsonId' in pullResult || 'syncJsonFilePath' in pullResult,
+        'missing syncJson/syncJsonId/syncJsonFilePath',
+      )
+      invariant(
+        lastPulledAt === null || !conflictResolver,
+        'unsafeTurbo must not be used with conflictResolver in incremental syncs',
       )
-      invariant(lastPulledAt === null, 'unsafeTurbo can only be used as the first sync')
-
-      const syncJsonId = pullResult.syncJsonId || Math.floor(Math.random() * 1000000000)
 
-      if (pullResult.syncJson) {
-        await database.adapter.provideSyncJson(syncJsonId, pullResult.syncJson)
+      let resultRest
+      if (pullResult.syncJsonFilePath) {
+        invariant(
+          lastPulledAt === null,
+          'unsafeTurbo with syncJsonFilePath can only be used as the first sync',
+        )
+        resultRest = await database.adapter.unsafeLoadFromSyncFile(
+          pullResult.syncJsonFilePath,
+          onTurboProgress,
+        )
+      } else {
+        const syncJsonId = pullResult.syncJsonId || Math.floor(Math.random() * 1000000000)
+
+        if (pullResult.syncJson) {
+          await database.adapter.provideSyncJson(syncJsonId, pullResult.syncJson)
+        }
+
+        if (lastPulledAt === null) {
+          resultRest = await database.adapter.unsafeLoadFromSync(syncJsonId, onTurboProgress)
+        } else {
+          // Incremental sync - changes are applied natively on top of existing records
+          const { residualValues, changes } =
+            await database.adapter.unsafeLoadIncrementalFromSync(syncJsonId)
+          await applyIncrementalTurboChangesToCache(database, changes)
+          resultRest = residualValues
+        }
       }
-
-      const resultRest = await database.adapter.unsafeLoadFromSync(syncJsonId)
       newLastPulledAt = resultRest.timestamp
       onDidPullChanges && onDidPullChanges(resultRest)
     }
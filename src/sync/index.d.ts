@@ -5,6 +5,7 @@ import type { DirtyRaw } from '../RawRecord'
 
 import type { SchemaVersion } from '../Schema'
 import type { MigrationSyncChanges } from '../Schema/migrations/getSyncChanges'
+import type { TurboSyncProgressCallback } from '../adapters/type'
 
 export type Timestamp = number
 
@@ -15,7 +16,13 @@ export type SyncTableChangeSet = $Exact<{
 }>
 export type SyncDatabaseChangeSet = { [tableName: TableName<any>]: SyncTableChangeSet }
 
-export type SyncLocalChanges = $Exact<{ changes: SyncDatabaseChangeSet; affectedRecords: Model[] }>
+// NOTE: If changes were fetched natively, affectedRecords is null, and recordHashes are hashes of
+// contents of created/updated records (by table and id), used to mark them as synced natively
+export type SyncLocalChanges = $Exact<{
+  changes: SyncDatabaseChangeSet
+  affectedRecords: Model[] | null
+  recordHashes?: { [table: string]: { [id: string]: number } }
+}>
 
 export type SyncPullArgs = $Exact<{
   lastPulledAt?: Timestamp
@@ -26,6 +33,7 @@ export type SyncPullResult =
   | $Exact<{ changes: SyncDatabaseChangeSet; timestamp: Timestamp }>
   | $Exact<{ syncJson: string }>
   | $Exact<{ syncJsonId: number }>
+  | $Exact<{ syncJsonFilePath: string }>
 
 export type SyncRejectedIds = { [tableName: TableName<any>]: RecordId[] }
 
@@ -72,12 +80,22 @@ export type SyncArgs = $Exact<{
   conflictResolver?: SyncConflictResolver
   // commits changes in multiple batches, and not one - temporary workaround for memory issue
   _unsafeBatchPerCollection?: boolean
-  // Advanced optimization - pullChanges must return syncJson or syncJsonId to be processed by native code.
-  // This can only be used on initial (login) sync, not for incremental syncs.
+  // Advanced optimization - pullChanges must return syncJson, syncJsonId, or syncJsonFilePath to be
+  // processed by native code.
+  // In incremental syncs, changes are applied with default conflict resolution (conflictResolver is not
+  // supported), and syncJsonFilePath can't be used.
   // This can only be used with SQLiteAdapter with JSI enabled.
   // The exact API may change between versions of WatermelonDB.
   // See documentation for more details.
   unsafeTurbo?: boolean
+  // Called periodically while records of the first (initial) turbo sync are being loaded, with progress
+  // of the load so far. Return `false` to cancel the load - no records are inserted then, and sync
+  // fails. Note that this is called synchronously by native code, in the middle of a database
+  // transaction, so it must be fast and must not use the database (doing so throws an error). The JS
+  // thread is blocked until the load is done, so JS UI (e.g. React state) won't update until then -
+  // report progress to native UI, or use it to log or cancel the load. Has no effect in incremental
+  // syncs.
+  onTurboProgress?: TurboSyncProgressCallback
   // Called after pullChanges with whatever was returned by pullChanges, minus `changes`. Useful
   // when using turbo mode
   onDidPullChanges?: (_: Object) => Promise<void>